@@ -0,0 +1,199 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BinaryLog.h"
+
+#include <cinttypes>
+
+namespace wind {
+namespace base {
+namespace detail {
+// writes to a buffer and truncates at its end, one byte is kept for the line end.
+class LineWriter {
+public:
+    LineWriter(char *buf, size_t size) : buf_(buf), end_(buf + size - 1), curr_(buf) {}
+
+    void append(const char *data, size_t len)
+    {
+        len = std::min(len, static_cast<size_t>(end_ - curr_));
+        ::memcpy(curr_, data, len);
+        curr_ += len;
+    }
+
+    void append(std::string_view s)
+    {
+        append(s.data(), s.size());
+    }
+
+    template <typename... Args>
+    void appendFormatted(const char *fmt, Args... args)
+    {
+        char tmp[64];
+        int len = ::snprintf(tmp, sizeof(tmp), fmt, args...);
+        append(tmp, static_cast<size_t>(std::max(len, 0)));
+    }
+
+    size_t finish()
+    {
+        *curr_++ = '\n';
+        return static_cast<size_t>(curr_ - buf_);
+    }
+
+private:
+    char *buf_;
+    char *end_;
+    char *curr_;
+};
+
+// reads the arguments of a record, returns false at the end or on a broken record.
+class ArgReader {
+public:
+    ArgReader(const char *data, size_t len) : curr_(data), end_(data + len) {}
+
+    bool next(LineWriter &writer)
+    {
+        if (curr_ >= end_) {
+            return false;
+        }
+
+        auto type = static_cast<BinaryLogArgType>(*curr_++);
+        switch (type) {
+            case BinaryLogArgType::INT: {
+                int64_t value = 0;
+                return read(value) && (writer.appendFormatted("%" PRId64, value), true);
+            }
+            case BinaryLogArgType::UINT: {
+                uint64_t value = 0;
+                return read(value) && (writer.appendFormatted("%" PRIu64, value), true);
+            }
+            case BinaryLogArgType::DOUBLE: {
+                double value = 0;
+                return read(value) && (writer.appendFormatted("%.12g", value), true);
+            }
+            case BinaryLogArgType::BOOL: {
+                uint8_t value = 0;
+                return read(value) && (writer.append(value != 0 ? "true" : "false"), true);
+            }
+            case BinaryLogArgType::CHAR: {
+                char value = 0;
+                return read(value) && (writer.append(&value, 1), true);
+            }
+            case BinaryLogArgType::POINTER: {
+                uintptr_t value = 0;
+                return read(value) && (writer.appendFormatted("0x%" PRIxPTR, value), true);
+            }
+            case BinaryLogArgType::STRING: {
+                uint32_t len = 0;
+                if (!read(len) || len > static_cast<size_t>(end_ - curr_)) {
+                    return false;
+                }
+                writer.append(curr_, len);
+                curr_ += len;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    template <typename T>
+    bool read(T &value)
+    {
+        if (static_cast<size_t>(end_ - curr_) < sizeof(T)) {
+            return false;
+        }
+        ::memcpy(&value, curr_, sizeof(T));
+        curr_ += sizeof(T);
+        return true;
+    }
+
+    const char *curr_;
+    const char *end_;
+};
+
+void formatAndOutput(const char *record, size_t len)
+{
+    char line[MAX_BINARY_LOG_LINE_SIZE];
+    size_t lineLen = BinaryLogRecord::format(record, len, line, sizeof(line));
+    LogStream stream;
+    stream.append(line, lineLen);
+}
+
+BinaryLogOutputFunc g_binaryLogOutputFunc = &formatAndOutput;
+} // namespace detail
+
+void BinaryLogRecord::setOutputFunc(BinaryLogOutputFunc func)
+{
+    detail::g_binaryLogOutputFunc = func != nullptr ? std::move(func) : &detail::formatAndOutput;
+}
+
+void BinaryLogRecord::output(const char *record, size_t len)
+{
+    detail::g_binaryLogOutputFunc(record, len);
+}
+
+size_t BinaryLogRecord::format(const char *record, size_t len, char *buf, size_t size)
+{
+    if (size < MAX_TIME_STRING_SIZE || len < sizeof(Header)) {
+        return 0;
+    }
+
+    Header header{};
+    ::memcpy(&header, record, sizeof(header));
+    const BinaryLogSite &site = *header.site;
+    detail::LineWriter writer(buf, size);
+
+    // the same prefix as Logger.
+    char timeBuf[MAX_TIME_STRING_SIZE];
+    writer.append(timeBuf, TimeStamp(header.time).toFormattedString(timeBuf, sizeof(timeBuf)));
+    writer.append(" ");
+    writer.append(CurrentThread::pidString());
+    writer.appendFormatted(" %d ", header.tid);
+    writer.append(site.tag);
+    writer.append(" ");
+    writer.append(logLevelName(site.level));
+    writer.append(": ");
+
+    detail::ArgReader reader(record + sizeof(Header), len - sizeof(Header));
+    const char *fmt = site.format;
+    const char *literal = fmt;
+    for (; *fmt != '\0'; ++fmt) {
+        if (fmt[0] == '{' && fmt[1] == '}') {
+            writer.append(literal, static_cast<size_t>(fmt - literal));
+            if (!reader.next(writer)) {
+                writer.append("{}");
+            }
+            ++fmt;
+            literal = fmt + 1;
+        }
+    }
+    writer.append(literal, static_cast<size_t>(fmt - literal));
+
+#ifndef LOG_HIDE_FILE_LINE
+    writer.append(" -- ");
+    writer.append(site.file);
+    writer.appendFormatted(":%d", site.line);
+#endif // LOG_HIDE_FILE_LINE
+    return writer.finish();
+}
+} // namespace base
+} // namespace wind
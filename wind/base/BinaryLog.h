@@ -0,0 +1,196 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string_view>
+
+#include "CurrentThread.h"
+#include "Log.h"
+#include "TimeStamp.h"
+
+// Binary logging: the calling thread only records the static site of the log and the raw bytes of the
+// arguments, the formatting is deferred to the LogDaemon thread, or done in place without a LogDaemon.
+// Every "{}" in the format is replaced by the next argument, the numbers of them are checked at compile time.
+// -------------------------------------------
+//      LOG_BIN_INFO("connection {} closed, {} bytes sent", fd, bytes);
+// -------------------------------------------
+// The arguments can be integers, floating points, bools, chars, strings and pointers, strings are copied.
+
+namespace wind {
+namespace base {
+// The static part of a binary log, one for every LOG_BIN_* in the source.
+struct BinaryLogSite {
+    const char *format;
+    const char *file; // the base name.
+    int line;
+    LogLevel level;
+    const char *tag;
+};
+
+constexpr size_t MAX_BINARY_LOG_RECORD_SIZE = 512;
+// the longest line formatted from a binary log record, the longer ones are truncated.
+constexpr size_t MAX_BINARY_LOG_LINE_SIZE = DEFAULT_BUFFER_SIZE;
+
+// The record carries the time it was recorded, see BinaryLogRecord::format().
+using BinaryLogOutputFunc = std::function<void(const char *record, size_t len)>;
+
+namespace detail {
+constexpr size_t countLogPlaceholders(const char *format)
+{
+    size_t count = 0;
+    for (; *format != '\0'; ++format) {
+        if (format[0] == '{' && format[1] == '}') {
+            ++count;
+            ++format;
+        }
+    }
+    return count;
+}
+
+enum class BinaryLogArgType : uint8_t {
+    INT,
+    UINT,
+    DOUBLE,
+    BOOL,
+    CHAR,
+    STRING,
+    POINTER,
+};
+} // namespace detail
+
+// Encodes a binary log record on the stack of the calling thread, then hands it to the output.
+class BinaryLogRecord : NonCopyable {
+    struct Header {
+        const BinaryLogSite *site;
+        ThreadId tid;
+        TimeType time; // micro seconds since epoch.
+    };
+
+public:
+    explicit BinaryLogRecord(const BinaryLogSite &site)
+    {
+        Header header{&site, CurrentThread::tid(), TimeStamp::now().get()};
+        ::memcpy(buf_, &header, sizeof(header));
+    }
+    ~BinaryLogRecord() noexcept
+    {
+        output(buf_, len_);
+    }
+
+    template <typename T>
+    void encode(const T &value)
+    {
+        using Type = std::decay_t<T>;
+        using ArgType = detail::BinaryLogArgType;
+        if constexpr (std::is_same_v<Type, bool>) {
+            put(ArgType::BOOL, static_cast<uint8_t>(value));
+        } else if constexpr (std::is_same_v<Type, char>) {
+            put(ArgType::CHAR, value);
+        } else if constexpr (std::is_enum_v<Type>) {
+            encode(enum_cast(value));
+        } else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+            put(ArgType::INT, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<Type>) {
+            put(ArgType::UINT, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<Type>) {
+            put(ArgType::DOUBLE, static_cast<double>(value));
+        } else if constexpr (std::is_array_v<T>) {
+            putString(std::string_view(value));
+        } else if constexpr (std::is_same_v<Type, const char *> || std::is_same_v<Type, char *>) {
+            putString(value != nullptr ? std::string_view(value) : std::string_view("(null)"));
+        } else if constexpr (std::is_convertible_v<const Type &, std::string_view>) {
+            putString(std::string_view(value));
+        } else if constexpr (std::is_pointer_v<Type>) {
+            put(ArgType::POINTER, reinterpret_cast<uintptr_t>(value));
+        } else {
+            static_assert(!sizeof(Type), "unsupported binary log argument type");
+        }
+    }
+
+    // The output of the records, LogDaemon sets it when constructed, they are formatted and written
+    // in place by default.
+    static void setOutputFunc(BinaryLogOutputFunc func);
+
+    // Format a record to a line the same as a Logger writes, it is truncated if size is less than
+    // MAX_BINARY_LOG_LINE_SIZE. @return: the length of the line.
+    static size_t format(const char *record, size_t len, char *buf, size_t size);
+
+private:
+    static void output(const char *record, size_t len);
+
+    template <typename T>
+    void put(detail::BinaryLogArgType type, T value)
+    {
+        if (WIND_UNLIKELY(len_ + 1 + sizeof(T) > sizeof(buf_))) {
+            return;
+        }
+        buf_[len_++] = static_cast<char>(type);
+        ::memcpy(buf_ + len_, &value, sizeof(T));
+        len_ += sizeof(T);
+    }
+
+    void putString(std::string_view s)
+    {
+        constexpr size_t PREFIX_SIZE = 1 + sizeof(uint32_t);
+        if (WIND_UNLIKELY(len_ + PREFIX_SIZE > sizeof(buf_))) {
+            return;
+        }
+        // truncated to the room left.
+        auto strLen = static_cast<uint32_t>(std::min(s.size(), sizeof(buf_) - len_ - PREFIX_SIZE));
+        buf_[len_++] = static_cast<char>(detail::BinaryLogArgType::STRING);
+        ::memcpy(buf_ + len_, &strLen, sizeof(strLen));
+        len_ += sizeof(strLen);
+        ::memcpy(buf_ + len_, s.data(), strLen);
+        len_ += strLen;
+    }
+
+    char buf_[MAX_BINARY_LOG_RECORD_SIZE];
+    size_t len_ = sizeof(Header);
+};
+
+template <size_t PLACEHOLDER_NUM, typename... Args>
+inline void logBinary(const BinaryLogSite &site, const Args &...args)
+{
+    static_assert(PLACEHOLDER_NUM == sizeof...(Args), "the number of {} in the format mismatches the arguments");
+    BinaryLogRecord record(site);
+    (record.encode(args), ...);
+}
+} // namespace base
+} // namespace wind
+
+#define WIND_LOG_BIN(levelValue, logLevel, fmt, ...)                                                                   \
+    do {                                                                                                               \
+        if constexpr (WIND_LOG_MIN_LEVEL <= (levelValue)) {                                                            \
+            if (wind::base::Logger::currentLogLevel() <= (logLevel)) {                                                 \
+                static constexpr wind::base::BinaryLogSite windLogSite{                                                \
+                    fmt, WIND_SOURCE_FILE_NAME.data(), __LINE__, (logLevel), LOG_TAG};                                 \
+                wind::base::logBinary<wind::base::detail::countLogPlaceholders(fmt)>(windLogSite, ##__VA_ARGS__);      \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (0)
+
+#define LOG_BIN_TRACE(fmt, ...) WIND_LOG_BIN(1, wind::base::LogLevel::TRACE, fmt, ##__VA_ARGS__)
+#define LOG_BIN_DEBUG(fmt, ...) WIND_LOG_BIN(2, wind::base::LogLevel::DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_BIN_INFO(fmt, ...) WIND_LOG_BIN(3, wind::base::LogLevel::INFO, fmt, ##__VA_ARGS__)
+#define LOG_BIN_WARN(fmt, ...) WIND_LOG_BIN(4, wind::base::LogLevel::WARN, fmt, ##__VA_ARGS__)
+#define LOG_BIN_ERROR(fmt, ...) WIND_LOG_BIN(5, wind::base::LogLevel::ERROR, fmt, ##__VA_ARGS__)
@@ -0,0 +1,209 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "CpuTopology.h"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <fstream>
+
+#include "CurrentThread.h"
+#include "Log.h"
+
+namespace wind {
+namespace base {
+namespace detail {
+constexpr char SYS_NODE_DIR[] = "/sys/devices/system/node";
+
+bool parseInt(std::string_view str, int &value)
+{
+    if (str.empty() || str.size() > 9) {
+        return false;
+    }
+    value = 0;
+    for (char c : str) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+std::vector<int> processCpus()
+{
+    std::vector<int> cpus;
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (::sched_getaffinity(0, sizeof(cpuSet), &cpuSet) < 0) {
+        LOG_WARN << "sched_getaffinity failed: " << strerror(errno) << ".";
+        return cpus;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &cpuSet)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::map<int, std::vector<int>> readNodeCpus()
+{
+    auto usable = processCpus();
+    std::map<int, std::vector<int>> nodeCpus;
+
+    DIR *dir = ::opendir(SYS_NODE_DIR);
+    if (dir != nullptr) {
+        while (auto *entry = ::readdir(dir)) {
+            std::string_view name(entry->d_name);
+            int node = 0;
+            if (name.substr(0, 4) != "node" || !parseInt(name.substr(4), node)) {
+                continue;
+            }
+
+            std::ifstream file(std::string(SYS_NODE_DIR) + "/" + entry->d_name + "/cpulist");
+            std::string cpuList;
+            std::getline(file, cpuList);
+            for (int cpu : parseCpuList(cpuList)) {
+                if (std::binary_search(usable.begin(), usable.end(), cpu)) {
+                    nodeCpus[node].push_back(cpu);
+                }
+            }
+        }
+        ::closedir(dir);
+    }
+
+    if (nodeCpus.empty()) {
+        nodeCpus[0] = std::move(usable);
+    }
+    return nodeCpus;
+}
+} // namespace detail
+
+std::vector<int> parseCpuList(std::string_view cpuList)
+{
+    std::vector<int> cpus;
+    while (!cpuList.empty()) {
+        auto comma = cpuList.find(',');
+        auto range = cpuList.substr(0, comma);
+        cpuList = comma == std::string_view::npos ? std::string_view() : cpuList.substr(comma + 1);
+
+        while (!range.empty() && (range.back() == '\n' || range.back() == ' ')) {
+            range.remove_suffix(1);
+        }
+        auto dash = range.find('-');
+        int first = 0;
+        int last = 0;
+        if (dash == std::string_view::npos) {
+            if (!detail::parseInt(range, first)) {
+                continue;
+            }
+            last = first;
+        } else if (!detail::parseInt(range.substr(0, dash), first) || !detail::parseInt(range.substr(dash + 1), last)) {
+            continue;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+CpuTopology::CpuTopology(std::map<int, std::vector<int>> nodeCpus)
+{
+    for (auto &[id, cpus] : nodeCpus) {
+        if (cpus.empty()) {
+            continue;
+        }
+        for (int cpu : cpus) {
+            if (static_cast<size_t>(cpu) >= cpuNodes_.size()) {
+                cpuNodes_.resize(cpu + 1, -1);
+            }
+            cpuNodes_[cpu] = id;
+            cpus_.push_back(cpu);
+        }
+        nodes_.push_back({id, std::move(cpus)});
+    }
+}
+
+const CpuTopology &CpuTopology::system()
+{
+    static const CpuTopology topology(detail::readNodeCpus());
+    return topology;
+}
+
+int CpuTopology::nodeOfCpu(int cpu) const
+{
+    if (cpu < 0 || static_cast<size_t>(cpu) >= cpuNodes_.size()) {
+        return -1;
+    }
+    return cpuNodes_[cpu];
+}
+
+int CpuTopology::cpuFor(AffinityPolicy policy, size_t index, const std::vector<int> &coreList) const
+{
+    switch (policy) {
+        case AffinityPolicy::NONE:
+            return -1;
+        case AffinityPolicy::CORE_LIST:
+            return coreList.empty() ? -1 : coreList[index % coreList.size()];
+        case AffinityPolicy::SPREAD: {
+            if (nodes_.empty()) {
+                return -1;
+            }
+            const auto &node = nodes_[index % nodes_.size()];
+            return node.cpus[(index / nodes_.size()) % node.cpus.size()];
+        }
+        case AffinityPolicy::COMPACT:
+            return cpus_.empty() ? -1 : cpus_[index % cpus_.size()];
+    }
+    return -1;
+}
+
+bool pinCurrentThread(int cpu)
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        LOG_WARN << "Invalid cpu " << cpu << " to pin thread " << CurrentThread::name() << ".";
+        return false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    int ret = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (ret != 0) {
+        LOG_WARN << "Pin thread " << CurrentThread::name() << " to cpu " << cpu << " failed: " << strerror(ret)
+                 << ".";
+        return false;
+    }
+    return true;
+}
+
+int currentNumaNode()
+{
+    return CpuTopology::system().nodeOfCpu(::sched_getcpu());
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,85 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <map>
+#include <string_view>
+#include <vector>
+
+namespace wind {
+namespace base {
+enum class AffinityPolicy {
+    // no pinning, leave it to the scheduler.
+    NONE,
+    // the i-th thread of a pool is pinned to the i-th core of the given list, round robin.
+    CORE_LIST,
+    // the threads are spread over the NUMA nodes round robin, one core each.
+    SPREAD,
+    // the threads fill up the cores of a NUMA node before the next one.
+    COMPACT,
+};
+
+// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}, the invalid parts are skipped.
+std::vector<int> parseCpuList(std::string_view cpuList);
+
+// The cpus the process may run on, grouped by NUMA node.
+class CpuTopology {
+public:
+    // node id -> cpus of the node.
+    explicit CpuTopology(std::map<int, std::vector<int>> nodeCpus);
+
+    // Read from sysfs once, a machine without NUMA info is seen as one node 0.
+    static const CpuTopology &system();
+
+    size_t cpuCount() const
+    {
+        return cpus_.size();
+    }
+    size_t nodeCount() const
+    {
+        return nodes_.size();
+    }
+    // -1 if the cpu is unknown.
+    int nodeOfCpu(int cpu) const;
+
+    // The cpu to pin the index-th thread of a pool to, -1 for no pinning.
+    int cpuFor(AffinityPolicy policy, size_t index, const std::vector<int> &coreList = {}) const;
+
+private:
+    struct Node {
+        int id;
+        std::vector<int> cpus;
+    };
+    std::vector<Node> nodes_;
+    // node by node.
+    std::vector<int> cpus_;
+    // indexed by cpu.
+    std::vector<int> cpuNodes_;
+};
+
+// Pin the calling thread to the cpu, log and return false if failed.
+bool pinCurrentThread(int cpu);
+// The NUMA node of the cpu the calling thread is running on, -1 if unknown.
+int currentNumaNode();
+} // namespace base
+} // namespace wind
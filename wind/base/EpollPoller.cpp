@@ -0,0 +1,146 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "EpollPoller.h"
+
+#include "Log.h"
+#include "Utils.h"
+
+namespace wind {
+namespace base {
+namespace detail {
+std::string epollOperationToString(int operation)
+{
+    switch (operation) {
+        case EPOLL_CTL_ADD:
+            return "EpollCtlAdd";
+        case EPOLL_CTL_MOD:
+            return "EpollCtlMod";
+        case EPOLL_CTL_DEL:
+            return "EpollCtlDel";
+        default:
+            return "UnknownEpollCtl";
+    }
+}
+
+constexpr size_t MIN_EVENT_SIZE = 32;
+constexpr size_t MAX_EVENT_SIZE = 4096;
+// shrink only after the event array has been mostly unused for a while, to avoid resizing back and forth.
+constexpr size_t SHRINK_AFTER_LOW_LOAD_POLLS = 128;
+} // namespace detail
+
+EpollPoller::EpollPoller(EventLoop *eventLoop)
+    : EventPoller(eventLoop, PollerType::EPOLL),
+      epollFd_(::epoll_create1(EPOLL_CLOEXEC)),
+      activeEvents_(detail::MIN_EVENT_SIZE)
+{
+    if (!epollFd_.valid()) {
+        LOG_SYS_FATAL << "Create epoll fd failed: " << strerror(errno) << ".";
+    }
+}
+
+EpollPoller::~EpollPoller() noexcept {}
+
+int EpollPoller::waitEvents(std::vector<EventChannel *> &activeChannels, int timeOutMs)
+{
+    int maxEvents = static_cast<int>(activeEvents_.size());
+    auto cnt = TEMP_FAILURE_RETRY(::epoll_wait(epollFd_.get(), activeEvents_.data(), maxEvents, timeOutMs));
+    if (cnt < 0) {
+        LOG_WARN << "epoll_wait error: " << strerror(errno) << ".";
+        return cnt;
+    }
+
+    for (int i = 0; i < cnt; ++i) {
+        const auto &event = activeEvents_[i];
+        // Registered channels are owned by the poller or its retired channels, so the pointer is valid here.
+        auto channel = static_cast<EventChannel *>(event.data.ptr);
+        ASSERT(channel != nullptr);
+        setReceivedEvents(channel, event.events);
+        activeChannels.push_back(channel);
+    }
+
+    adjustEventSize(static_cast<size_t>(cnt));
+    return cnt;
+}
+
+void EpollPoller::adjustEventSize(size_t cnt)
+{
+    auto eventSize = activeEvents_.size();
+    if (cnt == eventSize) {
+        lowLoadPolls_ = 0;
+        if (eventSize < detail::MAX_EVENT_SIZE) {
+            activeEvents_.resize(eventSize * 2);
+        }
+        return;
+    }
+
+    if (cnt >= eventSize / 4 || eventSize <= detail::MIN_EVENT_SIZE) {
+        lowLoadPolls_ = 0;
+        return;
+    }
+
+    if (++lowLoadPolls_ >= detail::SHRINK_AFTER_LOW_LOAD_POLLS) {
+        lowLoadPolls_ = 0;
+        activeEvents_.resize(eventSize / 2);
+        activeEvents_.shrink_to_fit();
+    }
+}
+
+void EpollPoller::addChannel(EventChannel *channel, uint32_t events)
+{
+    epollCtl(channel, EPOLL_CTL_ADD, events);
+}
+
+void EpollPoller::modifyChannel(EventChannel *channel, uint32_t events)
+{
+    epollCtl(channel, EPOLL_CTL_MOD, events);
+}
+
+void EpollPoller::deleteChannel(EventChannel *channel, bool fdReused)
+{
+    // A closed fd has been removed from epoll by the kernel already,
+    // the new channel of the reused fd will take over the registration if any.
+    if (!fdReused) {
+        epollCtl(channel, EPOLL_CTL_DEL, 0);
+    }
+}
+
+void EpollPoller::epollCtl(EventChannel *channel, int operation, uint32_t events)
+{
+    ASSERT(channel != nullptr);
+    int fd = channel->fd();
+    epoll_event epollEvent{0};
+    epollEvent.events = events;
+    epollEvent.data.ptr = channel;
+    int ret = TEMP_FAILURE_RETRY(::epoll_ctl(epollFd_.get(), operation, fd, &epollEvent));
+    if (ret < 0) {
+        if (operation == EPOLL_CTL_ADD && errno == EEXIST) {
+            // The fd is still registered by a stale channel which has been replaced, take it over.
+            epollCtl(channel, EPOLL_CTL_MOD, events);
+            return;
+        }
+        LOG_ERROR << detail::epollOperationToString(operation) << " failed for EventPoller(fd: " << fd
+                  << "): " << strerror(errno) << ".";
+    }
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,55 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "EventPoller.h"
+
+namespace wind {
+namespace base {
+class EpollPoller : public EventPoller {
+public:
+    explicit EpollPoller(EventLoop *eventLoop);
+    ~EpollPoller() noexcept override;
+
+    // Current capacity of the epoll_wait event array, not thread safe.
+    size_t eventSize() const
+    {
+        return activeEvents_.size();
+    }
+
+protected:
+    int waitEvents(std::vector<EventChannel *> &activeChannels, int timeOutMs) override;
+    void addChannel(EventChannel *channel, uint32_t events) override;
+    void modifyChannel(EventChannel *channel, uint32_t events) override;
+    void deleteChannel(EventChannel *channel, bool fdReused) override;
+
+private:
+    void adjustEventSize(size_t cnt);
+    void epollCtl(EventChannel *channel, int operation, uint32_t events);
+
+    UniqueFd epollFd_;
+    std::vector<epoll_event> activeEvents_; // to receive events from epoll_wait, sized adaptively.
+    size_t lowLoadPolls_ = 0;                // consecutive polls that used less than a quarter of activeEvents_.
+};
+} // namespace base
+} // namespace wind
@@ -46,7 +46,7 @@ void EventChannel::remove()
 {
     ASSERT(hasNoEvent());
     addedToLoop_ = false;
-    eventLoop_->removeChannel(fd_);
+    eventLoop_->removeChannel(this);
 }
 
 void EventChannel::enableReading(bool toUpdate)
@@ -85,6 +85,15 @@ void EventChannel::disableWriting(bool toUpdate)
     }
 }
 
+void EventChannel::enableEdgeTriggered(bool toUpdate)
+{
+    listeningEvents_ |= enum_cast(EventType::EDGE_EVENT);
+
+    if (toUpdate) {
+        update();
+    }
+}
+
 void EventChannel::disableAll(bool toRemove)
 {
     listeningEvents_ = enum_cast(EventType::NONE);
@@ -94,13 +103,55 @@ void EventChannel::disableAll(bool toRemove)
     }
 }
 
+void EventChannel::submitRead()
+{
+    addedToLoop_ = true;
+    eventLoop_->submitIo(this, IoRequest{IoType::READ});
+}
+
+void EventChannel::submitWrite(const char *data, size_t len)
+{
+    addedToLoop_ = true;
+    eventLoop_->submitIo(this, IoRequest{IoType::WRITE, data, len});
+}
+
+void EventChannel::submitAccept()
+{
+    addedToLoop_ = true;
+    eventLoop_->submitIo(this, IoRequest{IoType::ACCEPT});
+}
+
+void EventChannel::submitTimeout(TimeStamp expireTime)
+{
+    addedToLoop_ = true;
+    eventLoop_->submitIo(this, IoRequest{IoType::TIMEOUT, nullptr, 0, expireTime});
+}
+
+bool EventChannel::setIoCompleted(IoType type, int result, const char *data)
+{
+    bool first = completedIo_ == 0;
+    completedIo_ |= 1U << enum_cast(type);
+    if (type == IoType::WRITE) {
+        writeResult_ = result;
+    } else {
+        readResult_ = result;
+        readData_ = data;
+    }
+    return first;
+}
+
 void EventChannel::update()
 {
     if (hasNoEvent()) {
         remove();
     } else {
         addedToLoop_ = true;
-        eventLoop_->updateChannel(shared_from_this());
+        if (eventLoop_->isInLoopThread() && inPoller_) {
+            // registered already, the poller applies the change once before next poll.
+            eventLoop_->updateChannel(this);
+        } else {
+            eventLoop_->updateChannel(shared_from_this());
+        }
     }
 }
 
@@ -108,11 +159,18 @@ void EventChannel::handleEvent(TimeStamp receivedTime)
 {
     assertInLoopThread();
 
+    if (WIND_UNLIKELY(!inPoller_)) {
+        LOG_TRACE << "EventChannel::handleEvent: channel " << fd_ << " was removed, drop the stale events.";
+        completedIo_ = 0;
+        return;
+    }
+
     if (tied_) {
         // make sure the owner object will not be destroyed.
         std::shared_ptr<void> guard = ownerObj_.lock();
         if (guard == nullptr) {
             LOG_WARN << "EventChannel::handleEvent: the owner object was dead, do nothing.";
+            completedIo_ = 0;
             return;
         }
         handleEventInner(receivedTime);
@@ -123,9 +181,15 @@ void EventChannel::handleEvent(TimeStamp receivedTime)
 
 void EventChannel::handleEventInner(TimeStamp receivedTime)
 {
+    if (completedIo_ != 0) {
+        handleIoCompletion(receivedTime);
+        return;
+    }
+
     if ((receivedEvents_ & EPOLLHUP) && !(receivedEvents_ & EPOLLIN)) {
         LOG_TRACE << "close event in channel " << fd_ << ".";
         if (closeCallback_ != nullptr) {
+            eventLoop_->setCallbackType(LoopCallbackType::CLOSE);
             closeCallback_();
             return;
         }
@@ -134,6 +198,7 @@ void EventChannel::handleEventInner(TimeStamp receivedTime)
     if (receivedEvents_ & EPOLLERR) {
         LOG_TRACE << "error event in channel " << fd_ << ".";
         if (errorCallback_ != nullptr) {
+            eventLoop_->setCallbackType(LoopCallbackType::ERROR);
             errorCallback_();
             return;
         }
@@ -142,13 +207,40 @@ void EventChannel::handleEventInner(TimeStamp receivedTime)
     if (receivedEvents_ & (EPOLLIN | EPOLLPRI | EPOLLRDHUP)) {
         LOG_TRACE << "read event in channel " << fd_ << ".";
         if (readCallback_ != nullptr) {
+            eventLoop_->setCallbackType(LoopCallbackType::READ);
             readCallback_(receivedTime);
         }
     }
 
-    if (receivedEvents_ & EPOLLOUT) {
+    // EPOLLOUT may be kept registered or not unregistered yet when writing is disabled.
+    if ((receivedEvents_ & EPOLLOUT) && isWriting()) {
         LOG_TRACE << "write event in channel " << fd_ << ".";
         if (writeCallback_ != nullptr) {
+            eventLoop_->setCallbackType(LoopCallbackType::WRITE);
+            writeCallback_();
+        }
+    }
+}
+
+void EventChannel::handleIoCompletion(TimeStamp receivedTime)
+{
+    constexpr uint32_t WRITE_COMPLETED = 1U << enum_cast(IoType::WRITE);
+    uint32_t completed = completedIo_;
+    completedIo_ = 0;
+
+    if ((completed & ~WRITE_COMPLETED) != 0) {
+        LOG_TRACE << "read completion in channel " << fd_ << ".";
+        if (readCallback_ != nullptr) {
+            eventLoop_->setCallbackType(LoopCallbackType::READ);
+            readCallback_(receivedTime);
+        }
+    }
+
+    // the read callback may have removed the channel, the write result is dropped then.
+    if ((completed & WRITE_COMPLETED) != 0 && inPoller_) {
+        LOG_TRACE << "write completion in channel " << fd_ << ".";
+        if (writeCallback_ != nullptr) {
+            eventLoop_->setCallbackType(LoopCallbackType::WRITE);
             writeCallback_();
         }
     }
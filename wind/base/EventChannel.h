@@ -47,6 +47,24 @@ enum class EventType : uint32_t {
     EDGE_EVENT = EPOLLET,
 };
 
+// The completion based io requests of a channel, see EventChannel::submitRead().
+enum class IoType : uint32_t {
+    READ,
+    WRITE,
+    ACCEPT,
+    TIMEOUT,
+};
+
+// Max bytes read by a read request.
+constexpr size_t COMPLETION_READ_SIZE = 64 * 1024;
+
+struct IoRequest {
+    IoType type = IoType::READ;
+    const char *data = nullptr; // the data to write.
+    size_t len = 0;
+    TimeStamp expireTime; // when a timeout request completes.
+};
+
 // The EventChannel class not own the fd, so we must make sure that
 // the fd is valid when an EventChannel object holds it.
 class EventChannel : public std::enable_shared_from_this<EventChannel>, NonCopyable {
@@ -88,7 +106,11 @@ public:
 
     bool hasNoEvent() const
     {
-        return listeningEvents() == enum_cast(EventType::NONE);
+        return (listeningEvents() & ~enum_cast(EventType::EDGE_EVENT)) == enum_cast(EventType::NONE);
+    }
+    bool isEdgeTriggered() const
+    {
+        return listeningEvents() & enum_cast(EventType::EDGE_EVENT);
     }
     bool isWriting() const
     {
@@ -107,9 +129,53 @@ public:
     void enableWriting(bool toUpdate = true);
     // @toUpdate: whether to update the channel in poller or not, true by default.
     void disableWriting(bool toUpdate = true);
+    // @toUpdate: whether to update the channel in poller or not, true by default.
+    void enableEdgeTriggered(bool toUpdate = true);
+    // Keep EPOLLOUT registered while the channel is edge triggered, so enabling and disabling writing
+    // changes nothing in the poller. Writing must only be enabled after a write hit EAGAIN,
+    // otherwise no writable edge will come. not thread safe.
+    void setKeepWriteRegistered(bool keepWriteRegistered)
+    {
+        keepWriteRegistered_ = keepWriteRegistered;
+    }
+    bool keepWriteRegistered() const
+    {
+        return keepWriteRegistered_;
+    }
     // @toRemove: whether to remove the channel in poller or not, true by default.
     void disableAll(bool toRemove = true);
 
+    // Completion based io, only if the poller of the loop supports it, see EventLoop::supportsCompletionIo().
+    // A request is submitted with the next poll instead of waiting for the readiness. The completion of a read,
+    // accept or timeout calls the read callback, and the completion of a write calls the write callback.
+    // At most one read side (read, accept or timeout) request and one write request can be in flight.
+    // Removing the channel cancels them. Must be called in loop thread.
+
+    // read into a buffer of the poller, which is only valid in the read callback, see readData().
+    void submitRead();
+    // data must be kept valid until the write callback, the tied owner is kept alive until then.
+    void submitWrite(const char *data, size_t len);
+    // the accepted fd(non-blocking and close-on-exec) is the result, and readData() is its sockaddr.
+    void submitAccept();
+    // the read callback is called at expireTime, replacing the timeout in flight. An invalid expireTime cancels it.
+    void submitTimeout(TimeStamp expireTime);
+
+    // The results are only valid in the callbacks of the completed requests.
+    // bytes read, the accepted fd, or 0 for a timeout. -errno on failure.
+    int readResult() const
+    {
+        return readResult_;
+    }
+    const char *readData() const
+    {
+        return readData_;
+    }
+    // bytes written, or -errno on failure.
+    int writeResult() const
+    {
+        return writeResult_;
+    }
+
     void update();
     void remove();
 
@@ -126,6 +192,7 @@ protected:
     void assertInLoopThread() const;
 
     void handleEventInner(TimeStamp receivedTime);
+    void handleIoCompletion(TimeStamp receivedTime);
 
     friend class EventPoller;
     uint32_t listeningEvents() const
@@ -136,13 +203,25 @@ protected:
     {
         receivedEvents_ = events;
     }
+    // return true if it is the first completion of the channel in this round.
+    bool setIoCompleted(IoType type, int result, const char *data);
 
     int fd_ = -1;
     EventLoop *eventLoop_ = nullptr;
     std::atomic<bool> addedToLoop_ = false;
+    // the following states are only accessed in loop thread.
+    bool inPoller_ = false;           // whether registered in the poller.
+    bool updatePending_ = false;      // interest changed but not applied to the poller yet.
+    bool keepWriteRegistered_ = false;
+    uint32_t registeredEvents_ = enum_cast(EventType::NONE); // events registered in the poller backend.
 
     uint32_t listeningEvents_ = enum_cast(EventType::NONE);
     uint32_t receivedEvents_ = enum_cast(EventType::NONE);
+    // the io requests completed in this round, and their results.
+    uint32_t completedIo_ = 0;
+    int readResult_ = 0;
+    const char *readData_ = nullptr;
+    int writeResult_ = 0;
 
     ReadCallback readCallback_;
     EventCallback writeCallback_;
@@ -29,12 +29,13 @@ namespace wind {
 namespace base {
 __thread EventLoop *t_currLoop = nullptr; // current thread's event_loop
 
-EventLoop::EventLoop()
+EventLoop::EventLoop(PollerType pollerType, TimerManagerType timerManagerType)
     : tid_(CurrentThread::tid()),
-      poller_(std::make_unique<EventPoller>(this)),
+      threadName_(CurrentThread::name()),
+      poller_(EventPoller::create(this, pollerType)),
       wakeUpFd_(utils::createEventFdOrDie()),
       wakeUpChannel_(std::make_shared<EventChannel>(wakeUpFd_.get(), this)),
-      timerManager_(std::make_unique<TimerManager>(this))
+      timerManager_(TimerManager::create(this, timerManagerType))
 {
     if (t_currLoop != nullptr) {
         LOG_SYS_FATAL << "Construct EventLoop failed: current thread already have a loop(" << &t_currLoop << ")!";
@@ -72,62 +73,99 @@ void EventLoop::updateChannel(std::shared_ptr<EventChannel> channel)
     runInLoop([this, channel]() mutable { poller_->updateChannel(std::move(channel)); });
 }
 
-void EventLoop::removeChannel(int channelFd)
+void EventLoop::updateChannel(EventChannel *channel)
 {
-    runInLoop([=]() { poller_->removeChannel(channelFd); });
+    assertInLoopThread();
+    poller_->updateChannel(channel);
+}
+
+void EventLoop::removeChannel(EventChannel *channel)
+{
+    // the fd is read now, the channel may be gone when the removal runs.
+    int fd = channel->fd();
+    runInLoop([=]() { poller_->removeChannel(fd, channel); });
 }
 
-void EventLoop::execPendingFunctors()
+void EventLoop::submitIo(EventChannel *channel, const IoRequest &request)
 {
     assertInLoopThread();
+    poller_->submitIo(channel, request);
+}
 
-    executingPendingFunctors_ = true;
-    std::vector<Functor> funcs;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        funcs.swap(pendingFunctors_);
-    }
+size_t EventLoop::execPendingFunctors()
+{
+    assertInLoopThread();
 
-    for (const auto &func : funcs) {
-        func();
+    executingPendingFunctors_ = true;
+    // Must be cleared before consuming, producers which see it set are sure to be consumed this time.
+    wakeUpPending_.exchange(false);
+    auto run = [](Functor &func) { func(); };
+    size_t count = highPriorityFunctors_.consumeAll(run);
+    count += pendingFunctors_.consumeAll(run);
+
+    TimeType budget = lowPriorityBudget_.load(std::memory_order_relaxed);
+    if (budget == 0) {
+        count += lowPriorityFunctors_.consumeAll(run);
+    } else {
+        // reading the clock is not free, check it every few functors.
+        constexpr size_t CHECK_INTERVAL = 8;
+        TimeStamp deadline = timeAdd(TimeStamp::now(), budget);
+        size_t checkCount = 0;
+        count += lowPriorityFunctors_.consumeUntil(run, [this, &checkCount, deadline]() {
+            return !highPriorityFunctors_.empty() ||
+                (++checkCount % CHECK_INTERVAL == 0 && TimeStamp::now() >= deadline);
+        });
     }
     executingPendingFunctors_ = false;
+    return count;
 }
 
-void EventLoop::queueToLoop(Functor func)
+void EventLoop::queueToLoop(Functor func, FunctorPriority priority)
 {
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pendingFunctors_.push_back(std::move(func));
+    switch (priority) {
+        case FunctorPriority::HIGH:
+            highPriorityFunctors_.push(std::move(func));
+            break;
+        case FunctorPriority::NORMAL:
+            pendingFunctors_.push(std::move(func));
+            break;
+        case FunctorPriority::LOW:
+            lowPriorityFunctors_.push(std::move(func));
+            break;
     }
 
     if (!isInLoopThread() || executingPendingFunctors_) {
-        wakeUp();
+        wakeUpIfNeeded();
     }
 }
 
-void EventLoop::runInLoop(Functor func)
+void EventLoop::runInLoop(Functor func, FunctorPriority priority)
 {
     if (isInLoopThread()) {
         func();
     } else {
-        queueToLoop(std::move(func));
+        queueToLoop(std::move(func), priority);
     }
 }
 
-TimerId EventLoop::runAt(Functor func, TimeStamp dstTime)
+void EventLoop::setLowPriorityBudget(TimeType budget)
 {
-    return timerManager_->addTimer(std::move(func), dstTime);
+    lowPriorityBudget_.store(budget, std::memory_order_relaxed);
 }
 
-TimerId EventLoop::runAfter(Functor func, TimeType delay)
+TimerId EventLoop::runAt(Functor func, TimeStamp dstTime, TimeType slack)
 {
-    return timerManager_->addTimer(std::move(func), timeAdd(TimeStamp::now(), delay));
+    return timerManager_->addTimer(std::move(func), dstTime, 0, slack);
 }
 
-TimerId EventLoop::runEvery(Functor func, TimeType interval, TimeType delay)
+TimerId EventLoop::runAfter(Functor func, TimeType delay, TimeType slack)
 {
-    return timerManager_->addTimer(std::move(func), timeAdd(TimeStamp::now(), delay), interval);
+    return timerManager_->addTimer(std::move(func), timeAdd(TimeStamp::now(), delay), 0, slack);
+}
+
+TimerId EventLoop::runEvery(Functor func, TimeType interval, TimeType delay, TimeType slack)
+{
+    return timerManager_->addTimer(std::move(func), timeAdd(TimeStamp::now(), delay), interval, slack);
 }
 
 void EventLoop::cancel(const TimerId &timerId)
@@ -135,21 +173,45 @@ void EventLoop::cancel(const TimerId &timerId)
     timerManager_->cancelTimer(timerId);
 }
 
+void EventLoop::setBusyPollTime(TimeType busyPollTime)
+{
+    poller_->setBusyPollTime(busyPollTime);
+}
+
 void EventLoop::start()
 {
     assertInLoopThread();
 
     running_ = true;
+    // the clock is read once between two callbacks, every read costs tens of nano seconds.
+    uint64_t pollBegin = utils::monotonicNanos();
     while (running_) {
-        std::vector<std::shared_ptr<EventChannel>> activeChannels;
-        TimeStamp pollTime = poller_->pollOnce(activeChannels, -1);
-        for (const auto &channel : activeChannels) {
-            if (channel != nullptr) {
-                channel->handleEvent(pollTime);
-            }
+        activeChannels_.clear();
+        // do not block with the low priority functors left by the budget.
+        TimeStamp pollTime = poller_->pollOnce(activeChannels_, lowPriorityFunctors_.hasBacklog() ? 0 : -1);
+        uint64_t dispatchBegin = utils::monotonicNanos();
+        stats_.recordPoll(dispatchBegin - pollBegin, activeChannels_.size());
+
+        uint64_t callbackBegin = dispatchBegin;
+        for (EventChannel *channel : activeChannels_) {
+            int fd = channel->fd();
+            activity_.begin(callbackBegin, fd, LoopCallbackType::EVENT);
+            channel->handleEvent(pollTime);
+            uint64_t callbackEnd = utils::monotonicNanos();
+            stats_.recordCallback(callbackEnd - callbackBegin, fd);
+            callbackBegin = callbackEnd;
         }
-
-        execPendingFunctors();
+        poller_->releaseRetiredChannels();
+        uint64_t functorBegin = utils::monotonicNanos();
+        stats_.recordDispatch(functorBegin - dispatchBegin);
+
+        activity_.begin(functorBegin, -1, LoopCallbackType::FUNCTOR);
+        size_t functorNum = execPendingFunctors();
+        activity_.end();
+        uint64_t iterationEnd = utils::monotonicNanos();
+        stats_.recordDrain(iterationEnd - functorBegin, functorNum);
+        stats_.recordIteration(iterationEnd - dispatchBegin);
+        pollBegin = iterationEnd;
     }
 }
 
@@ -181,6 +243,13 @@ void EventLoop::wakeUp()
     }
 }
 
+void EventLoop::wakeUpIfNeeded()
+{
+    if (!wakeUpPending_.exchange(true)) {
+        wakeUp();
+    }
+}
+
 void EventLoop::wakeUpCallback()
 {
     uint64_t buf = 0;
@@ -26,72 +26,130 @@
 #include <type_traits>
 
 #include "EventPoller.h"
+#include "LoopStats.h"
+#include "MpscQueue.h"
 #include "TimerManager.h"
+#include "UniqueFunction.h"
 
 namespace wind {
 namespace base {
-using Functor = std::function<void()>;
-
-namespace detail {
-template <typename Callable>
-class PackagedTask : NonCopyable {
-    using Return = std::invoke_result_t<Callable>;
-
-public:
-    ~PackagedTask() noexcept = default;
-
-    static auto Create(Callable &&cb)
-    {
-        std::shared_ptr<PackagedTask<Callable>> t(new PackagedTask(std::forward<Callable &&>(cb)));
-        return std::make_pair(t, t->cb_.get_future());
-    }
-
-    void Run()
-    {
-        cb_();
-    }
-
-private:
-    explicit PackagedTask(Callable &&cb) : cb_(std::move(cb)) {}
-
-    std::packaged_task<Return()> cb_;
+using Functor = UniqueFunction<void()>;
+
+// Lanes of the functors queued to a loop, the order is only kept in the same lane.
+enum class FunctorPriority {
+    // control work like connection establishing and removing, timer changes, runs first in every iteration.
+    HIGH,
+    NORMAL,
+    // bulk work like sending, runs last within the low priority budget of an iteration, the rest is continued
+    // in the next iteration after the io events are handled.
+    LOW,
 };
-} // namespace detail
 
 class EventLoop : NonCopyable {
+    static constexpr TimeType DEFAULT_LOW_PRIORITY_BUDGET = 1000;
+
 public:
-    EventLoop();
+    // @pollerType: io_uring falls back to epoll if the kernel does not support it.
+    // @timerManagerType: the timing wheel suits lots of coarse timers, such as idle timeouts.
+    explicit EventLoop(
+        PollerType pollerType = PollerType::EPOLL,
+        TimerManagerType timerManagerType = TimerManagerType::SORTED);
     ~EventLoop() noexcept;
     void start();
     void stop() noexcept;
     void updateChannel(std::shared_ptr<EventChannel> channel);
-    void removeChannel(int channelFd);
+    // update a channel registered already, must be called in loop thread.
+    void updateChannel(EventChannel *channel);
+    // the channel is removed only if it is still the one registered with its fd.
+    void removeChannel(EventChannel *channel);
+
+    // Whether the poller does completion based io, which is io_uring on a kernel with the needed operations.
+    // The io of the connections and acceptors on such a loop is submitted to the poller instead of done by
+    // syscalls on readiness, see EventChannel::submitRead().
+    bool supportsCompletionIo() const
+    {
+        return poller_->supportsCompletionIo();
+    }
+    // submit a completion based io request of the channel, must be called in loop thread.
+    void submitIo(EventChannel *channel, const IoRequest &request);
 
     template <typename Task, typename Ret = std::invoke_result_t<Task>>
     std::future<Ret> schedule(Task task)
     {
-        auto [packagedTask, future] = detail::PackagedTask<Task>::Create(std::move(task));
-        runInLoop([t(std::move(packagedTask))]() { t->Run(); });
-        return std::move(future);
+        std::packaged_task<Ret()> packagedTask(std::move(task));
+        auto future = packagedTask.get_future();
+        runInLoop([t(std::move(packagedTask))]() mutable { t(); });
+        return future;
     }
 
     // run func immediately if in loop thread, or call queueToLoop() if in other thread.
-    void runInLoop(Functor func);
+    void runInLoop(Functor func, FunctorPriority priority = FunctorPriority::NORMAL);
 
-    // add this func to the last of the loop's pending functors.
-    void queueToLoop(Functor func);
+    // add this func to the last of the loop's pending functors of the priority, lock free and thread safe.
+    void queueToLoop(Functor func, FunctorPriority priority = FunctorPriority::NORMAL);
 
-    TimerId runAt(Functor func, TimeStamp dstTime);
+    // the time in micro seconds to run the low priority functors in an iteration, 1 ms by default,
+    // 0 means no limit. They also yield to the high priority ones queued meanwhile. thread safe.
+    void setLowPriorityBudget(TimeType budget);
+
+    // The timer functions are thread safe and never block, the TimerId is valid to cancel at once.
+    // slack in micro seconds: the func may be delayed for at most slack, which lets the timers expiring
+    // close together share one wakeup, 0 means exact. Heartbeats and timeouts can usually tolerate a lot.
+    TimerId runAt(Functor func, TimeStamp dstTime, TimeType slack = 0);
 
     // delay in micro seconds, 0 means run immediately
-    TimerId runAfter(Functor func, TimeType delay);
+    TimerId runAfter(Functor func, TimeType delay, TimeType slack = 0);
 
     // delay in micro seconds, 0 means run immediately
     // interval in micro seconds, 0 means only run once.
-    TimerId runEvery(Functor func, TimeType interval, TimeType delay = 0);
+    TimerId runEvery(Functor func, TimeType interval, TimeType delay = 0, TimeType slack = 0);
 
     void cancel(const TimerId &timerId);
 
+    PollerType pollerType() const
+    {
+        return poller_->type();
+    }
+
+    TimerManagerType timerManagerType() const
+    {
+        return timerManager_->type();
+    }
+
+    // busy poll for at most busyPollTime micro seconds before blocking in epoll_wait,
+    // 0 means no busy polling (default). thread safe.
+    void setBusyPollTime(TimeType busyPollTime);
+
+    // the histograms of poll wait, dispatch and functor time, events per poll and so on since the loop
+    // started, along with the slowest channel callback and its fd. thread safe.
+    LoopStatsSnapshot stats() const
+    {
+        return stats_.snapshot();
+    }
+
+    // the callback the loop is running now, sampled by the watchdog. thread safe.
+    LoopActivitySample activity() const
+    {
+        return activity_.sample();
+    }
+
+    // refine the type of the callback running now, must be called in loop thread.
+    void setCallbackType(LoopCallbackType type)
+    {
+        activity_.setType(type);
+    }
+
+    ThreadId threadId() const
+    {
+        return tid_;
+    }
+
+    // the name of the loop thread.
+    const std::string &threadName() const
+    {
+        return threadName_;
+    }
+
     static EventLoop *eventLoopOfCurrThread();
 
     bool isInLoopThread() const;
@@ -103,24 +161,35 @@ public:
 
 private:
     void wakeUp();
+    // coalesced wakeUp(), only write the eventFd when there is no wakeup pending.
+    void wakeUpIfNeeded();
     void wakeUpCallback();
 
-    void execPendingFunctors();
+    // @return: the number of functors executed.
+    size_t execPendingFunctors();
 
     ThreadId tid_ = -1; // indicates which thread is this loop in.
+    std::string threadName_;
 
-    mutable std::mutex mutex_;
     std::atomic<bool> running_ = false;
 
     std::unique_ptr<EventPoller> poller_;
+    std::vector<EventChannel *> activeChannels_; // reused by every loop iteration.
 
     UniqueFd wakeUpFd_;
     std::shared_ptr<EventChannel> wakeUpChannel_;
 
     std::atomic<bool> executingPendingFunctors_ = false;
-    std::vector<Functor> pendingFunctors_;
+    std::atomic<bool> wakeUpPending_ = false; // whether the eventFd was written and not consumed yet.
+    MpscQueue<Functor> highPriorityFunctors_;
+    MpscQueue<Functor> pendingFunctors_;
+    MpscQueue<Functor> lowPriorityFunctors_;
+    std::atomic<TimeType> lowPriorityBudget_ = DEFAULT_LOW_PRIORITY_BUDGET;
 
     std::unique_ptr<TimerManager> timerManager_;
+
+    LoopStats stats_;
+    LoopActivity activity_;
 };
 } // namespace base
 } // namespace wind
@@ -22,13 +22,16 @@
 
 #include "EventLoopThread.h"
 
+#include "CpuTopology.h"
 #include "Log.h"
 
 namespace wind {
 namespace base {
 EventLoopThread::EventLoopThread() : EventLoopThread("WindEventLoopThread") {}
 
-EventLoopThread::EventLoopThread(std::string name) : name_(std::move(name)) {}
+EventLoopThread::EventLoopThread(std::string name, PollerType pollerType, TimerManagerType timerManagerType)
+    : name_(std::move(name)), pollerType_(pollerType), timerManagerType_(timerManagerType)
+{}
 
 EventLoopThread::~EventLoopThread() noexcept
 {
@@ -57,7 +60,10 @@ EventLoop *EventLoopThread::start()
 
 void EventLoopThread::loopThreadFunc()
 {
-    EventLoop loop;
+    if (cpu_ >= 0) {
+        pinCurrentThread(cpu_);
+    }
+    EventLoop loop(pollerType_, timerManagerType_);
 
     {
         std::lock_guard<std::mutex> lock(mutex_);
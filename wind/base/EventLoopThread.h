@@ -32,9 +32,24 @@ namespace base {
 class EventLoopThread : NonCopyable {
 public:
     EventLoopThread();
-    explicit EventLoopThread(std::string name);
+    explicit EventLoopThread(
+        std::string name,
+        PollerType pollerType = PollerType::EPOLL,
+        TimerManagerType timerManagerType = TimerManagerType::SORTED);
     ~EventLoopThread() noexcept;
 
+    // Pin the loop thread to the cpu before the loop is created, -1 for no pinning.
+    // The memory first touched by the loop thread is then allocated on the local NUMA node.
+    // Should be called before start().
+    void setCpu(int cpu)
+    {
+        cpu_ = cpu;
+    }
+    int cpu() const
+    {
+        return cpu_;
+    }
+
     EventLoop *start();
     const std::string &name() const
     {
@@ -47,6 +62,9 @@ private:
     mutable std::mutex mutex_;
     std::condition_variable cond_;
     std::string name_;
+    PollerType pollerType_;
+    TimerManagerType timerManagerType_;
+    int cpu_ = -1;
     Thread thread_;
     EventLoop *loop_ = nullptr;
 };
@@ -35,8 +35,10 @@ EventLoopThreadPool::EventLoopThreadPool(EventLoop *mainLoop, std::string name)
 EventLoopThreadPool::~EventLoopThreadPool() noexcept
 {
     running_ = false;
+    watchdog_.reset();
     currLoopIdx_ = 0;
     threadNum_ = 0;
+    nodeLoops_.clear();
     loops_.clear();
     loopThreads_.clear();
 }
@@ -50,16 +52,41 @@ void EventLoopThreadPool::start()
     mainLoop_->assertInLoopThread();
 
     running_ = true;
+    startWatchdog();
     if (threadNum_ == 0) {
         return;
     }
 
     loopThreads_.resize(threadNum_);
     loops_.resize(threadNum_);
+    const auto &topology = CpuTopology::system();
     for (size_t i = 0; i != threadNum_; ++i) {
-        loopThreads_[i] = std::make_unique<EventLoopThread>(name_ + "_loop_" + std::to_string(i));
+        loopThreads_[i] = std::make_unique<EventLoopThread>(
+            name_ + "_loop_" + std::to_string(i), pollerType_, timerManagerType_);
+        int cpu = topology.cpuFor(affinityPolicy_, i, coreList_);
+        loopThreads_[i]->setCpu(cpu);
         loops_[i] = loopThreads_[i]->start();
+
+        int node = topology.nodeOfCpu(cpu);
+        if (node >= 0) {
+            nodeLoops_[node].loops.push_back(loops_[i]);
+        }
+        if (watchdog_ != nullptr) {
+            watchdog_->watch(loops_[i]);
+        }
+    }
+}
+
+void EventLoopThreadPool::startWatchdog()
+{
+    if (watchdogThreshold_ <= 0) {
+        return;
     }
+
+    watchdog_ = std::make_unique<LoopWatchdog>(watchdogThreshold_, name_ + "_watchdog");
+    watchdog_->setBacktraceEnabled(watchdogBacktraceEnabled_);
+    watchdog_->watch(mainLoop_);
+    watchdog_->start();
 }
 
 EventLoop *EventLoopThreadPool::getNextLoop()
@@ -78,5 +105,21 @@ EventLoop *EventLoopThreadPool::getNextLoop()
     }
     return loop;
 }
+
+EventLoop *EventLoopThreadPool::getNextLoop(int numaNode)
+{
+    mainLoop_->assertInLoopThread();
+    auto iter = nodeLoops_.find(numaNode);
+    if (!running_ || iter == nodeLoops_.end()) {
+        return getNextLoop();
+    }
+
+    auto &nodeLoops = iter->second;
+    EventLoop *loop = nodeLoops.loops[nodeLoops.currLoopIdx++];
+    if (nodeLoops.currLoopIdx >= nodeLoops.loops.size()) {
+        nodeLoops.currLoopIdx = 0;
+    }
+    return loop;
+}
 } // namespace base
 } // namespace wind
@@ -22,7 +22,11 @@
 
 #pragma once
 
+#include <map>
+
+#include "CpuTopology.h"
 #include "EventLoopThread.h"
+#include "LoopWatchdog.h"
 
 namespace wind {
 namespace base {
@@ -39,7 +43,53 @@ public:
         threadNum_ = threadNum;
     }
 
+    // the poller type of the loops in pool, the main loop is not affected.
+    void setPollerType(PollerType pollerType)
+    {
+        if (running_) {
+            return;
+        }
+        pollerType_ = pollerType;
+    }
+
+    // the timer manager type of the loops in pool, the main loop is not affected.
+    void setTimerManagerType(TimerManagerType timerManagerType)
+    {
+        if (running_) {
+            return;
+        }
+        timerManagerType_ = timerManagerType;
+    }
+
+    // placement of the loop threads, the main loop is not affected.
+    // @coreList: only for AffinityPolicy::CORE_LIST.
+    void setAffinity(AffinityPolicy policy, std::vector<int> coreList = {})
+    {
+        if (running_) {
+            return;
+        }
+        affinityPolicy_ = policy;
+        coreList_ = std::move(coreList);
+    }
+    AffinityPolicy affinityPolicy() const
+    {
+        return affinityPolicy_;
+    }
+
+    // Watch the main loop and the loops in pool, the callbacks running longer than threshold micro seconds are
+    // logged with the thread name, fd and callback type, see LoopWatchdog.
+    void setWatchdog(TimeType threshold, bool backtraceEnabled = false)
+    {
+        if (running_) {
+            return;
+        }
+        watchdogThreshold_ = threshold;
+        watchdogBacktraceEnabled_ = backtraceEnabled;
+    }
+
     EventLoop *getNextLoop();
+    // Round robin among the loops pinned on the NUMA node, or getNextLoop() if there is none.
+    EventLoop *getNextLoop(int numaNode);
     void start();
     const std::string &name() const
     {
@@ -47,13 +97,31 @@ public:
     }
 
 private:
+    void startWatchdog();
+
     EventLoop *mainLoop_ = nullptr;
     std::string name_;
     size_t threadNum_ = 0;
+    PollerType pollerType_ = PollerType::EPOLL;
+    TimerManagerType timerManagerType_ = TimerManagerType::SORTED;
+    AffinityPolicy affinityPolicy_ = AffinityPolicy::NONE;
+    std::vector<int> coreList_;
     std::atomic<bool> running_ = false;
     std::vector<std::unique_ptr<EventLoopThread>> loopThreads_;
     std::vector<EventLoop *> loops_;
     size_t currLoopIdx_ = 0;
+
+    struct NodeLoops {
+        std::vector<EventLoop *> loops;
+        size_t currLoopIdx = 0;
+    };
+    std::map<int, NodeLoops> nodeLoops_;
+
+    // 0 means no watchdog.
+    TimeType watchdogThreshold_ = 0;
+    bool watchdogBacktraceEnabled_ = false;
+    // declared last to be stopped before the loops are gone.
+    std::unique_ptr<LoopWatchdog> watchdog_;
 };
 } // namespace base
 } // namespace wind
@@ -22,65 +22,48 @@
 
 #include "EventPoller.h"
 
+#include "EpollPoller.h"
 #include "EventLoop.h"
+#include "IoUringPoller.h"
 #include "Log.h"
-#include "Utils.h"
 
 namespace wind {
 namespace base {
-namespace detail {
-std::string epollOperationToString(int operation)
+std::unique_ptr<EventPoller> EventPoller::create(EventLoop *eventLoop, PollerType type)
 {
-    switch (operation) {
-        case EPOLL_CTL_ADD:
-            return "EpollCtlAdd";
-        case EPOLL_CTL_MOD:
-            return "EpollCtlMod";
-        case EPOLL_CTL_DEL:
-            return "EpollCtlDel";
-        default:
-            return "UnknownEpollCtl";
+    if (type == PollerType::IO_URING) {
+        if (IoUringPoller::isSupported()) {
+            return std::make_unique<IoUringPoller>(eventLoop);
+        }
+        LOG_WARN << "io_uring is not supported by the kernel, fall back to epoll.";
     }
-}
-} // namespace detail
 
-size_t EventPoller::eventSize_ = 32;
+    return std::make_unique<EpollPoller>(eventLoop);
+}
 
-EventPoller::EventPoller(EventLoop *eventLoop)
-    : eventLoop_(eventLoop), epollFd_(::epoll_create1(EPOLL_CLOEXEC)), activeEvents_(eventSize_)
+EventPoller::EventPoller(EventLoop *eventLoop, PollerType type) : eventLoop_(eventLoop), type_(type)
 {
     LOG_FATAL_IF(eventLoop_ == nullptr) << "EventLoop is null!";
 }
 
 EventPoller::~EventPoller() noexcept {}
 
-TimeStamp EventPoller::pollOnce(std::vector<std::shared_ptr<EventChannel>> &activeChannels, int timeOutMs)
+TimeStamp EventPoller::pollOnce(std::vector<EventChannel *> &activeChannels, int timeOutMs)
 {
-    auto cnt = TEMP_FAILURE_RETRY(::epoll_wait(epollFd_.get(), activeEvents_.data(), eventSize_, timeOutMs));
-    auto pollTime = TimeStamp::now();
-    if (cnt < 0) {
-        LOG_WARN << "epoll_wait error: " << strerror(errno) << ".";
-    } else {
-        for (int i = 0; i < cnt; ++i) {
-            const auto &event = activeEvents_[i];
-            int fd = event.data.fd;
-            if (channels_.count(fd) == 0 && channels_.at(fd) == nullptr) {
-                LOG_WARN << "epoll_wait returned a channel that is not in poller " << epollFd_.get() << ".";
-                continue;
+    applyPendingUpdates();
+
+    auto busyPollTime = busyPollTime_.load(std::memory_order_relaxed);
+    if (busyPollTime > 0 && timeOutMs != 0) {
+        auto deadline = timeAdd(TimeStamp::now(), busyPollTime);
+        do {
+            if (waitEvents(activeChannels, 0) != 0) {
+                return TimeStamp::now();
             }
-
-            const auto &channel = channels_.at(fd);
-            channel->setReceivedEvents(event.events);
-            activeChannels.emplace_back(channel);
-        }
-
-        if (static_cast<size_t>(cnt) == eventSize_) {
-            eventSize_ *= 2;
-            activeEvents_.resize(eventSize_);
-        }
+        } while (TimeStamp::now() < deadline);
     }
 
-    return pollTime;
+    waitEvents(activeChannels, timeOutMs);
+    return TimeStamp::now();
 }
 
 void EventPoller::assertInLoopThread()
@@ -89,20 +72,6 @@ void EventPoller::assertInLoopThread()
     eventLoop_->assertInLoopThread();
 }
 
-void EventPoller::epollCtl(const std::shared_ptr<EventChannel> &channel, int operation)
-{
-    ASSERT(channel != nullptr);
-    int fd = channel->fd();
-    epoll_event epollEvent{0};
-    epollEvent.events = channel->listeningEvents();
-    epollEvent.data.fd = fd;
-    int ret = TEMP_FAILURE_RETRY(::epoll_ctl(epollFd_.get(), operation, fd, &epollEvent));
-    if (ret < 0) {
-        LOG_ERROR << detail::epollOperationToString(operation) << " failed for EventPoller(fd: " << fd
-                  << "): " << strerror(errno) << ".";
-    }
-}
-
 void EventPoller::updateChannel(std::shared_ptr<EventChannel> channel)
 {
     if (channel == nullptr) {
@@ -113,31 +82,120 @@ void EventPoller::updateChannel(std::shared_ptr<EventChannel> channel)
 
     int fd = channel->fd();
     if (channel->hasNoEvent()) {
-        eventLoop_->removeChannel(fd);
+        removeChannel(fd, channel.get());
         return;
     }
 
-    if (channels_.count(fd) == 0) {
-        // new channel
-        epollCtl(channel, EPOLL_CTL_ADD);
-        channels_[fd] = std::move(channel);
-    } else {
+    if (getChannel(fd) == channel.get()) {
         // modify channel
-        epollCtl(channels_[fd], EPOLL_CTL_MOD);
+        updateChannel(channel.get());
+        return;
     }
+
+    // new channel
+    EventChannel *newChannel = channel.get();
+    registerChannel(std::move(channel));
+    newChannel->registeredEvents_ = pollEvents(newChannel);
+    newChannel->updatePending_ = false;
+    addChannel(newChannel, newChannel->registeredEvents_);
+}
+
+void EventPoller::registerChannel(std::shared_ptr<EventChannel> channel)
+{
+    int fd = channel->fd();
+    if (static_cast<size_t>(fd) >= channels_.size()) {
+        channels_.resize(std::max(static_cast<size_t>(fd) + 1, channels_.size() * 2));
+    }
+
+    auto &slot = channels_[fd];
+    if (slot != nullptr) {
+        // the fd was reused by a new channel before the old one removed itself.
+        deleteChannel(slot.get(), true);
+        retireChannel(fd);
+    }
+
+    channel->inPoller_ = true;
+    slot = std::move(channel);
 }
 
-void EventPoller::removeChannel(int fd)
+void EventPoller::updateChannel(EventChannel *channel)
+{
+    ASSERT(channel != nullptr && getChannel(channel->fd()) == channel);
+    if (!channel->updatePending_) {
+        channel->updatePending_ = true;
+        pendingUpdateFds_.push_back(channel->fd());
+    }
+}
+
+void EventPoller::applyPendingUpdates()
+{
+    for (int fd : pendingUpdateFds_) {
+        // the channel may have been removed after its update, or replaced by a new one.
+        auto channel = getChannel(fd);
+        if (channel == nullptr || !channel->updatePending_) {
+            continue;
+        }
+
+        channel->updatePending_ = false;
+        auto events = pollEvents(channel);
+        if (events != channel->registeredEvents_ && !channel->hasNoEvent()) {
+            modifyChannel(channel, events);
+            channel->registeredEvents_ = events;
+        }
+    }
+    pendingUpdateFds_.clear();
+}
+
+void EventPoller::submitIo(EventChannel *channel, const IoRequest &request)
+{
+    eventLoop_->assertInLoopThread();
+    LOG_FATAL_IF(!supportsCompletionIo()) << "Completion based io is not supported by poller " << this << ".";
+
+    if (getChannel(channel->fd()) != channel) {
+        // a channel doing completion based io polls no event.
+        registerChannel(channel->shared_from_this());
+        channel->registeredEvents_ = enum_cast(EventType::NONE);
+        channel->updatePending_ = false;
+    }
+    prepIo(channel, request);
+}
+
+void EventPoller::prepIo(EventChannel *channel, const IoRequest &request)
+{
+    UNUSED(channel);
+    UNUSED(request);
+    LOG_SYS_FATAL << "Completion based io is not supported by poller " << this << ".";
+}
+
+uint32_t EventPoller::pollEvents(const EventChannel *channel) const
+{
+    auto events = channel->listeningEvents();
+    if (channel->isEdgeTriggered() && channel->keepWriteRegistered()) {
+        events |= enum_cast(EventType::WRITE_EVENT);
+    }
+    return events;
+}
+
+void EventPoller::removeChannel(int fd, EventChannel *channel)
 {
     eventLoop_->assertInLoopThread();
 
-    if (channels_.count(fd) == 0) {
-        LOG_WARN << "Can't find channel " << fd << " in poller " << epollFd_.get() << ".";
+    if (channel == nullptr || getChannel(fd) != channel || !channel->inPoller_) {
+        LOG_WARN << "Can't find channel " << fd << " in poller " << this << ".";
         return;
     }
 
-    epollCtl(channels_[fd], EPOLL_CTL_DEL);
-    channels_.erase(fd);
+    deleteChannel(channel, false);
+    retireChannel(fd);
+}
+
+void EventPoller::retireChannel(int fd)
+{
+    auto &channel = channels_[fd];
+    // The channel's events polled in current round are stale from now on,
+    // keep it alive until the dispatching round is done.
+    channel->inPoller_ = false;
+    retiredChannels_.push_back(std::move(channel));
 }
 } // namespace base
 } // namespace wind
@@ -22,7 +22,7 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <atomic>
 #include <vector>
 
 #include "EventChannel.h"
@@ -32,24 +32,127 @@ namespace wind {
 namespace base {
 class EventLoop;
 
+enum class PollerType {
+    EPOLL,
+    IO_URING,
+};
+
+// The EventPoller keeps the channels registered by the loop, the backend (epoll or io_uring)
+// only needs to implement the readiness notification, and optionally the completion based io.
 class EventPoller : NonCopyable {
 public:
-    explicit EventPoller(EventLoop *eventLoop);
-    ~EventPoller() noexcept;
+    // Falls back to epoll if io_uring is not supported by the running kernel.
+    static std::unique_ptr<EventPoller> create(EventLoop *eventLoop, PollerType type = PollerType::EPOLL);
+    virtual ~EventPoller() noexcept;
 
-    TimeStamp pollOnce(std::vector<std::shared_ptr<EventChannel>> &activeChannels, int timeOutMs);
+    PollerType type() const
+    {
+        return type_;
+    }
+
+    // Fill activeChannels with raw pointers of the ready channels, the poller keeps them alive
+    // until releaseRetiredChannels() is called, so the caller need not hold any reference.
+    TimeStamp pollOnce(std::vector<EventChannel *> &activeChannels, int timeOutMs);
     void updateChannel(std::shared_ptr<EventChannel> channel);
-    void removeChannel(int fd);
+    // Interest changes of a registered channel are recorded and applied to the backend once
+    // at the beginning of next pollOnce(), so toggling events back and forth in a round costs nothing.
+    void updateChannel(EventChannel *channel);
+    // Do nothing unless channel is the one registered with fd, the fd may have been taken by a new channel
+    // and the old one destroyed, so channel is not dereferenced before the check.
+    void removeChannel(int fd, EventChannel *channel);
+
+    // Completion based io, only the io_uring backend supports it, see EventChannel::submitRead().
+    virtual bool supportsCompletionIo() const
+    {
+        return false;
+    }
+    // Register the channel if it is not, and queue the request to submit with next poll.
+    void submitIo(EventChannel *channel, const IoRequest &request);
+
+    // Drop the channels removed since last call, should be called after dispatching the active channels.
+    void releaseRetiredChannels()
+    {
+        retiredChannels_.clear();
+    }
+
+    // Spin with zero-timeout polls for at most busyPollTime micro seconds before blocking,
+    // which trades cpu for wakeup latency. 0 means no busy polling (default). thread safe.
+    void setBusyPollTime(TimeType busyPollTime)
+    {
+        busyPollTime_.store(busyPollTime < 0 ? 0 : busyPollTime, std::memory_order_relaxed);
+    }
+    TimeType busyPollTime() const
+    {
+        return busyPollTime_.load(std::memory_order_relaxed);
+    }
+
+protected:
+    EventPoller(EventLoop *eventLoop, PollerType type);
 
-private:
     void assertInLoopThread();
 
-    void epollCtl(const std::shared_ptr<EventChannel> &channel, int operation);
+    // return the channel registered with fd, or nullptr.
+    EventChannel *getChannel(int fd) const
+    {
+        if (fd < 0 || static_cast<size_t>(fd) >= channels_.size()) {
+            return nullptr;
+        }
+        return channels_[fd].get();
+    }
+
+    static uint32_t listeningEvents(const EventChannel *channel)
+    {
+        return channel->listeningEvents();
+    }
+    static uint32_t registeredEvents(const EventChannel *channel)
+    {
+        return channel->registeredEvents_;
+    }
+    static void setReceivedEvents(EventChannel *channel, uint32_t events)
+    {
+        channel->setReceivedEvents(events);
+    }
+    // return true if it is the first completion of the channel in this round, which should be made active.
+    static bool setIoCompleted(EventChannel *channel, IoType type, int result, const char *data = nullptr)
+    {
+        return channel->setIoCompleted(type, result, data);
+    }
+    // the tied owner of the channel, nullptr if not tied or destroyed.
+    static std::shared_ptr<void> ownerOf(const EventChannel *channel)
+    {
+        return channel->tied_ ? channel->ownerObj_.lock() : nullptr;
+    }
+
+    // The events to register in backend for the channel.
+    virtual uint32_t pollEvents(const EventChannel *channel) const;
+
+    // Backend interfaces, all of them are called in loop thread.
+    // Wait at most timeOutMs(-1 means infinite) for ready channels and append them to activeChannels,
+    // return the count of ready channels, or -1 on error.
+    virtual int waitEvents(std::vector<EventChannel *> &activeChannels, int timeOutMs) = 0;
+    virtual void addChannel(EventChannel *channel, uint32_t events) = 0;
+    virtual void modifyChannel(EventChannel *channel, uint32_t events) = 0;
+    // @fdReused: the fd was closed and reused by a new channel before the old one removed itself.
+    virtual void deleteChannel(EventChannel *channel, bool fdReused) = 0;
+    // Queue a completion based io request of a registered channel, only if supportsCompletionIo().
+    virtual void prepIo(EventChannel *channel, const IoRequest &request);
+
     EventLoop *eventLoop_ = nullptr;
-    UniqueFd epollFd_;
-    static size_t eventSize_;
-    std::vector<epoll_event> activeEvents_; // to receive events from epoll_wait.
-    std::unordered_map<int, std::shared_ptr<EventChannel>> channels_;
+
+private:
+    void applyPendingUpdates();
+    // put the channel in the table, the channel registered with the same fd before is retired.
+    void registerChannel(std::shared_ptr<EventChannel> channel);
+    void retireChannel(int fd);
+
+    PollerType type_;
+    std::atomic<TimeType> busyPollTime_ = 0;
+    // Indexed by fd, the backend refers to the channel by raw pointer or fd,
+    // this table only holds the ownership of the registered channels.
+    std::vector<std::shared_ptr<EventChannel>> channels_;
+    // Channels removed from poller but maybe still referenced by the active channels being dispatched.
+    std::vector<std::shared_ptr<EventChannel>> retiredChannels_;
+    std::vector<int> pendingUpdateFds_;
 };
 } // namespace base
 } // namespace wind
@@ -0,0 +1,693 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "IoUringPoller.h"
+
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "Log.h"
+#include "Utils.h"
+
+namespace wind {
+namespace base {
+namespace detail {
+constexpr unsigned RING_ENTRIES = 256;
+constexpr uint32_t REQUIRED_FEATURES = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP;
+
+// user_data of a poll request is (generation << 32 | fd), requests of the poller itself use generation 0.
+constexpr int TOKEN_GENERATION_SHIFT = 32;
+constexpr uint64_t TOKEN_FD_MASK = 0xffffffff;
+// user_data of a completion based io request is (generation << 32 | 1 << 31 | type << 28 | fd), fd < 2^28.
+constexpr uint64_t IO_TOKEN_BIT = 1U << 31;
+constexpr int IO_TYPE_SHIFT = 28;
+constexpr uint64_t IO_TYPE_MASK = 0x7;
+constexpr uint64_t IO_FD_MASK = (1U << IO_TYPE_SHIFT) - 1;
+
+// the reads share a pool of buffers provided to the kernel, each read picks one when data arrives.
+constexpr uint16_t READ_BUFFER_GROUP = 1;
+constexpr uint16_t READ_BUFFER_COUNT = 64;
+constexpr size_t READ_BUFFER_SIZE = COMPLETION_READ_SIZE;
+
+int ioUringSetup(unsigned entries, io_uring_params *params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ringFd, unsigned opcode, void *arg, unsigned nrArgs)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, ringFd, opcode, arg, nrArgs));
+}
+
+// whether the kernel supports all the operations of completion based io.
+bool probeCompletionIo(int ringFd)
+{
+    constexpr uint8_t REQUIRED_OPS[] = {
+        IORING_OP_RECV,
+        IORING_OP_SEND,
+        IORING_OP_ACCEPT,
+        IORING_OP_TIMEOUT,
+        IORING_OP_ASYNC_CANCEL,
+        IORING_OP_PROVIDE_BUFFERS,
+    };
+    constexpr unsigned OPS_COUNT = IORING_OP_LAST;
+    std::vector<char> buffer(sizeof(io_uring_probe) + OPS_COUNT * sizeof(io_uring_probe_op), 0);
+    auto probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+    if (ioUringRegister(ringFd, IORING_REGISTER_PROBE, probe, OPS_COUNT) < 0) {
+        return false;
+    }
+
+    for (auto op : REQUIRED_OPS) {
+        if (op > probe->last_op || (probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace detail
+
+bool IoUringPoller::isSupported()
+{
+    static const bool supported = []() {
+        io_uring_params params{};
+        UniqueFd ringFd(detail::ioUringSetup(2, &params));
+        return ringFd.valid() && (params.features & detail::REQUIRED_FEATURES) == detail::REQUIRED_FEATURES;
+    }();
+    return supported;
+}
+
+IoUringPoller::IoUringPoller(EventLoop *eventLoop) : EventPoller(eventLoop, PollerType::IO_URING)
+{
+    setUpRing();
+}
+
+IoUringPoller::~IoUringPoller() noexcept
+{
+    cancelAllIo();
+    // closing the ring fd cancels all the pending poll requests.
+    if (sqes_ != nullptr) {
+        ::munmap(sqes_, sqesSize_);
+    }
+    if (ringPtr_ != nullptr) {
+        ::munmap(ringPtr_, ringSize_);
+    }
+}
+
+void IoUringPoller::setUpRing()
+{
+    io_uring_params params{};
+    ringFd_.reset(detail::ioUringSetup(detail::RING_ENTRIES, &params));
+    if (!ringFd_.valid()) {
+        LOG_SYS_FATAL << "io_uring_setup failed: " << strerror(errno) << ".";
+    }
+    if ((params.features & detail::REQUIRED_FEATURES) != detail::REQUIRED_FEATURES) {
+        LOG_SYS_FATAL << "io_uring features(" << params.features << ") not supported.";
+    }
+
+    ringSize_ = std::max(
+        params.sq_off.array + params.sq_entries * sizeof(unsigned),
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ringPtr_ =
+        ::mmap(nullptr, ringSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_.get(), IORING_OFF_SQ_RING);
+    if (ringPtr_ == MAP_FAILED) {
+        ringPtr_ = nullptr;
+        LOG_SYS_FATAL << "mmap io_uring rings failed: " << strerror(errno) << ".";
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes =
+        ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_.get(), IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        LOG_SYS_FATAL << "mmap io_uring sqes failed: " << strerror(errno) << ".";
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    auto ring = static_cast<char *>(ringPtr_);
+    sqHead_ = reinterpret_cast<unsigned *>(ring + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned *>(ring + params.sq_off.tail);
+    sqFlags_ = reinterpret_cast<unsigned *>(ring + params.sq_off.flags);
+    sqArray_ = reinterpret_cast<unsigned *>(ring + params.sq_off.array);
+    sqMask_ = *reinterpret_cast<unsigned *>(ring + params.sq_off.ring_mask);
+    sqEntries_ = params.sq_entries;
+    cqHead_ = reinterpret_cast<unsigned *>(ring + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned *>(ring + params.cq_off.tail);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(ring + params.cq_off.cqes);
+    cqMask_ = *reinterpret_cast<unsigned *>(ring + params.cq_off.ring_mask);
+
+    completionIo_ = detail::probeCompletionIo(ringFd_.get());
+    // the poller's own requests only post completions on failure, which would end a wait for nothing.
+    if ((params.features & IORING_FEAT_CQE_SKIP) != 0) {
+        ownSqeFlags_ = IOSQE_CQE_SKIP_SUCCESS;
+    }
+}
+
+uint32_t IoUringPoller::nextGeneration()
+{
+    if (WIND_UNLIKELY(++generation_ == 0)) {
+        ++generation_;
+    }
+    return generation_;
+}
+
+io_uring_sqe *IoUringPoller::getSqe()
+{
+    unsigned tail = *sqTail_;
+    if (tail - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_) {
+        // the submission queue is full, submit the queued requests first.
+        enter(0);
+        if (tail - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_) {
+            LOG_SYS_FATAL << "io_uring submission queue is full!";
+        }
+    }
+
+    unsigned index = tail & sqMask_;
+    io_uring_sqe *sqe = &sqes_[index];
+    utils::memZero(sqe, sizeof(*sqe));
+    sqArray_[index] = index;
+    __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+    ++toSubmit_;
+    return sqe;
+}
+
+void IoUringPoller::prepPollAdd(int fd, uint64_t token, uint32_t events)
+{
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = events;
+    sqe->user_data = token;
+}
+
+void IoUringPoller::prepPollRemove(uint64_t token)
+{
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = token;
+    sqe->flags = ownSqeFlags_;
+    sqe->user_data = 0;
+}
+
+void IoUringPoller::prepTimeout(int timeOutMs)
+{
+    if (pendingTimeout_ != 0) {
+        prepTimeoutRemove(pendingTimeout_);
+    }
+
+    timeout_.tv_sec = timeOutMs / MILLI_SECS_PER_SECOND;
+    timeout_.tv_nsec = static_cast<long long>(timeOutMs % MILLI_SECS_PER_SECOND) * NANO_SECS_PER_MILLISECOND;
+    pendingTimeout_ = nextGeneration();
+
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<uint64_t>(&timeout_);
+    sqe->len = 1;
+    sqe->user_data = pendingTimeout_;
+}
+
+void IoUringPoller::prepTimeoutRemove(uint64_t token)
+{
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = token;
+    sqe->flags = ownSqeFlags_;
+    sqe->user_data = 0;
+    pendingTimeout_ = 0;
+}
+
+int IoUringPoller::enter(unsigned minComplete)
+{
+    unsigned flags = 0;
+    // completions overflowed from the cq ring are flushed back by IORING_ENTER_GETEVENTS.
+    if (minComplete > 0 || (__atomic_load_n(sqFlags_, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW)) {
+        flags |= IORING_ENTER_GETEVENTS;
+    }
+
+    int ret = TEMP_FAILURE_RETRY(detail::ioUringEnter(ringFd_.get(), toSubmit_, minComplete, flags));
+    if (ret < 0) {
+        if (errno != EBUSY && errno != EAGAIN) {
+            LOG_WARN << "io_uring_enter error: " << strerror(errno) << ".";
+        }
+        return ret;
+    }
+
+    toSubmit_ -= std::min(static_cast<unsigned>(ret), toSubmit_);
+    return ret;
+}
+
+IoUringPoller::IoState &IoUringPoller::ioStateOf(int fd)
+{
+    if (static_cast<size_t>(fd) >= ioStates_.size()) {
+        ioStates_.resize(std::max(static_cast<size_t>(fd) + 1, ioStates_.size() * 2));
+    }
+    auto &state = ioStates_[fd];
+    if (state == nullptr) {
+        state = std::make_unique<IoState>();
+    }
+    return *state;
+}
+
+uint64_t IoUringPoller::makeIoToken(IoType type, int fd)
+{
+    return (static_cast<uint64_t>(nextGeneration()) << detail::TOKEN_GENERATION_SHIFT) | detail::IO_TOKEN_BIT |
+        (static_cast<uint64_t>(enum_cast(type)) << detail::IO_TYPE_SHIFT) | static_cast<uint32_t>(fd);
+}
+
+void IoUringPoller::prepIo(EventChannel *channel, const IoRequest &request)
+{
+    ASSERT(channel != nullptr);
+    int fd = channel->fd();
+    LOG_FATAL_IF(static_cast<uint64_t>(fd) > detail::IO_FD_MASK) << "Fd " << fd << " is too large for io_uring io.";
+
+    IoState &state = ioStateOf(fd);
+    IoOp &op = request.type == IoType::WRITE ? state.write : state.read;
+    if (op.token != 0) {
+        if (op.channel == channel && request.type != IoType::TIMEOUT) {
+            LOG_SYS_FATAL << "Channel " << fd << " has an io request(" << op.token << ") in flight already.";
+        }
+        // a timer being reset, or a request of the removed channel, which is cancelled and keeps its owner
+        // alive until its completion arrives.
+        if (op.channel != nullptr) {
+            prepCancel(op.token);
+        }
+        if (op.guard != nullptr) {
+            cancellingOps_.push_back(std::move(op));
+        }
+        op = IoOp();
+    }
+
+    if (request.type == IoType::TIMEOUT && request.expireTime == TimeStamp::invalid()) {
+        // no timer to wait for.
+        return;
+    }
+
+    op.token = makeIoToken(request.type, fd);
+    op.channel = channel;
+    switch (request.type) {
+        case IoType::READ:
+            prepRead(fd, op.token);
+            break;
+        case IoType::WRITE:
+            // the data is owned by the owner of the channel, which must outlive the request.
+            op.guard = ownerOf(channel);
+            prepSend(fd, op.token, request.data, request.len);
+            break;
+        case IoType::ACCEPT:
+            prepAccept(fd, op.token, state);
+            break;
+        case IoType::TIMEOUT:
+            prepIoTimeout(op.token, state, request.expireTime);
+            break;
+    }
+    ++inFlightIo_;
+}
+
+void IoUringPoller::prepProvideBuffers(uint16_t firstId, uint16_t count)
+{
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = count;
+    sqe->addr = reinterpret_cast<uint64_t>(readBuffers_.get() + firstId * detail::READ_BUFFER_SIZE);
+    sqe->len = detail::READ_BUFFER_SIZE;
+    sqe->off = firstId;
+    sqe->buf_group = detail::READ_BUFFER_GROUP;
+    sqe->flags = ownSqeFlags_;
+    sqe->user_data = 0;
+}
+
+void IoUringPoller::prepRead(int fd, uint64_t token)
+{
+    if (readBuffers_ == nullptr) {
+        readBuffers_ = std::make_unique<char[]>(detail::READ_BUFFER_COUNT * detail::READ_BUFFER_SIZE);
+        prepProvideBuffers(0, detail::READ_BUFFER_COUNT);
+    }
+
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->len = detail::READ_BUFFER_SIZE;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = detail::READ_BUFFER_GROUP;
+    sqe->user_data = token;
+}
+
+void IoUringPoller::prepSend(int fd, uint64_t token, const char *data, size_t len)
+{
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = static_cast<uint32_t>(std::min(len, static_cast<size_t>(UINT32_MAX)));
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = token;
+}
+
+void IoUringPoller::prepAccept(int fd, uint64_t token, IoState &state)
+{
+    state.peerAddr = sockaddr_storage{};
+    state.peerAddrLen = sizeof(state.peerAddr);
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&state.peerAddr);
+    sqe->addr2 = reinterpret_cast<uint64_t>(&state.peerAddrLen);
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->user_data = token;
+}
+
+void IoUringPoller::prepIoTimeout(uint64_t token, IoState &state, TimeStamp expireTime)
+{
+    // the kernel takes a relative timespec, at least 1us like the timerfd.
+    int64_t microSecs = std::max<int64_t>(timeDiff(expireTime, TimeStamp::now()), 1);
+    state.timeout.tv_sec = microSecs / MICRO_SECS_PER_SECOND;
+    state.timeout.tv_nsec = (microSecs % MICRO_SECS_PER_SECOND) * NANO_SECS_PER_MICROSECOND;
+
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<uint64_t>(&state.timeout);
+    sqe->len = 1;
+    sqe->user_data = token;
+}
+
+void IoUringPoller::prepCancel(uint64_t token)
+{
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = token;
+    sqe->flags = ownSqeFlags_;
+    sqe->user_data = 0;
+}
+
+void IoUringPoller::recycleReadBuffers()
+{
+    // adjacent buffers are provided by one request.
+    std::sort(usedReadBuffers_.begin(), usedReadBuffers_.end());
+    for (size_t i = 0; i < usedReadBuffers_.size();) {
+        size_t j = i + 1;
+        while (j < usedReadBuffers_.size() && usedReadBuffers_[j] == usedReadBuffers_[j - 1] + 1) {
+            ++j;
+        }
+        prepProvideBuffers(usedReadBuffers_[i], static_cast<uint16_t>(j - i));
+        i = j;
+    }
+    usedReadBuffers_.clear();
+
+    std::vector<std::pair<int, EventChannel *>> starvedReads;
+    starvedReads.swap(starvedReads_);
+    for (const auto &[fd, channel] : starvedReads) {
+        // the channel may have been removed, or have read again in the dispatching round.
+        if (getChannel(fd) == channel && ioStateOf(fd).read.token == 0) {
+            prepIo(channel, IoRequest{IoType::READ});
+        }
+    }
+}
+
+bool IoUringPoller::completeIo(const io_uring_cqe &cqe, std::vector<EventChannel *> &activeChannels)
+{
+    --inFlightIo_;
+    uint64_t token = cqe.user_data;
+    auto type = static_cast<IoType>((token >> detail::IO_TYPE_SHIFT) & detail::IO_TYPE_MASK);
+    int fd = static_cast<int>(token & detail::IO_FD_MASK);
+    IoState *state = static_cast<size_t>(fd) < ioStates_.size() ? ioStates_[fd].get() : nullptr;
+    IoOp *op = state == nullptr ? nullptr : (type == IoType::WRITE ? &state->write : &state->read);
+    if (op == nullptr || op->token != token) {
+        // completion of a replaced request.
+        auto iter = std::find_if(cancellingOps_.begin(), cancellingOps_.end(), [token](const IoOp &cancelling) {
+            return cancelling.token == token;
+        });
+        if (iter != cancellingOps_.end()) {
+            releasedGuards_.push_back(std::move(iter->guard));
+            cancellingOps_.erase(iter);
+        }
+        dropIoCompletion(type, cqe);
+        return false;
+    }
+
+    EventChannel *channel = op->channel;
+    if (op->guard != nullptr) {
+        releasedGuards_.push_back(std::move(op->guard));
+    }
+    *op = IoOp();
+    if (channel == nullptr || getChannel(fd) != channel) {
+        // completion of a removed channel.
+        dropIoCompletion(type, cqe);
+        return false;
+    }
+
+    int result = cqe.res;
+    const char *data = nullptr;
+    switch (type) {
+        case IoType::READ:
+            if (result == -ENOBUFS) {
+                starvedReads_.emplace_back(fd, channel);
+                return false;
+            }
+            if ((cqe.flags & IORING_CQE_F_BUFFER) != 0) {
+                auto bufferId = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                usedReadBuffers_.push_back(bufferId);
+                data = readBuffers_.get() + bufferId * detail::READ_BUFFER_SIZE;
+            }
+            break;
+        case IoType::ACCEPT:
+            data = reinterpret_cast<const char *>(&state->peerAddr);
+            break;
+        case IoType::TIMEOUT:
+            // the timeout request completes with -ETIME when it expires.
+            if (result == -ETIME) {
+                result = 0;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (setIoCompleted(channel, type, result, data)) {
+        activeChannels.push_back(channel);
+        return true;
+    }
+    return false;
+}
+
+void IoUringPoller::dropIoCompletion(IoType type, const io_uring_cqe &cqe)
+{
+    if ((cqe.flags & IORING_CQE_F_BUFFER) != 0) {
+        usedReadBuffers_.push_back(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+    }
+    if (type == IoType::ACCEPT && cqe.res >= 0) {
+        ::close(cqe.res);
+    }
+}
+
+void IoUringPoller::cancelAllIo()
+{
+    for (auto &state : ioStates_) {
+        if (state == nullptr) {
+            continue;
+        }
+        for (IoOp *op : {&state->read, &state->write}) {
+            if (op->token != 0 && op->channel != nullptr) {
+                prepCancel(op->token);
+                op->channel = nullptr;
+            }
+        }
+    }
+
+    std::vector<EventChannel *> activeChannels;
+    while (inFlightIo_ > 0) {
+        if (enter(1) < 0 && errno != EBUSY && errno != EAGAIN) {
+            break;
+        }
+        reapCompletions(activeChannels);
+        activeChannels.clear();
+    }
+    releasedGuards_.clear();
+    cancellingOps_.clear();
+}
+
+void IoUringPoller::rearmPolls()
+{
+    for (int fd : rearmFds_) {
+        auto channel = getChannel(fd);
+        if (channel == nullptr || static_cast<size_t>(fd) >= pollStates_.size()) {
+            continue;
+        }
+
+        // the channel may have been modified or removed in the dispatching round.
+        auto &state = pollStates_[fd];
+        if (state.token != 0 && !state.armed) {
+            prepPollAdd(fd, state.token, registeredEvents(channel));
+            state.armed = true;
+        }
+    }
+    rearmFds_.clear();
+}
+
+int IoUringPoller::waitEvents(std::vector<EventChannel *> &activeChannels, int timeOutMs)
+{
+    // the channels of last round are dispatched, their completions are not referenced any more.
+    releasedGuards_.clear();
+    recycleReadBuffers();
+    rearmPolls();
+
+    bool timeoutArmed = false;
+    int cnt = 0;
+    do {
+        unsigned minComplete = 0;
+        bool hasCompletions = *cqHead_ != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        if (timeOutMs != 0 && !hasCompletions) {
+            if (timeOutMs > 0 && !timeoutArmed) {
+                prepTimeout(timeOutMs);
+                timeoutArmed = true;
+            }
+            minComplete = 1;
+        }
+
+        if (toSubmit_ > 0 || minComplete > 0 ||
+            (__atomic_load_n(sqFlags_, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW)) {
+            if (enter(minComplete) < 0 && errno != EBUSY && errno != EAGAIN) {
+                return -1;
+            }
+        }
+
+        cnt = reapCompletions(activeChannels);
+        // only the completions of the poller's own or stale requests arrived, keep waiting until the timeout.
+    } while (cnt == 0 && timeOutMs != 0 && !(timeoutArmed && pendingTimeout_ == 0));
+    return cnt;
+}
+
+int IoUringPoller::reapCompletions(std::vector<EventChannel *> &activeChannels)
+{
+    int cnt = 0;
+    unsigned head = *cqHead_;
+    unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+        const io_uring_cqe &cqe = cqes_[head & cqMask_];
+        uint64_t token = cqe.user_data;
+        if ((token >> detail::TOKEN_GENERATION_SHIFT) == 0) {
+            // completion of the poller's own request.
+            if (token == pendingTimeout_) {
+                pendingTimeout_ = 0;
+            }
+            continue;
+        }
+        if ((token & detail::IO_TOKEN_BIT) != 0) {
+            if (completeIo(cqe, activeChannels)) {
+                ++cnt;
+            }
+            continue;
+        }
+
+        int fd = static_cast<int>(token & detail::TOKEN_FD_MASK);
+        auto channel = getChannel(fd);
+        if (channel == nullptr || static_cast<size_t>(fd) >= pollStates_.size() || pollStates_[fd].token != token ||
+            !pollStates_[fd].armed) {
+            // stale completion of a removed or replaced poll request.
+            continue;
+        }
+
+        pollStates_[fd].armed = false;
+        rearmFds_.push_back(fd);
+        setReceivedEvents(channel, cqe.res < 0 ? static_cast<uint32_t>(EPOLLERR) : static_cast<uint32_t>(cqe.res));
+        activeChannels.push_back(channel);
+        ++cnt;
+    }
+    __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+
+    if (cnt > 0 && pendingTimeout_ != 0) {
+        prepTimeoutRemove(pendingTimeout_);
+    }
+    return cnt;
+}
+
+uint32_t IoUringPoller::pollEvents(const EventChannel *channel) const
+{
+    // one-shot poll request is always level triggered, so EPOLLOUT can not be kept registered.
+    return listeningEvents(channel) & ~static_cast<uint32_t>(EPOLLET | EPOLLONESHOT);
+}
+
+void IoUringPoller::addChannel(EventChannel *channel, uint32_t events)
+{
+    ASSERT(channel != nullptr);
+    int fd = channel->fd();
+    if (static_cast<size_t>(fd) >= pollStates_.size()) {
+        pollStates_.resize(std::max(static_cast<size_t>(fd) + 1, pollStates_.size() * 2));
+    }
+
+    auto &state = pollStates_[fd];
+    state.token = (static_cast<uint64_t>(nextGeneration()) << detail::TOKEN_GENERATION_SHIFT) | static_cast<uint32_t>(fd);
+    prepPollAdd(fd, state.token, events);
+    state.armed = true;
+}
+
+void IoUringPoller::modifyChannel(EventChannel *channel, uint32_t events)
+{
+    ASSERT(channel != nullptr);
+    if (static_cast<size_t>(channel->fd()) >= pollStates_.size()) {
+        // registered by a completion based io request, polling nothing yet.
+        addChannel(channel, events);
+        return;
+    }
+    auto &state = pollStates_[channel->fd()];
+    if (state.armed) {
+        prepPollRemove(state.token);
+        state.armed = false;
+    }
+    addChannel(channel, events);
+}
+
+void IoUringPoller::deleteChannel(EventChannel *channel, bool fdReused)
+{
+    UNUSED(fdReused); // the requests of a closed fd are still pending, cancel them anyway.
+    ASSERT(channel != nullptr);
+    int fd = channel->fd();
+    if (static_cast<size_t>(fd) < pollStates_.size()) {
+        auto &state = pollStates_[fd];
+        if (state.armed) {
+            prepPollRemove(state.token);
+        }
+        state = PollState();
+    }
+
+    if (static_cast<size_t>(fd) < ioStates_.size() && ioStates_[fd] != nullptr) {
+        // the completions are dropped, the owner of a write is released when its completion arrives.
+        for (IoOp *op : {&ioStates_[fd]->read, &ioStates_[fd]->write}) {
+            if (op->token != 0 && op->channel == channel) {
+                prepCancel(op->token);
+                op->channel = nullptr;
+            }
+        }
+    }
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,150 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+#include <memory>
+
+#include "EventPoller.h"
+
+namespace wind {
+namespace base {
+// An io_uring backed poller: every channel is watched by a one-shot IORING_OP_POLL_ADD request
+// which is re-armed after dispatching, so the channels keep the level triggered semantic of epoll.
+// All the poll requests (add, re-arm, remove) queued in a loop iteration are submitted
+// together with the wait by a single io_uring_enter().
+// If the kernel supports the operations, it also does completion based io: the reads, writes, accepts and timeouts
+// of the channels are submitted in the same io_uring_enter() as well, and their completions are dispatched to the
+// channels' callbacks, so serving a request costs no syscall of its own. The reads pick buffers from a pool provided
+// to the kernel, so an idle connection holds no buffer.
+class IoUringPoller : public EventPoller {
+public:
+    explicit IoUringPoller(EventLoop *eventLoop);
+    ~IoUringPoller() noexcept override;
+
+    // whether the running kernel supports the io_uring features this poller needs.
+    static bool isSupported();
+
+    bool supportsCompletionIo() const override
+    {
+        return completionIo_;
+    }
+
+protected:
+    int waitEvents(std::vector<EventChannel *> &activeChannels, int timeOutMs) override;
+    uint32_t pollEvents(const EventChannel *channel) const override;
+    void addChannel(EventChannel *channel, uint32_t events) override;
+    void modifyChannel(EventChannel *channel, uint32_t events) override;
+    void deleteChannel(EventChannel *channel, bool fdReused) override;
+    void prepIo(EventChannel *channel, const IoRequest &request) override;
+
+private:
+    struct PollState {
+        uint64_t token = 0; // user_data of the poll request, 0 means not registered.
+        bool armed = false; // whether the poll request is pending in the kernel.
+    };
+
+    // A completion based io request in the kernel.
+    struct IoOp {
+        uint64_t token = 0;              // user_data of the request, 0 means none.
+        EventChannel *channel = nullptr; // nullptr once the channel is removed and the request is cancelled.
+        std::shared_ptr<void> guard;     // the tied owner of the data written, kept alive until completion.
+    };
+    // The requests of an fd, allocated once and never moved since the kernel writes the accepted address here.
+    struct IoState {
+        IoOp read; // read, accept or timeout.
+        IoOp write;
+        sockaddr_storage peerAddr{};
+        socklen_t peerAddrLen = 0;
+        __kernel_timespec timeout{};
+    };
+
+    void setUpRing();
+    io_uring_sqe *getSqe();
+    void prepPollAdd(int fd, uint64_t token, uint32_t events);
+    void prepPollRemove(uint64_t token);
+    void prepTimeout(int timeOutMs);
+    void prepTimeoutRemove(uint64_t token);
+    void rearmPolls();
+    int enter(unsigned minComplete);
+    int reapCompletions(std::vector<EventChannel *> &activeChannels);
+    uint32_t nextGeneration();
+
+    IoState &ioStateOf(int fd);
+    uint64_t makeIoToken(IoType type, int fd);
+    void prepProvideBuffers(uint16_t firstId, uint16_t count);
+    void prepRead(int fd, uint64_t token);
+    void prepSend(int fd, uint64_t token, const char *data, size_t len);
+    void prepAccept(int fd, uint64_t token, IoState &state);
+    void prepIoTimeout(uint64_t token, IoState &state, TimeStamp expireTime);
+    void prepCancel(uint64_t token);
+    // provide the buffers picked by the reads of last round back to the kernel, and retry the reads
+    // which found no buffer, should be called after the channels are dispatched.
+    void recycleReadBuffers();
+    // return true if the channel of the completed request becomes active.
+    bool completeIo(const io_uring_cqe &cqe, std::vector<EventChannel *> &activeChannels);
+    // release what a completion of a removed channel or a replaced request holds.
+    void dropIoCompletion(IoType type, const io_uring_cqe &cqe);
+    // cancel the requests in flight and wait for them, the kernel writes to the buffers until they complete.
+    void cancelAllIo();
+
+    UniqueFd ringFd_;
+    void *ringPtr_ = nullptr; // sq ring and cq ring share one mapping.
+    size_t ringSize_ = 0;
+    io_uring_sqe *sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    unsigned *sqHead_ = nullptr;
+    unsigned *sqTail_ = nullptr;
+    unsigned *sqFlags_ = nullptr;
+    unsigned *sqArray_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned sqEntries_ = 0;
+    unsigned *cqHead_ = nullptr;
+    unsigned *cqTail_ = nullptr;
+    io_uring_cqe *cqes_ = nullptr;
+    unsigned cqMask_ = 0;
+
+    unsigned toSubmit_ = 0;
+    uint32_t generation_ = 0;
+    uint64_t pendingTimeout_ = 0; // token of the timeout request pending in the kernel.
+    __kernel_timespec timeout_{};
+    std::vector<PollState> pollStates_; // indexed by fd.
+    std::vector<int> rearmFds_;         // fds whose one-shot poll request fired in last round.
+
+    bool completionIo_ = false;
+    uint8_t ownSqeFlags_ = 0; // IOSQE_CQE_SKIP_SUCCESS if supported, for the requests with user_data 0.
+    size_t inFlightIo_ = 0;                          // completion based io requests not completed yet.
+    std::vector<std::unique_ptr<IoState>> ioStates_; // indexed by fd.
+    // requests replaced while being cancelled, until their completions arrive.
+    std::vector<IoOp> cancellingOps_;
+    // dropped before next poll, the owners may be destroyed only after the dispatching.
+    std::vector<std::shared_ptr<void>> releasedGuards_;
+    std::unique_ptr<char[]> readBuffers_;                     // allocated by the first read.
+    std::vector<uint16_t> usedReadBuffers_;                   // picked by the reads of last round.
+    std::vector<std::pair<int, EventChannel *>> starvedReads_; // the reads found no buffer in last round.
+};
+} // namespace base
+} // namespace wind
@@ -22,6 +22,7 @@
 
 #include "Log.h"
 
+#include <iterator>
 #include <unordered_map>
 
 #include "CurrentThread.h"
@@ -39,24 +40,6 @@ inline LogLevel defaultLogLevel()
 #endif
 }
 
-inline std::string logLevelToString(LogLevel level)
-{
-    switch (level) {
-        case LogLevel::TRACE:
-            return "TRACE";
-        case LogLevel::DEBUG:
-            return "DEBUG";
-        case LogLevel::INFO:
-            return "INFO";
-        case LogLevel::WARN:
-            return "WARN";
-        case LogLevel::ERROR:
-            return "ERROR";
-        default:
-            return "UNKNOWN";
-    }
-}
-
 inline LogLevel getLogLevelFromEnv()
 {
     static std::unordered_map<std::string, LogLevel> stringToLogLevelMap = {
@@ -83,8 +66,22 @@ inline LogLevel getLogLevelFromEnv()
 }
 
 LogLevel g_logLevel = getLogLevelFromEnv();
+
+// indexed by LogLevel.
+constexpr std::string_view LOG_LEVEL_NAMES[] = {"UNKNOWN", "TRACE", "DEBUG", "INFO", "WARN", "ERROR"};
+
+inline std::string_view logLevelView(LogLevel level)
+{
+    auto index = static_cast<size_t>(level);
+    return index < std::size(LOG_LEVEL_NAMES) ? LOG_LEVEL_NAMES[index] : LOG_LEVEL_NAMES[0];
+}
 } // namespace detail
 
+const char *logLevelName(LogLevel level)
+{
+    return detail::logLevelView(level).data();
+}
+
 LogLevel Logger::currentLogLevel()
 {
     return detail::g_logLevel;
@@ -95,11 +92,14 @@ void Logger::setLogLevel(LogLevel level)
     detail::g_logLevel = level;
 }
 
-Logger::Logger(SourceFileName fileName, int line, LogLevel level, std::string tag, bool isFatal)
+Logger::Logger(SourceFileName fileName, int line, LogLevel level, std::string_view tag, bool isFatal)
     : fileName_(fileName), line_(line), isFatal_(isFatal)
 {
-    stream_ << TimeStamp::now().toFormattedString() << " " << CurrentThread::pidString() << " "
-            << CurrentThread::tidString() << " " << tag << " " << detail::logLevelToString(level) << ": ";
+    char timeBuf[MAX_TIME_STRING_SIZE];
+    size_t timeLen = TimeStamp::now().toFormattedString(timeBuf, sizeof(timeBuf));
+    stream_.append(timeBuf, timeLen);
+    stream_ << " " << CurrentThread::pidString() << " " << CurrentThread::tidString() << " " << tag << " "
+            << detail::logLevelView(level) << ": ";
 }
 
 Logger::~Logger() noexcept
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "LogStream.h"
 
 // If you want to define your custom log tag,
@@ -34,6 +36,16 @@
 #define LOG_TAG "Wind"
 #endif // LOG_TAG
 
+// The LOG_* and LOG_BIN_* statements of the levels below WIND_LOG_MIN_LEVEL are compiled away, whatever the level
+// at runtime is, ERROR is always kept. It is 1 by default, so TRACE and all the levels above are kept.
+// 1: TRACE, 2: DEBUG, 3: INFO, 4: WARN, 5: ERROR.
+// -------------------------------------------
+//      -DWIND_LOG_MIN_LEVEL=3
+// -------------------------------------------
+#ifndef WIND_LOG_MIN_LEVEL
+#define WIND_LOG_MIN_LEVEL 1
+#endif // WIND_LOG_MIN_LEVEL
+
 namespace wind {
 namespace base {
 enum class LogLevel {
@@ -44,48 +56,46 @@ enum class LogLevel {
     ERROR,
 };
 
+// "TRACE", "DEBUG" and so on.
+const char *logLevelName(LogLevel level);
+
+// The base name of a source file, pointing into the path without copying.
 class SourceFileName {
 public:
     // not explicit because we use its implicit constructor.
-    SourceFileName(const char *s)
-    {
-        size_t len = ::strlen(s);
-        append(s, len);
-    }
-    // not explicit, too.
-    template <size_t len>
-    SourceFileName(const char (&s)[len])
+    template <size_t N>
+    constexpr SourceFileName(const char (&path)[N]) : SourceFileName(path, baseNameOffset(path))
+    {}
+    // the offset is resolved already, see WIND_SOURCE_FILE_NAME.
+    template <size_t N>
+    constexpr SourceFileName(const char (&path)[N], size_t offset) : data_(path + offset), len_(N - 1 - offset)
+    {}
+
+    // "wind/base/Log.cpp" --> 10, the offset of "Log.cpp".
+    template <size_t N>
+    static constexpr size_t baseNameOffset(const char (&path)[N])
     {
-        append(s, len);
+        for (size_t i = N - 1; i > 0; --i) {
+            if (path[i - 1] == '/') {
+                return i;
+            }
+        }
+        return 0;
     }
-    ~SourceFileName() noexcept = default;
 
-    const char *data() const
+    constexpr const char *data() const
     {
-        return buf_;
+        return data_;
     }
 
-    size_t length() const
+    constexpr size_t length() const
     {
         return len_;
     }
 
 private:
-    void append(const char *data, size_t len)
-    {
-        const char *p = ::strrchr(data, '/') + 1;
-        if (WIND_UNLIKELY(p == nullptr)) {
-            return;
-        }
-
-        size_t bytesToWrite = len - (p - data);
-        ASSERT(sizeof(buf_) > bytesToWrite);
-        ::memcpy(buf_, p, bytesToWrite);
-        len_ = bytesToWrite;
-    }
-
-    char buf_[256] = {0};
-    size_t len_ = 0;
+    const char *data_;
+    size_t len_;
 };
 
 class Logger : NonCopyable {
@@ -100,7 +110,8 @@ public:
     static LogLevel currentLogLevel();
     static void setLogLevel(LogLevel level);
 
-    Logger(SourceFileName fileName, int line, LogLevel level, std::string tag = LOG_TAG, bool isFatal = false);
+    // Nothing is allocated: the file name and tag point to the literals.
+    Logger(SourceFileName fileName, int line, LogLevel level, std::string_view tag = LOG_TAG, bool isFatal = false);
     ~Logger() noexcept;
     LogStream &stream()
     {
@@ -116,20 +127,30 @@ private:
 } // namespace base
 } // namespace wind
 
+// The base name of the current source file, the directories are stripped at compile time.
+#define WIND_SOURCE_FILE_NAME                                                                                          \
+    wind::base::SourceFileName(                                                                                        \
+        __FILE__, std::integral_constant<size_t, wind::base::SourceFileName::baseNameOffset(__FILE__)>::value)
+
 #define LOG_TRACE                                                                                                      \
+    if constexpr (WIND_LOG_MIN_LEVEL <= 1)                                                                             \
     if (wind::base::Logger::currentLogLevel() <= wind::base::LogLevel::TRACE)                                          \
-    wind::base::Logger(__FILE__, __LINE__, wind::base::LogLevel::TRACE, LOG_TAG).stream()
+    wind::base::Logger(WIND_SOURCE_FILE_NAME, __LINE__, wind::base::LogLevel::TRACE, LOG_TAG).stream()
 #define LOG_DEBUG                                                                                                      \
+    if constexpr (WIND_LOG_MIN_LEVEL <= 2)                                                                             \
     if (wind::base::Logger::currentLogLevel() <= wind::base::LogLevel::DEBUG)                                          \
-    wind::base::Logger(__FILE__, __LINE__, wind::base::LogLevel::DEBUG, LOG_TAG).stream()
+    wind::base::Logger(WIND_SOURCE_FILE_NAME, __LINE__, wind::base::LogLevel::DEBUG, LOG_TAG).stream()
 #define LOG_INFO                                                                                                       \
+    if constexpr (WIND_LOG_MIN_LEVEL <= 3)                                                                             \
     if (wind::base::Logger::currentLogLevel() <= wind::base::LogLevel::INFO)                                           \
-    wind::base::Logger(__FILE__, __LINE__, wind::base::LogLevel::INFO, LOG_TAG).stream()
+    wind::base::Logger(WIND_SOURCE_FILE_NAME, __LINE__, wind::base::LogLevel::INFO, LOG_TAG).stream()
 #define LOG_WARN                                                                                                       \
+    if constexpr (WIND_LOG_MIN_LEVEL <= 4)                                                                             \
     if (wind::base::Logger::currentLogLevel() <= wind::base::LogLevel::WARN)                                           \
-    wind::base::Logger(__FILE__, __LINE__, wind::base::LogLevel::WARN, LOG_TAG).stream()
-#define LOG_ERROR wind::base::Logger(__FILE__, __LINE__, wind::base::LogLevel::ERROR, LOG_TAG).stream()
-#define LOG_SYS_FATAL wind::base::Logger(__FILE__, __LINE__, wind::base::LogLevel::ERROR, LOG_TAG, true).stream()
+    wind::base::Logger(WIND_SOURCE_FILE_NAME, __LINE__, wind::base::LogLevel::WARN, LOG_TAG).stream()
+#define LOG_ERROR wind::base::Logger(WIND_SOURCE_FILE_NAME, __LINE__, wind::base::LogLevel::ERROR, LOG_TAG).stream()
+#define LOG_SYS_FATAL                                                                                                  \
+    wind::base::Logger(WIND_SOURCE_FILE_NAME, __LINE__, wind::base::LogLevel::ERROR, LOG_TAG, true).stream()
 #define LOG_FATAL_IF(expr)                                                                                             \
     if ((expr))                                                                                                        \
-    wind::base::Logger(__FILE__, __LINE__, wind::base::LogLevel::ERROR, LOG_TAG, true).stream()
+    wind::base::Logger(WIND_SOURCE_FILE_NAME, __LINE__, wind::base::LogLevel::ERROR, LOG_TAG, true).stream()
@@ -22,35 +22,67 @@
 
 #include "LogDaemon.h"
 
+#include <queue>
 #include <sstream>
 
+#include "BinaryLog.h"
 #include "TimeStamp.h"
 
 namespace wind {
 namespace base {
 namespace fs = std::filesystem;
 
-LogDaemon::LogDaemon(std::string baseName, std::string logDir, FileSize rollSize, uint32_t flushInterval)
-    : baseName_(std::move(baseName)),
+namespace detail {
+constexpr TimeType FLUSH_WAIT_TIME = MICRO_SECS_PER_SECOND;
+constexpr uint32_t TEXT_RECORD = 0;
+constexpr uint32_t BINARY_RECORD = 1;
+
+std::atomic<uint64_t> nextLogDaemonId = 1;
+
+// the ring of the current thread, released to the daemon when the thread exits.
+struct ThreadLogRing {
+    uint64_t daemonId = 0;
+    std::shared_ptr<LogRingBuffer> ring;
+};
+thread_local ThreadLogRing t_logRing;
+} // namespace detail
+
+LogDaemon::LogDaemon(
+    std::string baseName,
+    std::string logDir,
+    FileSize rollSize,
+    uint32_t flushInterval,
+    size_t threadBufferSize)
+    : id_(detail::nextLogDaemonId.fetch_add(1)),
+      baseName_(std::move(baseName)),
       logDir_(std::move(logDir)),
-      file_(std::make_unique<LogFile>(generateLogFileName())),
       rollSize_(rollSize),
       flushInterval_(flushInterval),
-      frontBuffer_(std::make_unique<LogBuffer>()),
-      reservedBuffer_(std::make_unique<LogBuffer>())
+      threadBufferSize_(threadBufferSize)
 {
     if (!fs::is_directory(logDir_)) {
         logDir_ = logDir_.parent_path();
     }
+    // opened before taking over the output, so that a failure of opening is printed.
+    openLogFile();
 
     LogStream::setOutputFunc([this](const char *data, size_t len) { append(data, len); });
     LogStream::setFlushFunc([this]() { flush(); });
+    BinaryLogRecord::setOutputFunc(
+        [this](const char *record, size_t len) { appendRecord(record, len, detail::BINARY_RECORD); });
 }
 
 LogDaemon::~LogDaemon() noexcept
 {
-    running_ = false;
-    cond_.notify_one();
+    // the outputs capture this, restore the defaults before it goes away.
+    LogStream::setOutputFunc(nullptr);
+    LogStream::setFlushFunc(nullptr);
+    BinaryLogRecord::setOutputFunc(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        cond_.notify_one();
+    }
     if (thread_.joinable()) {
         thread_.join();
     }
@@ -60,7 +92,7 @@ std::string LogDaemon::generateLogFileName()
 {
     // BaseName
     std::stringstream ss;
-    ss << logDir_.append(baseName_).string();
+    ss << (logDir_ / baseName_).string();
 
     // TimeStamp
     TimeType microSecondsSinceEpoch = TimeStamp::now().get();
@@ -80,6 +112,40 @@ std::string LogDaemon::generateLogFileName()
     return ss.str();
 }
 
+void LogDaemon::openLogFile()
+{
+    // rolled again within the same second, the name is taken already.
+    std::string fileName = generateLogFileName();
+    std::string candidate = fileName;
+    for (int index = 1; fs::exists(candidate); ++index) {
+        candidate = fileName + "." + std::to_string(index);
+    }
+
+    file_ = std::make_unique<LogFile>(candidate, syncPolicy_);
+    if (directIo_) {
+        (void)file_->setDirectIo(true);
+    }
+}
+
+void LogDaemon::assertIsNotRunning() const
+{
+    LOG_FATAL_IF(running_) << "LogDaemon(baseName: " << baseName_ << ") is already started!";
+}
+
+void LogDaemon::setSyncPolicy(LogSyncPolicy policy)
+{
+    assertIsNotRunning();
+    syncPolicy_ = policy;
+    file_->setSyncPolicy(policy);
+}
+
+void LogDaemon::setDirectIo(bool on)
+{
+    assertIsNotRunning();
+    directIo_ = on;
+    (void)file_->setDirectIo(on);
+}
+
 void LogDaemon::start()
 {
     if (running_) {
@@ -92,84 +158,215 @@ void LogDaemon::start()
 
 void LogDaemon::threadMain()
 {
-    std::vector<LogBufferPtr> buffersToWrite;
-    LogBufferPtr tmpBuffer1 = std::make_unique<LogBuffer>();
-    LogBufferPtr tmpBuffer2 = std::make_unique<LogBuffer>();
-    while (running_ || frontBuffer_->length() > 0) {
+    daemonTid_ = CurrentThread::tid();
+    buffer_ = std::make_unique<LogBuffer>();
+    while (true) {
         {
             std::unique_lock<std::mutex> lock(mutex_);
-            if (stagingBuffers_.empty()) {
-                cond_.wait_for(lock, std::chrono::seconds(flushInterval_), [this]() {
-                    return !stagingBuffers_.empty() || !running_;
-                });
-            }
-            if (stagingBuffers_.empty() || !running_) {
-                stagingBuffers_.push_back(std::move(frontBuffer_));
-                frontBuffer_ = std::move(tmpBuffer1);
-            }
-
-            buffersToWrite.swap(stagingBuffers_);
-            ASSERT(!buffersToWrite.empty());
+            cond_.wait_for(lock, std::chrono::seconds(flushInterval_), [this]() {
+                return harvestRequested_.load() || !running_;
+            });
         }
 
-        for (const auto &buf : buffersToWrite) {
-            file_->write(buf->data(), buf->length());
-            if (file_->size() >= rollSize_) {
-                file_ = std::make_unique<LogFile>(generateLogFileName());
-            }
+        // the lines written before stopping are harvested at last.
+        bool stopping = !running_;
+        harvestRequested_ = false;
+        harvest();
+        if (roomWaiters_ > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            roomCond_.notify_all();
+        }
+        if (stopping) {
+            break;
         }
+    }
+}
 
-        if (buffersToWrite.size() > 2) {
-            buffersToWrite.resize(2); // shrink
+void LogDaemon::harvest()
+{
+    std::vector<LogRingPtr> rings;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings = rings_;
+    }
+
+    // Merge the rings by time, the lines written after the cutoff are left to the next harvest, so the ones
+    // written later by a thread never go before the ones written earlier by others.
+    uint64_t cutoff = utils::monotonicNanos();
+    using RingHead = std::pair<uint64_t, size_t>; // time of the oldest record, index of the ring.
+    std::priority_queue<RingHead, std::vector<RingHead>, std::greater<RingHead>> heads;
+    std::vector<LogRingBuffer::Record> records(rings.size());
+    for (size_t i = 0; i < rings.size(); ++i) {
+        if (rings[i]->peek(records[i]) && records[i].time <= cutoff) {
+            heads.emplace(records[i].time, i);
         }
+    }
 
-        if (tmpBuffer1 == nullptr) {
-            tmpBuffer1 = std::move(buffersToWrite.back());
-            buffersToWrite.pop_back();
-            tmpBuffer1->clean();
+    bool written = !heads.empty();
+    while (!heads.empty()) {
+        size_t i = heads.top().second;
+        heads.pop();
+
+        auto &record = records[i];
+        writeRecord(record);
+        rings[i]->pop(record);
+
+        if (rings[i]->peek(record) && record.time <= cutoff) {
+            heads.emplace(record.time, i);
         }
+    }
+    stageBuffer();
+    writeStaged();
+    if (written) {
+        file_->flush();
+    }
 
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (reservedBuffer_ == nullptr) {
-                reservedBuffer_ = std::move(tmpBuffer2);
-                reservedBuffer_->clean();
+    // release the rings of the exited threads once they are drained.
+    rings.clear();
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    for (auto iter = rings_.begin(); iter != rings_.end();) {
+        if (iter->use_count() == 1) {
+            // pairs with the release of the exited thread's reference, all its lines are visible then.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((*iter)->empty()) {
+                iter = rings_.erase(iter);
+                continue;
             }
         }
+        ++iter;
+    }
+}
 
-        if (tmpBuffer2 == nullptr) {
-            if (buffersToWrite.empty()) {
-                tmpBuffer2 = std::make_unique<LogBuffer>();
-            } else {
-                tmpBuffer2 = std::move(buffersToWrite.back());
-                buffersToWrite.pop_back();
-                tmpBuffer2->clean();
-            }
+void LogDaemon::writeRecord(const LogRingBuffer::Record &record)
+{
+    if (record.flags == detail::BINARY_RECORD) {
+        if (buffer_->available() <= MAX_BINARY_LOG_LINE_SIZE) {
+            stageBuffer();
         }
+        size_t len = BinaryLogRecord::format(record.data, record.len, buffer_->curr(), MAX_BINARY_LOG_LINE_SIZE);
+        buffer_->grow(len);
+        return;
+    }
+
+    if (buffer_->available() <= record.len) {
+        stageBuffer();
+    }
+    if (buffer_->available() <= record.len) {
+        // larger than a buffer, written from the ring directly.
+        writeStaged(record.data, record.len);
+    } else {
+        buffer_->append(record.data, record.len);
+    }
+}
+
+void LogDaemon::stageBuffer()
+{
+    if (buffer_->length() == 0) {
+        return;
+    }
+
+    stagedBuffers_.push_back(std::move(buffer_));
+    if (spareBuffers_.empty()) {
+        buffer_ = std::make_unique<LogBuffer>();
+    } else {
+        buffer_ = std::move(spareBuffers_.back());
+        spareBuffers_.pop_back();
+    }
+    if (stagedBuffers_.size() >= MAX_STAGED_BUFFERS) {
+        writeStaged();
+    }
+}
+
+void LogDaemon::writeStaged(const char *extra, size_t extraLen)
+{
+    struct iovec vecs[MAX_STAGED_BUFFERS + 1];
+    size_t count = 0;
+    for (auto &buffer : stagedBuffers_) {
+        vecs[count++] = {const_cast<char *>(buffer->data()), buffer->length()};
+    }
+    if (extraLen > 0) {
+        vecs[count++] = {const_cast<char *>(extra), extraLen};
+    }
+    if (count == 0) {
+        return;
+    }
+
+    file_->write(vecs, count);
+    for (auto &buffer : stagedBuffers_) {
+        buffer->reset();
+        spareBuffers_.push_back(std::move(buffer));
+    }
+    stagedBuffers_.clear();
+    if (file_->size() >= rollSize_) {
+        openLogFile();
     }
 }
 
+LogRingBuffer *LogDaemon::currentThreadRing()
+{
+    auto &threadRing = detail::t_logRing;
+    if (WIND_UNLIKELY(threadRing.daemonId != id_)) {
+        threadRing.daemonId = id_;
+        threadRing.ring = std::make_shared<LogRingBuffer>(threadBufferSize_);
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings_.push_back(threadRing.ring);
+    }
+    return threadRing.ring.get();
+}
+
 void LogDaemon::append(const char *data, size_t len)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    appendRecord(data, len, detail::TEXT_RECORD);
+}
 
-    if (frontBuffer_->available() < len) {
-        stagingBuffers_.push_back(std::move(frontBuffer_));
-        if (reservedBuffer_ != nullptr) {
-            frontBuffer_ = std::move(reservedBuffer_);
-        } else {
-            frontBuffer_ = std::make_unique<LogBuffer>();
+void LogDaemon::appendRecord(const char *data, size_t len, uint32_t flags)
+{
+    LogRingBuffer *ring = currentThreadRing();
+    uint64_t time = utils::monotonicNanos();
+    while (!ring->tryAppend(time, data, len, flags)) {
+        // nobody will make room: not started or stopped, or the background thread logs by itself.
+        if (!running_ || CurrentThread::tid() == daemonTid_.load(std::memory_order_relaxed)) {
+            droppedCount_.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
-        cond_.notify_one();
+        requestHarvest();
+        // the timeout covers a notification missed for reading roomWaiters_ without the lock.
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++roomWaiters_;
+        roomCond_.wait_for(lock, std::chrono::milliseconds(1));
+        --roomWaiters_;
     }
 
-    frontBuffer_->append(data, len);
+    if (ring->size() > ring->capacity() / 2) {
+        requestHarvest();
+    }
 }
 
-void LogDaemon::flush()
+void LogDaemon::requestHarvest()
 {
+    if (harvestRequested_.load(std::memory_order_relaxed) || harvestRequested_.exchange(true)) {
+        return;
+    }
+
+    // under the lock, or the notification may be lost before the background thread waits.
     std::lock_guard<std::mutex> lock(mutex_);
     cond_.notify_one();
 }
+
+void LogDaemon::flush()
+{
+    requestHarvest();
+    if (!running_ || CurrentThread::tid() == daemonTid_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // wait for the lines of this thread, a fatal line must be written before abort().
+    LogRingBuffer *ring = currentThreadRing();
+    uint64_t deadline = utils::monotonicNanos() + detail::FLUSH_WAIT_TIME * NANO_SECS_PER_MICROSECOND;
+    while (!ring->empty() && utils::monotonicNanos() < deadline) {
+        requestHarvest();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
 } // namespace base
 } // namespace wind
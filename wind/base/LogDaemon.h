@@ -29,54 +29,106 @@
 #include <vector>
 
 #include "LogFile.h"
+#include "LogRingBuffer.h"
 #include "Thread.h"
 
 namespace wind {
 namespace base {
 // Async logging, will be running at background thread.
+// Every logging thread appends to its own ring buffer without locking, the background thread harvests the
+// rings and merges the lines by the time they were written, so the lines of a thread keep their order and
+// the lines written out together are in global order. The binary logs (see BinaryLog.h) are formatted by the
+// background thread too. The buffers filled by a harvest are written to the file by one writev(2).
 class LogDaemon : NonCopyable {
     using LogBuffer = FixedSizeBuffer<LARGE_BUFFER_SIZE>;
     using LogBufferPtr = std::unique_ptr<LogBuffer>;
+    using LogRingPtr = std::shared_ptr<LogRingBuffer>;
 
     static constexpr FileSize DEFAULT_LOG_FILE_SIZE = 100 * 1024 * 1024; // 100 MB
     static constexpr uint32_t DEFAULT_LOG_FLUSH_INTERVAL = 5;            // 5 seconds
+    static constexpr size_t DEFAULT_THREAD_BUFFER_SIZE = 512 * 1024;     // 512 KB
+    static constexpr size_t MAX_STAGED_BUFFERS = 4;                      // written out when so many are filled.
 
 public:
     // @baseName: logFile's baseName.
     // @logDir: current dir by default.
     // @rollSize: size for per logFile, 100MB by default.
     // @flushInterval: flush every interval seconds, 5s by default.
+    // @threadBufferSize: size of the ring buffer of every logging thread, allocated when it logs first.
+    //                    A thread waits for the background thread when its ring is full.
     explicit LogDaemon(
         std::string baseName,
         std::string logDir = "./",
         FileSize rollSize = DEFAULT_LOG_FILE_SIZE,
-        uint32_t flushInterval = DEFAULT_LOG_FLUSH_INTERVAL);
+        uint32_t flushInterval = DEFAULT_LOG_FLUSH_INTERVAL,
+        size_t threadBufferSize = DEFAULT_THREAD_BUFFER_SIZE);
     ~LogDaemon() noexcept;
 
     void start();
 
+    // LogSyncPolicy::NONE by default, must be called before start().
+    void setSyncPolicy(LogSyncPolicy policy);
+    // Write the log files by O_DIRECT, see LogFile::setDirectIo(), must be called before start().
+    void setDirectIo(bool on);
+
+    // the lines dropped because their ring was full and nobody was harvesting it, such as before start().
+    uint64_t droppedCount() const
+    {
+        return droppedCount_.load(std::memory_order_relaxed);
+    }
+
 private:
     std::string generateLogFileName();
+    void openLogFile();
+    void assertIsNotRunning() const;
     void append(const char *data, size_t len);
+    // The record is stamped with the monotonic clock, the key to merge the threads' records, so a step of the
+    // wall clock never holds the records back. The lines carry their wall clock time by themselves.
+    // @flags: TEXT_RECORD or BINARY_RECORD.
+    void appendRecord(const char *data, size_t len, uint32_t flags);
     void flush();
+    // wake up the background thread to harvest if it is not yet.
+    void requestHarvest();
+    LogRingBuffer *currentThreadRing();
 
     void threadMain();
-
+    void harvest();
+    void writeRecord(const LogRingBuffer::Record &record);
+    // move the current buffer to the staged ones, and write them if there are too many.
+    void stageBuffer();
+    // write the staged buffers and the extra data by one writev(2).
+    void writeStaged(const char *extra = nullptr, size_t extraLen = 0);
+
+    // distinguishes the daemons in the thread local ring of a thread.
+    const uint64_t id_;
     std::atomic<bool> running_ = false;
     Thread thread_;
+    std::atomic<ThreadId> daemonTid_ = 0;
     mutable std::mutex mutex_;
     std::condition_variable cond_;
+    std::atomic<bool> harvestRequested_ = false;
+    // the logging threads waiting for room in their full rings.
+    std::condition_variable roomCond_;
+    std::atomic<size_t> roomWaiters_ = 0;
 
     std::string baseName_;
     std::filesystem::path logDir_;
     std::unique_ptr<LogFile> file_;
+    LogSyncPolicy syncPolicy_ = LogSyncPolicy::NONE;
+    bool directIo_ = false;
+
+    // only touched by the background thread.
+    LogBufferPtr buffer_;
+    std::vector<LogBufferPtr> stagedBuffers_;
+    std::vector<LogBufferPtr> spareBuffers_;
 
     FileSize rollSize_ = DEFAULT_LOG_FILE_SIZE;           // 100MB for per log file.
     uint32_t flushInterval_ = DEFAULT_LOG_FLUSH_INTERVAL; // flush every 5 seconds by default.
 
-    LogBufferPtr frontBuffer_;                 // Frontend threads will write logs to this buffer.
-    LogBufferPtr reservedBuffer_;              // BackStore of the front buffer
-    std::vector<LogBufferPtr> stagingBuffers_; // Backend thread will swap these buffers and write them to a file.
+    size_t threadBufferSize_ = DEFAULT_THREAD_BUFFER_SIZE;
+    std::mutex ringsMutex_;
+    std::vector<LogRingPtr> rings_; // every thread logged registers its ring here.
+    std::atomic<uint64_t> droppedCount_ = 0;
 };
 } // namespace base
 } // namespace wind
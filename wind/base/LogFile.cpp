@@ -19,28 +19,218 @@
 // LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
-
 #include "LogFile.h"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "Log.h"
+
 namespace wind {
 namespace base {
-LogFile::LogFile(const std::string &fileName) : output_(fileName, std::ios::out) {}
+namespace detail {
+// the iovecs copied to the stack for a writev(2), to resume from a partial write.
+constexpr size_t MAX_IOVECS_PER_WRITE = 64;
+
+inline size_t alignDown(size_t len)
+{
+    return len & ~(LogFile::DIRECT_IO_ALIGNMENT - 1);
+}
+
+inline size_t alignUp(size_t len)
+{
+    return alignDown(len + LogFile::DIRECT_IO_ALIGNMENT - 1);
+}
+} // namespace detail
+
+LogFile::LogFile(const std::string &fileName, LogSyncPolicy syncPolicy)
+    : name_(fileName),
+      fd_(::open(fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)),
+      syncPolicy_(syncPolicy)
+{
+    if (!fd_.valid()) {
+        LOG_SYS_FATAL << "Open log file " << name_ << " failed: " << strerror(errno) << ".";
+    }
+
+    struct stat st;
+    if (::fstat(fd_.get(), &st) == 0) {
+        size_ = static_cast<FileSize>(st.st_size);
+    }
+}
 
 LogFile::~LogFile() noexcept
 {
-    output_.flush();
-    output_.close();
+    if (directIo()) {
+        flushDirect();
+        truncatePadding();
+    }
+    if (syncPolicy_ != LogSyncPolicy::NONE) {
+        sync();
+    }
 }
 
 void LogFile::write(const char *data, size_t len)
 {
-    output_.write(data, static_cast<std::streamsize>(len));
-    size_ += len;
+    struct iovec vec = {const_cast<char *>(data), len};
+    write(&vec, 1);
+}
+
+void LogFile::write(const struct iovec *iov, size_t count)
+{
+    if (directIo()) {
+        for (size_t i = 0; i < count; ++i) {
+            writeDirect(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+        }
+        return;
+    }
+
+    struct iovec vecs[detail::MAX_IOVECS_PER_WRITE];
+    while (count > 0) {
+        size_t vecNum = std::min(count, detail::MAX_IOVECS_PER_WRITE);
+        std::copy(iov, iov + vecNum, vecs);
+        iov += vecNum;
+        count -= vecNum;
+
+        size_t index = 0;
+        while (index < vecNum) {
+            ssize_t written = ::writev(fd_.get(), vecs + index, static_cast<int>(vecNum - index));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                LOG_WARN << "Write log file " << name_ << " failed: " << strerror(errno) << ".";
+                return;
+            }
+            size_ += static_cast<FileSize>(written);
+
+            // skip the written ones, and resume from the middle of a partially written one.
+            auto left = static_cast<size_t>(written);
+            while (index < vecNum && left >= vecs[index].iov_len) {
+                left -= vecs[index].iov_len;
+                ++index;
+            }
+            if (left > 0) {
+                vecs[index].iov_base = static_cast<char *>(vecs[index].iov_base) + left;
+                vecs[index].iov_len -= left;
+            }
+        }
+    }
 }
 
 void LogFile::flush()
 {
-    output_.flush();
+    if (directIo()) {
+        flushDirect();
+    }
+    if (syncPolicy_ == LogSyncPolicy::EVERY_FLUSH) {
+        sync();
+    }
+}
+
+bool LogFile::setDirectIo(bool on)
+{
+    if (on == directIo()) {
+        return true;
+    }
+
+    std::unique_ptr<char, AlignedFree> buffer;
+    if (on) {
+        LOG_FATAL_IF(size_ % DIRECT_IO_ALIGNMENT != 0)
+            << "Log file " << name_ << " of size " << size_ << " can not switch to direct io.";
+        buffer.reset(static_cast<char *>(::aligned_alloc(DIRECT_IO_ALIGNMENT, DIRECT_IO_BUFFER_SIZE)));
+        if (buffer == nullptr) {
+            LOG_WARN << "Allocate the direct io buffer of log file " << name_ << " failed.";
+            return false;
+        }
+    } else {
+        flushDirect();
+        truncatePadding();
+    }
+
+    int flags = ::fcntl(fd_.get(), F_GETFL);
+    // the blocks are written at the given offsets, which O_APPEND ignores.
+    flags = on ? (flags | O_DIRECT) & ~O_APPEND : (flags & ~O_DIRECT) | O_APPEND;
+    if (::fcntl(fd_.get(), F_SETFL, flags) < 0) {
+        LOG_WARN << "Set direct io of log file " << name_ << " failed: " << strerror(errno) << ".";
+        return false;
+    }
+
+    directBuffer_ = std::move(buffer);
+    directLen_ = 0;
+    directOffset_ = size_;
+    return true;
+}
+
+void LogFile::writeDirect(const char *data, size_t len)
+{
+    while (len > 0) {
+        size_t bytes = std::min(len, DIRECT_IO_BUFFER_SIZE - directLen_);
+        ::memcpy(directBuffer_.get() + directLen_, data, bytes);
+        directLen_ += bytes;
+        size_ += bytes;
+        data += bytes;
+        len -= bytes;
+
+        if (directLen_ == DIRECT_IO_BUFFER_SIZE) {
+            pwriteAll(directBuffer_.get(), DIRECT_IO_BUFFER_SIZE, directOffset_);
+            directOffset_ += DIRECT_IO_BUFFER_SIZE;
+            directLen_ = 0;
+        }
+    }
+}
+
+void LogFile::flushDirect()
+{
+    if (directLen_ == 0) {
+        return;
+    }
+
+    size_t paddedLen = detail::alignUp(directLen_);
+    ::memset(directBuffer_.get() + directLen_, 0, paddedLen - directLen_);
+    pwriteAll(directBuffer_.get(), paddedLen, directOffset_);
+
+    // keep the last partial block, it is written again at the same offset with more data next time.
+    size_t fullLen = detail::alignDown(directLen_);
+    if (fullLen > 0) {
+        ::memmove(directBuffer_.get(), directBuffer_.get() + fullLen, directLen_ - fullLen);
+        directOffset_ += fullLen;
+        directLen_ -= fullLen;
+    }
+}
+
+void LogFile::truncatePadding()
+{
+    if (TEMP_FAILURE_RETRY(::ftruncate(fd_.get(), static_cast<off_t>(size_))) < 0) {
+        LOG_WARN << "Truncate log file " << name_ << " failed: " << strerror(errno) << ".";
+    }
+}
+
+void LogFile::pwriteAll(const char *data, size_t len, FileSize offset)
+{
+    while (len > 0) {
+        ssize_t written = ::pwrite(fd_.get(), data, len, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_WARN << "Write log file " << name_ << " failed: " << strerror(errno) << ".";
+            return;
+        }
+        data += written;
+        len -= static_cast<size_t>(written);
+        offset += static_cast<FileSize>(written);
+    }
+}
+
+void LogFile::sync()
+{
+    if (::fdatasync(fd_.get()) < 0) {
+        LOG_WARN << "Sync log file " << name_ << " failed: " << strerror(errno) << ".";
+    }
 }
 } // namespace base
 } // namespace wind
@@ -19,31 +19,95 @@
 // LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
-
 #pragma once
 
-#include <fstream>
+#include <sys/uio.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
 
 #include "NonCopyable.h"
 #include "Types.h"
+#include "UniqueFd.h"
 
 namespace wind {
 namespace base {
+// When the written data is synced to the disk by fdatasync().
+enum class LogSyncPolicy {
+    NONE,        // left to the kernel.
+    ON_CLOSE,    // when the file is closed, such as rolled.
+    EVERY_FLUSH, // every flush(), the lines are on the disk when it returns.
+};
+
+// An append-only file written by write(2)/writev(2) directly, no user space buffering except the direct io mode.
 class LogFile : NonCopyable {
 public:
-    explicit LogFile(const std::string &fileName);
+    // the alignment of the buffer, offset and length of a direct io.
+    static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+    static constexpr size_t DIRECT_IO_BUFFER_SIZE = 4 * 1024 * 1024; // 4 MB
+
+    explicit LogFile(const std::string &fileName, LogSyncPolicy syncPolicy = LogSyncPolicy::NONE);
     ~LogFile() noexcept;
 
     void write(const char *data, size_t len);
+    // all the buffers are written by one writev(2), or several if there are more than IOV_MAX of them.
+    void write(const struct iovec *iov, size_t count);
     void flush();
+
+    // Write by O_DIRECT bypassing the page cache, for the high volume logs which are never read soon.
+    // The data is staged in an aligned buffer and written by whole blocks, flush() writes the last partial block
+    // padded with zeros which is rewritten by the next flush(), the padding is truncated when the file is closed.
+    // Switching on needs an aligned file size, such as an empty file. Return false if the file system does not
+    // support it.
+    bool setDirectIo(bool on);
+    bool directIo() const
+    {
+        return directBuffer_ != nullptr;
+    }
+
+    void setSyncPolicy(LogSyncPolicy policy)
+    {
+        syncPolicy_ = policy;
+    }
+    LogSyncPolicy syncPolicy() const
+    {
+        return syncPolicy_;
+    }
+
+    const std::string &name() const
+    {
+        return name_;
+    }
     FileSize size() const
     {
         return size_;
     }
 
 private:
-    std::ofstream output_;
+    struct AlignedFree {
+        void operator()(char *p) const
+        {
+            ::free(p);
+        }
+    };
+
+    void writeDirect(const char *data, size_t len);
+    void flushDirect();
+    // cut the zeros padded after the last partial block.
+    void truncatePadding();
+    void pwriteAll(const char *data, size_t len, FileSize offset);
+    void sync();
+
+    std::string name_;
+    UniqueFd fd_;
     FileSize size_ = 0;
+    LogSyncPolicy syncPolicy_ = LogSyncPolicy::NONE;
+
+    // direct io only: the file offset of the first byte in the buffer, always aligned.
+    std::unique_ptr<char, AlignedFree> directBuffer_;
+    size_t directLen_ = 0;
+    FileSize directOffset_ = 0;
 };
 } // namespace base
 } // namespace wind
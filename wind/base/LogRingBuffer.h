@@ -0,0 +1,181 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "NonCopyable.h"
+#include "Types.h"
+#include "Utils.h"
+
+namespace wind {
+namespace base {
+// A single producer single consumer ring of log records, each is a line with the time it was written.
+// The producer never blocks or locks, it only fails when the ring is full. Every record is contiguous in the
+// ring, the space left at the end is skipped when a record does not fit.
+class LogRingBuffer : NonCopyable {
+    struct RecordHeader {
+        uint64_t time;
+        uint32_t len;
+        uint32_t flags;
+    };
+
+    static constexpr size_t ALIGNMENT = alignof(RecordHeader);
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    // marks the rest of the ring is skipped.
+    static constexpr uint32_t WRAP_LEN = UINT32_MAX;
+
+public:
+    // copyable
+    struct Record {
+        uint64_t time = 0;
+        const char *data = nullptr;
+        size_t len = 0;
+        // tells the kind of the record, opaque to the ring.
+        uint32_t flags = 0;
+    };
+
+    // @capacity: rounded up to a power of 2, at least 4KB.
+    explicit LogRingBuffer(size_t capacity)
+        : capacity_(roundUpCapacity(capacity)), mask_(capacity_ - 1), buffer_(new char[capacity_])
+    {}
+    ~LogRingBuffer() noexcept = default;
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    // the longest line kept, the longer ones are truncated.
+    size_t maxRecordLen() const
+    {
+        return capacity_ / 4 - sizeof(RecordHeader);
+    }
+
+    // Thread safe, but only a hint if the producer or consumer is running.
+    size_t size() const
+    {
+        return static_cast<size_t>(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire));
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    // Can only be called by the producer thread.
+    // @return: false if the ring is full, nothing is written.
+    bool tryAppend(uint64_t time, const char *data, size_t len, uint32_t flags = 0)
+    {
+        len = std::min(len, maxRecordLen());
+        size_t recordSize = alignUp(sizeof(RecordHeader) + len);
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        size_t index = static_cast<size_t>(head & mask_);
+        size_t skip = index + recordSize > capacity_ ? capacity_ - index : 0;
+        if (head + skip + recordSize - tail_.load(std::memory_order_acquire) > capacity_) {
+            return false;
+        }
+
+        if (skip > 0) {
+            if (skip >= sizeof(RecordHeader)) {
+                header(index)->len = WRAP_LEN;
+            }
+            index = 0;
+        }
+        RecordHeader *recordHeader = header(index);
+        recordHeader->time = time;
+        recordHeader->len = static_cast<uint32_t>(len);
+        recordHeader->flags = flags;
+        ::memcpy(buffer_.get() + index + sizeof(RecordHeader), data, len);
+        head_.store(head + skip + recordSize, std::memory_order_release);
+        return true;
+    }
+
+    // Can only be called by the consumer thread.
+    // @return: false if there is no record, or the oldest one, which stays valid until pop().
+    bool peek(Record &record)
+    {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        if (tail == head) {
+            return false;
+        }
+
+        size_t index = static_cast<size_t>(tail & mask_);
+        if (capacity_ - index < sizeof(RecordHeader) || header(index)->len == WRAP_LEN) {
+            // skip the end of the ring, the record is at the beginning.
+            tail += capacity_ - index;
+            tail_.store(tail, std::memory_order_release);
+            if (tail == head) {
+                return false;
+            }
+            index = 0;
+        }
+
+        const RecordHeader *recordHeader = header(index);
+        record.time = recordHeader->time;
+        record.data = buffer_.get() + index + sizeof(RecordHeader);
+        record.len = recordHeader->len;
+        record.flags = recordHeader->flags;
+        return true;
+    }
+
+    // Can only be called by the consumer thread, release the record of the last peek().
+    void pop(const Record &record)
+    {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        tail_.store(tail + alignUp(sizeof(RecordHeader) + record.len), std::memory_order_release);
+    }
+
+private:
+    static size_t roundUpCapacity(size_t capacity)
+    {
+        size_t result = 4096;
+        while (result < capacity) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static size_t alignUp(size_t size)
+    {
+        return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    RecordHeader *header(size_t index) const
+    {
+        return reinterpret_cast<RecordHeader *>(buffer_.get() + index);
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<char[]> buffer_;
+
+    // written by the producer and the consumer only, on separate cache lines.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail_ = 0;
+};
+} // namespace base
+} // namespace wind
@@ -101,12 +101,12 @@ FlushFunc LogStream::flushFunc_ = &detail::defaultFlush;
 
 void LogStream::setOutputFunc(OutputFunc func)
 {
-    outputFunc_ = std::move(func);
+    outputFunc_ = func != nullptr ? std::move(func) : &detail::defaultOutput;
 }
 
 void LogStream::setFlushFunc(FlushFunc func)
 {
-    flushFunc_ = std::move(func);
+    flushFunc_ = func != nullptr ? std::move(func) : &detail::defaultFlush;
 }
 
 LogStream::~LogStream() noexcept
@@ -223,6 +223,12 @@ LogStream &LogStream::operator<<(const std::string &s)
     return self();
 }
 
+LogStream &LogStream::operator<<(std::string_view s)
+{
+    append(s.data(), s.length());
+    return self();
+}
+
 LogStream &LogStream::operator<<(const Fmt &fmt)
 {
     append(fmt.data(), fmt.length());
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <functional>
+#include <string_view>
 
 #include "FixedSizeBuffer.h"
 
@@ -105,6 +106,7 @@ public:
 
     LogStream &operator<<(LogStream &(*func)(LogStream &));
     LogStream &operator<<(const std::string &s);
+    LogStream &operator<<(std::string_view s);
     LogStream &operator<<(const char *s);
     LogStream &operator<<(char *s)
     {
@@ -113,6 +115,7 @@ public:
     LogStream &operator<<(const Fmt &fmt);
     void append(const char *data, size_t len);
 
+    // nullptr restores the default, which writes to and flushes stdout.
     static void setOutputFunc(OutputFunc func);
     static void output(LogStream &stream);
     static void setFlushFunc(FlushFunc func);
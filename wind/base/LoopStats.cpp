@@ -0,0 +1,170 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LoopStats.h"
+
+#include <algorithm>
+
+namespace wind {
+namespace base {
+size_t histogramBucketOf(uint64_t value)
+{
+    if (value < HISTOGRAM_SUB_BUCKET_NUM) {
+        return static_cast<size_t>(value);
+    }
+
+    // the highest bit selects the group, the next HISTOGRAM_SUB_BUCKET_BITS bits select the bucket in it.
+    size_t shift = 63 - static_cast<size_t>(__builtin_clzll(value)) - HISTOGRAM_SUB_BUCKET_BITS;
+    size_t subBucket = static_cast<size_t>(value >> shift) & (HISTOGRAM_SUB_BUCKET_NUM - 1);
+    return (shift + 1) * HISTOGRAM_SUB_BUCKET_NUM + subBucket;
+}
+
+uint64_t histogramBucketLowerBound(size_t bucket)
+{
+    if (bucket < HISTOGRAM_SUB_BUCKET_NUM) {
+        return bucket;
+    }
+
+    size_t shift = bucket / HISTOGRAM_SUB_BUCKET_NUM - 1;
+    return (HISTOGRAM_SUB_BUCKET_NUM + bucket % HISTOGRAM_SUB_BUCKET_NUM) << shift;
+}
+
+uint64_t HistogramSnapshot::percentile(double p) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKET_NUM; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            if (i + 1 == HISTOGRAM_BUCKET_NUM) {
+                return max;
+            }
+            return std::min(histogramBucketLowerBound(i + 1) - 1, max);
+        }
+    }
+    return max;
+}
+
+std::string HistogramSnapshot::toString() const
+{
+    return "count: " + std::to_string(count) + ", mean: " + std::to_string(static_cast<uint64_t>(mean())) +
+        ", p50: " + std::to_string(percentile(0.5)) + ", p99: " + std::to_string(percentile(0.99)) +
+        ", max: " + std::to_string(max);
+}
+
+HistogramSnapshot LogLinearHistogram::snapshot() const
+{
+    HistogramSnapshot result;
+    for (size_t i = 0; i < HISTOGRAM_BUCKET_NUM; ++i) {
+        result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    result.count = count_.load(std::memory_order_relaxed);
+    result.sum = sum_.load(std::memory_order_relaxed);
+    result.max = max_.load(std::memory_order_relaxed);
+    return result;
+}
+
+std::string LoopStatsSnapshot::toString() const
+{
+    std::string out;
+    out += "iterations: " + std::to_string(iterations) + "\n";
+    out += "poll wait(ns)        | " + pollWaitTime.toString() + "\n";
+    out += "dispatch(ns)         | " + dispatchTime.toString() + "\n";
+    out += "functors(ns)         | " + functorTime.toString() + "\n";
+    out += "iteration(ns)        | " + iterationTime.toString() + "\n";
+    out += "events per poll      | " + eventsPerPoll.toString() + "\n";
+    out += "functors per drain   | " + functorsPerDrain.toString() + "\n";
+    out += "slowest callback(ns) | " + std::to_string(slowestCallbackTime) + ", fd: " +
+        std::to_string(slowestCallbackFd) + "\n";
+    return out;
+}
+
+const char *loopCallbackTypeName(LoopCallbackType type)
+{
+    switch (type) {
+        case LoopCallbackType::EVENT:
+            return "event";
+        case LoopCallbackType::READ:
+            return "read";
+        case LoopCallbackType::WRITE:
+            return "write";
+        case LoopCallbackType::CLOSE:
+            return "close";
+        case LoopCallbackType::ERROR:
+            return "error";
+        case LoopCallbackType::TIMER:
+            return "timer";
+        case LoopCallbackType::FUNCTOR:
+            return "functor";
+    }
+    return "unknown";
+}
+
+LoopActivitySample LoopActivity::sample() const
+{
+    LoopActivitySample result;
+    while (true) {
+        uint64_t seq = seq_.load(std::memory_order_acquire);
+        if (seq % 2 != 0) {
+            continue; // the loop thread is publishing.
+        }
+        result.since = since_.load(std::memory_order_relaxed);
+        result.fd = fd_.load(std::memory_order_relaxed);
+        result.type = type_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) == seq) {
+            result.seq = seq;
+            return result;
+        }
+    }
+}
+
+void LoopStats::updateSlowestCallback(uint64_t time, int fd)
+{
+    std::lock_guard<std::mutex> lock(slowestCallbackMutex_);
+    slowestCallbackTime_.store(time, std::memory_order_relaxed);
+    slowestCallbackFd_ = fd;
+}
+
+LoopStatsSnapshot LoopStats::snapshot() const
+{
+    LoopStatsSnapshot result;
+    result.pollWaitTime = pollWaitTime_.snapshot();
+    result.dispatchTime = dispatchTime_.snapshot();
+    result.functorTime = functorTime_.snapshot();
+    result.iterationTime = iterationTime_.snapshot();
+    result.eventsPerPoll = eventsPerPoll_.snapshot();
+    result.functorsPerDrain = functorsPerDrain_.snapshot();
+    result.iterations = result.iterationTime.count;
+    {
+        std::lock_guard<std::mutex> lock(slowestCallbackMutex_);
+        result.slowestCallbackTime = slowestCallbackTime_.load(std::memory_order_relaxed);
+        result.slowestCallbackFd = slowestCallbackFd_;
+    }
+    return result;
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,228 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "NonCopyable.h"
+#include "Types.h"
+
+namespace wind {
+namespace base {
+// Buckets of the log-linear histogram: values below SUB_BUCKET_NUM have their own buckets, every power of two
+// above is split into SUB_BUCKET_NUM linear buckets, so the relative error is at most 1 / SUB_BUCKET_NUM.
+constexpr size_t HISTOGRAM_SUB_BUCKET_BITS = 3;
+constexpr size_t HISTOGRAM_SUB_BUCKET_NUM = 1 << HISTOGRAM_SUB_BUCKET_BITS;
+constexpr size_t HISTOGRAM_BUCKET_NUM = (64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKET_NUM;
+
+size_t histogramBucketOf(uint64_t value);
+// the smallest value of the bucket.
+uint64_t histogramBucketLowerBound(size_t bucket);
+
+// copyable
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    std::array<uint64_t, HISTOGRAM_BUCKET_NUM> buckets{};
+
+    double mean() const
+    {
+        return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+    }
+    // @p: in [0, 1], the result is the upper bound of the bucket it falls in, but never greater than max.
+    uint64_t percentile(double p) const;
+    // count: n, mean: m, p50: x, p99: y, max: z
+    std::string toString() const;
+};
+
+// Written by one thread only and read by any thread. The writer never takes a lock or a locked instruction,
+// readers may see a snapshot in the middle of a record, which is fine for statistics.
+class LogLinearHistogram : NonCopyable {
+public:
+    void record(uint64_t value)
+    {
+        increase(buckets_[histogramBucketOf(value)], 1);
+        increase(count_, 1);
+        increase(sum_, value);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    HistogramSnapshot snapshot() const;
+
+private:
+    static void increase(std::atomic<uint64_t> &counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKET_NUM> buckets_{};
+    std::atomic<uint64_t> count_ = 0;
+    std::atomic<uint64_t> sum_ = 0;
+    std::atomic<uint64_t> max_ = 0;
+};
+
+// copyable, all the times are in nano seconds.
+struct LoopStatsSnapshot {
+    uint64_t iterations = 0;
+    // blocked (or busy polling) in the poller.
+    HistogramSnapshot pollWaitTime;
+    // handling the io events of an iteration, timers included.
+    HistogramSnapshot dispatchTime;
+    // one execPendingFunctors().
+    HistogramSnapshot functorTime;
+    // an iteration except the poll wait.
+    HistogramSnapshot iterationTime;
+    HistogramSnapshot eventsPerPoll;
+    HistogramSnapshot functorsPerDrain;
+    // the slowest channel callback ever, and the fd of the channel.
+    uint64_t slowestCallbackTime = 0;
+    int slowestCallbackFd = -1;
+
+    std::string toString() const;
+};
+
+// What a loop thread is running.
+enum class LoopCallbackType {
+    // a channel event whose callback is not known yet.
+    EVENT,
+    READ,
+    WRITE,
+    CLOSE,
+    ERROR,
+    TIMER,
+    FUNCTOR,
+};
+
+const char *loopCallbackTypeName(LoopCallbackType type);
+
+// copyable
+struct LoopActivitySample {
+    // changes every time a new callback begins or the loop goes back to poll.
+    uint64_t seq = 0;
+    // the monotonic time the current callback began at, 0 means not in a callback.
+    uint64_t since = 0;
+    // -1 for functors.
+    int fd = -1;
+    LoopCallbackType type = LoopCallbackType::EVENT;
+};
+
+// The callback a loop thread is running now, published by the loop thread for the watchdog.
+// A sequence lock keeps the fields consistent, the loop thread never waits.
+class LoopActivity : NonCopyable {
+public:
+    void begin(uint64_t since, int fd, LoopCallbackType type)
+    {
+        publish(since, fd, type);
+    }
+
+    void end()
+    {
+        publish(0, -1, LoopCallbackType::EVENT);
+    }
+
+    // refine the type of the current callback, such as a channel event turned out to be a read.
+    void setType(LoopCallbackType type)
+    {
+        type_.store(type, std::memory_order_relaxed);
+    }
+
+    // thread safe.
+    LoopActivitySample sample() const;
+
+private:
+    void publish(uint64_t since, int fd, LoopCallbackType type)
+    {
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        since_.store(since, std::memory_order_relaxed);
+        fd_.store(fd, std::memory_order_relaxed);
+        type_.store(type, std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // odd while publishing.
+    std::atomic<uint64_t> seq_ = 0;
+    std::atomic<uint64_t> since_ = 0;
+    std::atomic<int> fd_ = -1;
+    std::atomic<LoopCallbackType> type_ = LoopCallbackType::EVENT;
+};
+
+// The always-on statistics of an EventLoop, recorded by the loop thread and read by any thread.
+class LoopStats : NonCopyable {
+public:
+    void recordPoll(uint64_t waitTime, size_t events)
+    {
+        pollWaitTime_.record(waitTime);
+        eventsPerPoll_.record(events);
+    }
+
+    void recordCallback(uint64_t time, int fd)
+    {
+        if (time > slowestCallbackTime_.load(std::memory_order_relaxed)) {
+            updateSlowestCallback(time, fd);
+        }
+    }
+
+    void recordDispatch(uint64_t time)
+    {
+        dispatchTime_.record(time);
+    }
+
+    void recordDrain(uint64_t time, size_t functors)
+    {
+        functorTime_.record(time);
+        functorsPerDrain_.record(functors);
+    }
+
+    void recordIteration(uint64_t time)
+    {
+        iterationTime_.record(time);
+    }
+
+    // thread safe.
+    LoopStatsSnapshot snapshot() const;
+
+private:
+    void updateSlowestCallback(uint64_t time, int fd);
+
+    LogLinearHistogram pollWaitTime_;
+    LogLinearHistogram dispatchTime_;
+    LogLinearHistogram functorTime_;
+    LogLinearHistogram iterationTime_;
+    LogLinearHistogram eventsPerPoll_;
+    LogLinearHistogram functorsPerDrain_;
+
+    // rarely updated, the lock keeps the time and the fd consistent.
+    mutable std::mutex slowestCallbackMutex_;
+    std::atomic<uint64_t> slowestCallbackTime_ = 0;
+    int slowestCallbackFd_ = -1;
+};
+} // namespace base
+} // namespace wind
@@ -0,0 +1,217 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LoopWatchdog.h"
+
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/syscall.h>
+
+namespace wind {
+namespace base {
+namespace detail {
+constexpr int MAX_BACKTRACE_FRAMES = 64;
+constexpr TimeType BACKTRACE_WAIT_TIME = 100 * MICRO_SECS_PER_MILLISECOND;
+constexpr TimeType MIN_CHECK_INTERVAL = MICRO_SECS_PER_MILLISECOND;
+
+// One capture at a time in the process, the signal handler fills the frames of the thread requested.
+std::mutex backtraceMutex;
+std::atomic<ThreadId> backtraceTid = 0;
+std::atomic<bool> backtraceDone = false;
+void *backtraceFrames[MAX_BACKTRACE_FRAMES];
+int backtraceFrameNum = 0;
+
+int backtraceSignal()
+{
+    return SIGRTMIN + 4;
+}
+
+void backtraceSignalHandler(int)
+{
+    int savedErrno = errno;
+    if (CurrentThread::tid() == backtraceTid.load(std::memory_order_acquire)) {
+        backtraceFrameNum = ::backtrace(backtraceFrames, MAX_BACKTRACE_FRAMES);
+        backtraceDone.store(true, std::memory_order_release);
+    }
+    errno = savedErrno;
+}
+
+void installBacktraceSignalHandler()
+{
+    static std::once_flag once;
+    std::call_once(once, []() {
+        // backtrace() loads libgcc on the first call, which is not safe in a signal handler.
+        void *frame = nullptr;
+        ::backtrace(&frame, 1);
+
+        struct sigaction action {};
+        action.sa_handler = backtraceSignalHandler;
+        action.sa_flags = SA_RESTART;
+        ::sigemptyset(&action.sa_mask);
+        if (::sigaction(backtraceSignal(), &action, nullptr) != 0) {
+            LOG_WARN << "Install the backtrace signal handler failed: " << strerror(errno) << ".";
+        }
+    });
+}
+} // namespace detail
+
+LoopWatchdog::LoopWatchdog(TimeType threshold, std::string name) : threshold_(threshold), name_(std::move(name))
+{
+    if (threshold_ <= 0) {
+        LOG_SYS_FATAL << "LoopWatchdog::ctor: threshold must be positive!";
+    }
+}
+
+LoopWatchdog::~LoopWatchdog() noexcept
+{
+    stop();
+}
+
+void LoopWatchdog::watch(EventLoop *loop)
+{
+    if (loop == nullptr) {
+        LOG_WARN << "LoopWatchdog::" << __func__ << ": loop is null!";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    loops_.emplace(loop, 0);
+}
+
+void LoopWatchdog::unwatch(EventLoop *loop)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    loops_.erase(loop);
+}
+
+void LoopWatchdog::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            return;
+        }
+        running_ = true;
+    }
+
+    if (backtraceEnabled_) {
+        detail::installBacktraceSignalHandler();
+    }
+    if (stallCallback_ == nullptr) {
+        stallCallback_ = [](const LoopStall &stall) {
+            LOG_WARN << "EventLoop of thread " << stall.threadName << "(" << stall.tid << ") stalled for "
+                     << stall.duration / MICRO_SECS_PER_MILLISECOND << "ms in the "
+                     << loopCallbackTypeName(stall.type) << " callback of fd " << stall.fd << "."
+                     << (stall.backtrace.empty() ? "" : "\n") << stall.backtrace;
+        };
+    }
+    thread_ = make_thread(name_, [this]() { watchdogThreadFunc(); });
+}
+
+void LoopWatchdog::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        cond_.notify_one();
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void LoopWatchdog::watchdogThreadFunc()
+{
+    auto interval = std::chrono::microseconds(std::max(threshold_ / 4, detail::MIN_CHECK_INTERVAL));
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cond_.wait_for(lock, interval, [this]() { return !running_; });
+        if (running_) {
+            checkLoops();
+        }
+    }
+}
+
+void LoopWatchdog::checkLoops()
+{
+    uint64_t now = utils::monotonicNanos();
+    for (auto &[loop, reportedSeq] : loops_) {
+        auto activity = loop->activity();
+        if (activity.since == 0 || activity.seq == reportedSeq || now < activity.since) {
+            continue;
+        }
+
+        auto duration = static_cast<TimeType>((now - activity.since) / NANO_SECS_PER_MICROSECOND);
+        if (duration < threshold_) {
+            continue;
+        }
+
+        reportedSeq = activity.seq;
+        stallCount_.fetch_add(1, std::memory_order_relaxed);
+        LoopStall stall{loop->threadName(), loop->threadId(), activity.fd, activity.type, duration, {}};
+        if (backtraceEnabled_) {
+            stall.backtrace = captureBacktrace(loop->threadId());
+            if (loop->activity().seq != activity.seq) {
+                stall.backtrace += "(the callback finished during the capture, the stack may be of others)\n";
+            }
+        }
+        stallCallback_(stall);
+    }
+}
+
+std::string LoopWatchdog::captureBacktrace(ThreadId tid)
+{
+    std::lock_guard<std::mutex> lock(detail::backtraceMutex);
+    detail::backtraceDone.store(false, std::memory_order_relaxed);
+    detail::backtraceTid.store(tid, std::memory_order_release);
+    if (::syscall(SYS_tgkill, CurrentThread::pid(), tid, detail::backtraceSignal()) != 0) {
+        detail::backtraceTid.store(0, std::memory_order_relaxed);
+        return std::string("capture backtrace failed: ") + strerror(errno) + "\n";
+    }
+
+    uint64_t deadline = utils::monotonicNanos() + detail::BACKTRACE_WAIT_TIME * NANO_SECS_PER_MICROSECOND;
+    while (!detail::backtraceDone.load(std::memory_order_acquire)) {
+        if (utils::monotonicNanos() > deadline) {
+            // the handler ignores a late signal.
+            detail::backtraceTid.store(0, std::memory_order_relaxed);
+            return "capture backtrace timed out\n";
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    detail::backtraceTid.store(0, std::memory_order_relaxed);
+
+    std::string result;
+    char **symbols = ::backtrace_symbols(detail::backtraceFrames, detail::backtraceFrameNum);
+    for (int i = 0; i < detail::backtraceFrameNum; ++i) {
+        result += "    ";
+        result += symbols != nullptr ? symbols[i] : "?";
+        result += "\n";
+    }
+    ::free(symbols);
+    return result;
+}
+} // namespace base
+} // namespace wind
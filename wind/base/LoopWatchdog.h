@@ -0,0 +1,105 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+
+#include "EventLoop.h"
+#include "Thread.h"
+
+namespace wind {
+namespace base {
+// copyable
+struct LoopStall {
+    std::string threadName;
+    ThreadId tid = -1;
+    // -1 for functors.
+    int fd = -1;
+    LoopCallbackType type = LoopCallbackType::EVENT;
+    // how long the callback has been running when detected, in micro seconds.
+    TimeType duration = 0;
+    // the stack of the loop thread, only if the backtrace is enabled.
+    std::string backtrace;
+};
+
+using LoopStallCallback = std::function<void(const LoopStall &)>;
+
+// A thread sampling the callbacks of the watched loops, reports the ones running longer than the threshold,
+// which stall all the other connections of the loop. Every stalled callback is reported once.
+class LoopWatchdog : NonCopyable {
+public:
+    static constexpr TimeType DEFAULT_THRESHOLD = 100 * MICRO_SECS_PER_MILLISECOND;
+
+    // @threshold: in micro seconds, the loops are sampled 4 times in it.
+    explicit LoopWatchdog(TimeType threshold = DEFAULT_THRESHOLD, std::string name = "WindLoopWatchdog");
+    ~LoopWatchdog() noexcept;
+
+    // Capture the stack of the stalled loop thread by a signal, off by default. A slow syscall interrupted
+    // by it is restarted, except the ones never restarted like epoll_wait, which fail with EINTR.
+    // must be called before start().
+    void setBacktraceEnabled(bool enabled)
+    {
+        backtraceEnabled_ = enabled;
+    }
+
+    // logs the stall as a warning by default. It is called in the watchdog thread with the loops locked,
+    // so it must not call watch() or unwatch(). must be called before start().
+    void setStallCallback(LoopStallCallback cb)
+    {
+        stallCallback_ = std::move(cb);
+    }
+
+    // The loop must be unwatched, or the watchdog stopped before the loop is destroyed. thread safe.
+    void watch(EventLoop *loop);
+    void unwatch(EventLoop *loop);
+
+    void start();
+    void stop();
+
+    uint64_t stallCount() const
+    {
+        return stallCount_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void watchdogThreadFunc();
+    void checkLoops();
+    std::string captureBacktrace(ThreadId tid);
+
+    TimeType threshold_;
+    std::string name_;
+    bool backtraceEnabled_ = false;
+    LoopStallCallback stallCallback_;
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool running_ = false;
+    // loop -> seq of the last stalled callback reported.
+    std::map<EventLoop *, uint64_t> loops_;
+    Thread thread_;
+    std::atomic<uint64_t> stallCount_ = 0;
+};
+} // namespace base
+} // namespace wind
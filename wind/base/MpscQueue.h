@@ -0,0 +1,138 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+#include "NonCopyable.h"
+#include "Types.h"
+
+namespace wind {
+namespace base {
+// Lock-free multi-producer single-consumer queue, a Treiber stack of heap allocated nodes.
+// Producers push nodes to the head of a singly linked list with CAS,
+// the consumer takes the whole list with one exchange and reverses it to FIFO order,
+// so there is no ABA problem and the consumer never races with producers on a node.
+template <typename T>
+class MpscQueue : NonCopyable {
+    struct Node {
+        template <typename... Args>
+        explicit Node(Args &&...args) : value(std::forward<Args>(args)...)
+        {}
+
+        T value;
+        Node *next = nullptr;
+    };
+
+public:
+    MpscQueue() = default;
+    ~MpscQueue() noexcept
+    {
+        consumeAll([](T &) {});
+    }
+
+    // Thread safe, allocates one node per value, which is freed by the consumer.
+    template <typename... Args>
+    void push(Args &&...args)
+    {
+        Node *node = new Node(std::forward<Args>(args)...);
+        Node *oldHead = head_.load(std::memory_order_relaxed);
+        do {
+            node->next = oldHead;
+        } while (!head_.compare_exchange_weak(oldHead, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Thread safe, but the result is only a hint if there are other threads pushing.
+    // The backlog left by consumeUntil() is not counted, see hasBacklog().
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == nullptr;
+    }
+
+    // Can only be called by the consumer thread.
+    // Call func for every value pushed before in FIFO order, values pushed by func will not be consumed this time.
+    // @return: the number of consumed values.
+    template <typename Func>
+    size_t consumeAll(Func &&func)
+    {
+        return consumeUntil(std::forward<Func>(func), []() { return false; });
+    }
+
+    // Can only be called by the consumer thread.
+    // Same as consumeAll(), but stops once stop() returns true after a value is consumed, the values left are
+    // kept in order as the backlog, which goes first next time.
+    // @return: the number of consumed values.
+    template <typename Func, typename Stop>
+    size_t consumeUntil(Func &&func, Stop &&stop)
+    {
+        Node *node = head_.exchange(nullptr, std::memory_order_acq_rel);
+        if (node != nullptr) {
+            // reverse to FIFO order and append to the backlog.
+            Node *first = node;
+            Node *prev = nullptr;
+            while (node != nullptr) {
+                Node *next = node->next;
+                node->next = prev;
+                prev = node;
+                node = next;
+            }
+            if (backlogTail_ != nullptr) {
+                backlogTail_->next = prev;
+            } else {
+                backlog_ = prev;
+            }
+            backlogTail_ = first;
+        }
+
+        size_t cnt = 0;
+        while (backlog_ != nullptr) {
+            node = backlog_;
+            backlog_ = node->next;
+            if (backlog_ == nullptr) {
+                backlogTail_ = nullptr;
+            }
+            func(node->value);
+            delete node;
+            ++cnt;
+            if (stop()) {
+                break;
+            }
+        }
+        return cnt;
+    }
+
+    // Can only be called by the consumer thread, whether consumeUntil() left values.
+    bool hasBacklog() const
+    {
+        return backlog_ != nullptr;
+    }
+
+private:
+    std::atomic<Node *> head_{nullptr};
+    // only accessed by the consumer.
+    Node *backlog_ = nullptr;
+    Node *backlogTail_ = nullptr;
+};
+} // namespace base
+} // namespace wind
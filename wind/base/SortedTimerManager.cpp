@@ -0,0 +1,136 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "SortedTimerManager.h"
+
+#include "Log.h"
+
+namespace wind {
+namespace base {
+SortedTimerManager::SortedTimerManager(EventLoop *loop) : TimerManager(loop, TimerManagerType::SORTED) {}
+
+void SortedTimerManager::insertTimer(uint32_t index)
+{
+    assertInLoopThread();
+
+    if (index >= heapPos_.size()) {
+        heapPos_.resize(poolCapacity(), NOT_IN_HEAP);
+    }
+    ASSERT(heapPos_[index] == NOT_IN_HEAP);
+
+    heap_.push_back(index);
+    heapPos_[index] = static_cast<uint32_t>(heap_.size() - 1);
+    siftUp(heap_.size() - 1);
+
+    if (heap_[0] == index) {
+        timerFdReset(timerAt(index).expireTime());
+    }
+}
+
+void SortedTimerManager::removeTimer(uint32_t index)
+{
+    assertInLoopThread();
+    ASSERT(index < heapPos_.size() && heapPos_[index] != NOT_IN_HEAP);
+
+    size_t pos = heapPos_[index];
+    eraseAt(pos);
+    if (pos == 0) {
+        resetToEarliest();
+    }
+}
+
+void SortedTimerManager::handleExpiredTimers(TimeStamp receivedTime)
+{
+    // the repeat timers restart later than receivedTime, so they will not run twice in one round.
+    while (!heap_.empty() && expireTimeAt(0) <= receivedTime) {
+        uint32_t index = heap_[0];
+        eraseAt(0);
+        if (executeTimer(index)) {
+            insertTimer(index);
+        }
+    }
+
+    resetToEarliest();
+}
+
+void SortedTimerManager::siftUp(size_t pos)
+{
+    uint32_t index = heap_[pos];
+    TimeStamp expireTime = timerAt(index).expireTime();
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (expireTimeAt(parent) <= expireTime) {
+            break;
+        }
+        place(pos, heap_[parent]);
+        pos = parent;
+    }
+    place(pos, index);
+}
+
+void SortedTimerManager::siftDown(size_t pos)
+{
+    uint32_t index = heap_[pos];
+    TimeStamp expireTime = timerAt(index).expireTime();
+    size_t size = heap_.size();
+    while (true) {
+        size_t child = pos * 2 + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && expireTimeAt(child + 1) < expireTimeAt(child)) {
+            ++child;
+        }
+        if (expireTime <= expireTimeAt(child)) {
+            break;
+        }
+        place(pos, heap_[child]);
+        pos = child;
+    }
+    place(pos, index);
+}
+
+void SortedTimerManager::eraseAt(size_t pos)
+{
+    heapPos_[heap_[pos]] = NOT_IN_HEAP;
+    uint32_t last = heap_.back();
+    heap_.pop_back();
+    if (pos == heap_.size()) {
+        return;
+    }
+
+    place(pos, last);
+    siftDown(pos);
+    siftUp(pos);
+}
+
+void SortedTimerManager::resetToEarliest()
+{
+    if (heap_.empty()) {
+        timerFdReset(TimeStamp::invalid());
+        return;
+    }
+
+    timerFdReset(expireTimeAt(0));
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,64 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <vector>
+
+#include "TimerManager.h"
+
+namespace wind {
+namespace base {
+// Timers sorted by expire time in a binary min heap of pool indexes, the timerFd is always armed to the earliest one.
+// Every timer remembers its position in the heap, so cancelling is O(log n) as adding.
+class SortedTimerManager : public TimerManager {
+public:
+    explicit SortedTimerManager(EventLoop *loop);
+    ~SortedTimerManager() noexcept override = default;
+
+protected:
+    void insertTimer(uint32_t index) override;
+    void removeTimer(uint32_t index) override;
+    void handleExpiredTimers(TimeStamp receivedTime) override;
+
+private:
+    static constexpr uint32_t NOT_IN_HEAP = UINT32_MAX;
+
+    TimeStamp expireTimeAt(size_t pos)
+    {
+        return timerAt(heap_[pos]).expireTime();
+    }
+    void place(size_t pos, uint32_t index)
+    {
+        heap_[pos] = index;
+        heapPos_[index] = static_cast<uint32_t>(pos);
+    }
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+    void eraseAt(size_t pos);
+    void resetToEarliest();
+
+    std::vector<uint32_t> heap_;
+    std::vector<uint32_t> heapPos_; // indexed by pool index.
+};
+} // namespace base
+} // namespace wind
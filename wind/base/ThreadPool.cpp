@@ -30,7 +30,9 @@
 
 namespace wind {
 namespace base {
-ThreadPool::TaskWorker::TaskWorker(std::string name) : name_(std::move(name)), readyTime_(TimeStamp::now()) {}
+ThreadPool::TaskWorker::TaskWorker(ThreadPool *pool, std::string name, int cpu)
+    : pool_(pool), name_(std::move(name)), cpu_(cpu), readyTime_(TimeStamp::now())
+{}
 
 ThreadPool::TaskWorker::~TaskWorker() noexcept
 {
@@ -85,38 +87,141 @@ ThreadId ThreadPool::TaskWorker::start()
     return tid_;
 }
 
+TimeStamp ThreadPool::TaskWorker::enqueueTime() const
+{
+    return pool_->isElastic() ? TimeStamp::now() : TimeStamp::invalid();
+}
+
+TimeType ThreadPool::TaskWorker::oldestTaskAge(TimeStamp now) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isEmptyLocked() || tasks_.front().enqueueTime == TimeStamp::invalid()) {
+        return 0;
+    }
+    return timeDiff(now, tasks_.front().enqueueTime);
+}
+
 void ThreadPool::TaskWorker::postTask(Task task)
 {
+    auto enqueued = enqueueTime();
     std::unique_lock<std::mutex> lock(mutex_);
     while (isFullLocked()) {
         notFullCond_.wait(lock);
     }
 
-    tasks_.push(std::move(task));
+    tasks_.push({std::move(task), enqueued});
+    lock.unlock();
+
+    notEmptyCond_.notify_one();
+}
+
+bool ThreadPool::TaskWorker::tryPostTask(Task &task)
+{
+    auto enqueued = enqueueTime();
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (isFullLocked()) {
+        return false;
+    }
+
+    tasks_.push({std::move(task), enqueued});
     lock.unlock();
 
     notEmptyCond_.notify_one();
+    return true;
+}
+
+size_t ThreadPool::TaskWorker::tryPostTasks(Task *tasks, size_t count)
+{
+    auto enqueued = enqueueTime();
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t posted = 0;
+    for (; posted < count && !isFullLocked(); ++posted) {
+        tasks_.push({std::move(tasks[posted]), enqueued});
+    }
+    lock.unlock();
+
+    if (posted > 0) {
+        notEmptyCond_.notify_one();
+    }
+    return posted;
+}
+
+void ThreadPool::TaskWorker::handOverTasks(TaskWorker &to, size_t count)
+{
+    std::vector<QueuedTask> tasks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        count = std::min(count, getQueueSizeLocked());
+        tasks.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            tasks.push_back(std::move(tasks_.front()));
+            tasks_.pop();
+        }
+        notFullCond_.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(to.mutex_);
+        for (auto &task : tasks) {
+            to.tasks_.push(std::move(task));
+        }
+    }
+    to.notEmptyCond_.notify_one();
+}
+
+ThreadPool::Task ThreadPool::TaskWorker::replaceOldestTask(Task task)
+{
+    auto enqueued = enqueueTime();
+    std::unique_lock<std::mutex> lock(mutex_);
+    tasks_.push({std::move(task), enqueued});
+    auto oldest = std::move(tasks_.front().task);
+    tasks_.pop();
+    lock.unlock();
+
+    notEmptyCond_.notify_one();
+    return oldest;
+}
+
+void ThreadPool::TaskWorker::wakeUp()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    notEmptyCond_.notify_one();
 }
 
-ThreadPool::Task ThreadPool::TaskWorker::fetchTask()
+ThreadPool::Task ThreadPool::TaskWorker::fetchTask(bool &idleTimeout)
 {
     std::unique_lock<std::mutex> lock(mutex_);
 
-    if (isEmptyLocked() && running_) {
-        notEmptyCond_.wait(lock);
+    // the spiller changes the overflow size before locking us to wake up, so it won't be missed.
+    if (isEmptyLocked() && running_ && !pool_->hasOverflowTasks()) {
+        if (pool_->isElastic()) {
+            auto keepAlive = std::chrono::microseconds(pool_->keepAliveTime_);
+            idleTimeout = notEmptyCond_.wait_for(lock, keepAlive) == std::cv_status::timeout;
+        } else {
+            notEmptyCond_.wait(lock);
+        }
     }
 
     if (!isEmptyLocked()) {
-        auto task = std::move(tasks_.front());
+        auto &front = tasks_.front();
+        if (front.enqueueTime != TimeStamp::invalid()) {
+            pool_->noteQueueLatency(timeDiff(TimeStamp::now(), front.enqueueTime));
+        }
+        auto task = std::move(front.task);
         tasks_.pop();
         return task;
     }
 
-    return nullptr;
+    lock.unlock();
+    return pool_->takeOverflowTask();
 }
 
 void ThreadPool::TaskWorker::threadMain()
 {
+    if (cpu_ >= 0) {
+        pinCurrentThread(cpu_);
+    }
+
     {
         std::lock_guard<std::mutex> lock(mutex_);
         tid_ = CurrentThread::tid();
@@ -131,7 +236,11 @@ void ThreadPool::TaskWorker::threadMain()
             }
         }
 
-        auto task = fetchTask();
+        bool idleTimeout = false;
+        auto task = fetchTask(idleTimeout);
+        if (task == nullptr && idleTimeout && pool_->retireWorker(this)) {
+            break;
+        }
         {
             std::lock_guard<std::mutex> lock(mutex_);
             if (!isFullLocked()) {
@@ -139,6 +248,9 @@ void ThreadPool::TaskWorker::threadMain()
                 notFullCond_.notify_one();
             }
         }
+        if (task != nullptr && pool_->isElastic()) {
+            pool_->trySpawnWorker();
+        }
 
         if (task != nullptr) {
 #ifdef ENABLE_EXCEPTION
@@ -159,6 +271,248 @@ void ThreadPool::TaskWorker::threadMain()
     LOG_INFO << "Thread " << name_ << " stopped.";
 }
 
+ThreadPool::StealingWorker::StealingWorker(ThreadPool *pool, size_t index, std::string name, int cpu)
+    : pool_(pool),
+      index_(index),
+      name_(std::move(name)),
+      cpu_(cpu),
+      randomState_(0x9E3779B97F4A7C15ULL * (index + 1))
+{}
+
+ThreadPool::StealingWorker::~StealingWorker() noexcept
+{
+    stop();
+
+    // the tasks not run yet are dropped.
+    while (TaskNode *node = deque_.pop()) {
+        delete node;
+    }
+    TaskNode *node = inbox_.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+        TaskNode *next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+void ThreadPool::StealingWorker::start()
+{
+    running_ = true;
+    thread_ = make_thread(name_, [this]() { threadMain(); });
+}
+
+void ThreadPool::StealingWorker::stop() noexcept
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        notified_ = true;
+        parkCond_.notify_one();
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ThreadPool::StealingWorker::pushLocal(Task task)
+{
+    deque_.push(new TaskNode(std::move(task)));
+    // pairs with the fence in park(), either the sleeping one sees the task or we see it sleeping.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (pool_->sleepingWorkers_.load(std::memory_order_relaxed) > 0) {
+        pool_->wakeUpStealer(index_);
+    }
+}
+
+void ThreadPool::StealingWorker::postTask(Task task)
+{
+    TaskNode *node = new TaskNode(std::move(task));
+    inboxSize_.fetch_add(1, std::memory_order_relaxed);
+    pushInbox(node, node);
+    // pairs with the fence in park().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (isSleeping()) {
+        wakeUp();
+    }
+}
+
+void ThreadPool::StealingWorker::postTasks(Task *tasks, size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    // link them in LIFO order as the inbox does, then push them at once.
+    TaskNode *last = new TaskNode(std::move(tasks[0]));
+    TaskNode *first = last;
+    for (size_t i = 1; i < count; ++i) {
+        TaskNode *node = new TaskNode(std::move(tasks[i]));
+        node->next = first;
+        first = node;
+    }
+    inboxSize_.fetch_add(count, std::memory_order_relaxed);
+    pushInbox(first, last);
+    // one wake up for all, it wakes up the others to steal when draining more than one task.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (isSleeping()) {
+        wakeUp();
+    }
+}
+
+bool ThreadPool::StealingWorker::wakeUp()
+{
+    if (!sleeping_.exchange(false)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(parkMutex_);
+    notified_ = true;
+    parkCond_.notify_one();
+    return true;
+}
+
+void ThreadPool::StealingWorker::pushInbox(TaskNode *first, TaskNode *last)
+{
+    TaskNode *oldHead = inbox_.load(std::memory_order_relaxed);
+    do {
+        last->next = oldHead;
+    } while (!inbox_.compare_exchange_weak(oldHead, first, std::memory_order_release, std::memory_order_relaxed));
+}
+
+size_t ThreadPool::StealingWorker::drainInbox()
+{
+    // take them all and reverse to FIFO order, like MpscQueue does.
+    TaskNode *node = inbox_.exchange(nullptr, std::memory_order_acquire);
+    TaskNode *prev = nullptr;
+    while (node != nullptr) {
+        TaskNode *next = node->next;
+        node->next = prev;
+        prev = node;
+        node = next;
+    }
+
+    // the node may be stolen and freed once pushed, read the next one before.
+    size_t count = 0;
+    node = prev;
+    while (node != nullptr) {
+        TaskNode *next = node->next;
+        deque_.push(node);
+        node = next;
+        ++count;
+    }
+    if (count > 0) {
+        inboxSize_.fetch_sub(count, std::memory_order_relaxed);
+        if (count > 1 && pool_->sleepingWorkers_.load(std::memory_order_relaxed) > 0) {
+            pool_->wakeUpStealer(index_);
+        }
+    }
+    return count;
+}
+
+size_t ThreadPool::StealingWorker::randomIndex()
+{
+    // xorshift64
+    randomState_ ^= randomState_ << 13;
+    randomState_ ^= randomState_ >> 7;
+    randomState_ ^= randomState_ << 17;
+    return static_cast<size_t>(randomState_ % pool_->stealingWorkers_.size());
+}
+
+ThreadPool::StealingWorker::TaskNode *ThreadPool::StealingWorker::stealFromOthers()
+{
+    auto &workers = pool_->stealingWorkers_;
+    size_t workerNum = workers.size();
+    if (workerNum <= 1) {
+        return nullptr;
+    }
+
+    // start from a random victim and try every one once.
+    size_t start = randomIndex();
+    for (size_t i = 0; i < workerNum; ++i) {
+        size_t victim = (start + i) % workerNum;
+        if (victim == index_) {
+            continue;
+        }
+        if (TaskNode *node = workers[victim]->steal()) {
+            stolenCount_.fetch_add(1, std::memory_order_relaxed);
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+ThreadPool::StealingWorker::TaskNode *ThreadPool::StealingWorker::findTask()
+{
+    if (TaskNode *node = deque_.pop()) {
+        return node;
+    }
+    if (drainInbox() > 0) {
+        return deque_.pop();
+    }
+    return stealFromOthers();
+}
+
+void ThreadPool::StealingWorker::park()
+{
+    sleeping_.store(true, std::memory_order_seq_cst);
+    pool_->sleepingWorkers_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // check again after announcing sleeping, the tasks posted before it are visible now.
+    bool hasTask = inbox_.load(std::memory_order_acquire) != nullptr;
+    for (size_t i = 0; !hasTask && i < pool_->stealingWorkers_.size(); ++i) {
+        hasTask = !pool_->stealingWorkers_[i]->deque_.empty();
+    }
+
+    if (!hasTask) {
+        std::unique_lock<std::mutex> lock(parkMutex_);
+        parkCond_.wait(lock, [this]() { return notified_ || !running_; });
+        notified_ = false;
+    }
+
+    sleeping_.store(false, std::memory_order_relaxed);
+    pool_->sleepingWorkers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ThreadPool::StealingWorker::threadMain()
+{
+    if (cpu_ >= 0) {
+        pinCurrentThread(cpu_);
+    }
+    currentStealingWorker() = this;
+
+    while (running_) {
+        TaskNode *node = findTask();
+        if (node == nullptr) {
+            park();
+            continue;
+        }
+
+#ifdef ENABLE_EXCEPTION
+        try {
+            node->task();
+        } catch (const std::exception &e) {
+            LOG_ERROR << "Thread " << name_ << " execute task failed: " << e.what() << ".";
+        } catch (...) {
+            LOG_ERROR << "Thread " << name_ << " execute task failed.";
+            delete node;
+            throw; // rethrow
+        }
+#else
+        node->task();
+#endif // ENABLE_EXCEPTION
+        delete node;
+        executedCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    currentStealingWorker() = nullptr;
+    LOG_INFO << "Thread " << name_ << " stopped.";
+}
+
 ThreadPool::ThreadPool() : ThreadPool("WindThreadPool") {}
 
 ThreadPool::ThreadPool(std::string name) : name_(std::move(name)) {}
@@ -176,10 +530,22 @@ void ThreadPool::stop() noexcept
 
     running_ = false;
 
+    // join the workers out of the lock, a retiring one may be waiting for it.
+    std::unordered_map<ThreadId, std::unique_ptr<TaskWorker>> workers;
+    std::vector<std::unique_ptr<TaskWorker>> retiredWorkers;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        workers_.clear();
+        workers.swap(workers_);
+        retiredWorkers.swap(retiredWorkers_);
     }
+    workers.clear();
+    retiredWorkers.clear();
+    clearOverflowTasks();
+
+    for (auto &worker : stealingWorkers_) {
+        worker->stop();
+    }
+    stealingWorkers_.clear();
 
     LOG_INFO << "ThreadPool(name: " << name_ << ") stopped.";
 }
@@ -190,6 +556,73 @@ void ThreadPool::setThreadNum(size_t threadNum)
 
     std::lock_guard<std::mutex> lock(mutex_);
     threadNum_ = threadNum;
+    maxThreadNum_ = threadNum;
+}
+
+void ThreadPool::setThreadNumRange(size_t minThreadNum, size_t maxThreadNum)
+{
+    assertIsNotRunning();
+    LOG_FATAL_IF(minThreadNum > maxThreadNum)
+        << "ThreadPool(name: " << name_ << "): minThreadNum(" << minThreadNum << ") > maxThreadNum(" << maxThreadNum
+        << ")!";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    threadNum_ = minThreadNum;
+    maxThreadNum_ = maxThreadNum;
+}
+
+void ThreadPool::setSpawnLatency(TimeType latency)
+{
+    assertIsNotRunning();
+    spawnLatency_ = latency;
+}
+
+void ThreadPool::setKeepAliveTime(TimeType keepAliveTime)
+{
+    assertIsNotRunning();
+    keepAliveTime_ = keepAliveTime;
+}
+
+size_t ThreadPool::threadNum() const
+{
+    if (mode_ == ThreadPoolMode::WORK_STEALING) {
+        return stealingWorkers_.size();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return workers_.size();
+}
+
+void ThreadPool::setMode(ThreadPoolMode mode)
+{
+    assertIsNotRunning();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    mode_ = mode;
+}
+
+void ThreadPool::setAffinity(AffinityPolicy policy, std::vector<int> coreList)
+{
+    assertIsNotRunning();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    affinityPolicy_ = policy;
+    coreList_ = std::move(coreList);
+}
+
+void ThreadPool::setOverloadPolicy(OverloadPolicy policy)
+{
+    overloadPolicy_.store(policy, std::memory_order_relaxed);
+}
+
+OverloadStats ThreadPool::overloadStats() const
+{
+    OverloadStats stats;
+    stats.rejected = rejectedCount_.load(std::memory_order_relaxed);
+    stats.callerRuns = callerRunsCount_.load(std::memory_order_relaxed);
+    stats.droppedOldest = droppedOldestCount_.load(std::memory_order_relaxed);
+    stats.spilled = spilledCount_.load(std::memory_order_relaxed);
+    return stats;
 }
 
 void ThreadPool::setTaskQueueCapacity(size_t capacity)
@@ -227,11 +660,15 @@ void ThreadPool::addEmptyWorkerLocked(ThreadId workerId)
 ThreadId ThreadPool::getNextWorker()
 {
     ThreadId selectedWorker = 0;
-    if (!emptyWorkers_.empty()) {
+    while (!emptyWorkers_.empty()) {
         selectedWorker = emptyWorkers_.front();
         emptyWorkers_.pop();
-        return selectedWorker;
+        // may be retired already.
+        if (workers_.count(selectedWorker) != 0) {
+            return selectedWorker;
+        }
     }
+    selectedWorker = 0;
 
     double minLoad = 100.0;
     for (const auto &[id, worker] : workers_) {
@@ -253,18 +690,341 @@ ThreadId ThreadPool::getNextWorker()
     return selectedWorker;
 }
 
-void ThreadPool::runTask(Task task)
+TaskSubmitResult ThreadPool::runTask(Task task)
+{
+    assertIsRunning();
+
+    if (mode_ == ThreadPoolMode::WORK_STEALING) {
+        return runTaskStealing(std::move(task));
+    }
+    return submitTask(task, true);
+}
+
+TaskSubmitResult ThreadPool::tryRunTask(Task &&task)
 {
     assertIsRunning();
 
+    if (mode_ == ThreadPoolMode::WORK_STEALING) {
+        return runTaskStealing(std::move(task));
+    }
+    return submitTask(task, false);
+}
+
+void ThreadPool::runTasks(std::vector<Task> tasks)
+{
+    assertIsRunning();
+
+    size_t posted = mode_ == ThreadPoolMode::WORK_STEALING ? postTasksStealing(tasks) : postTasks(tasks);
+    for (size_t i = posted; i < tasks.size(); ++i) {
+        runTask(std::move(tasks[i]));
+    }
+}
+
+size_t ThreadPool::postTasks(std::vector<Task> &tasks)
+{
     std::lock_guard<std::mutex> lock(mutex_);
-    if (workers_.empty()) {
+    if (workers_.empty() || (overloadPolicy() == OverloadPolicy::SPILL && hasOverflowTasks())) {
+        return 0;
+    }
+
+    // share the rest evenly among the workers not visited yet, a full worker leaves its share to the next ones.
+    size_t posted = 0;
+    size_t workersLeft = workers_.size();
+    for (auto &[_, worker] : workers_) {
+        size_t rest = tasks.size() - posted;
+        if (rest == 0) {
+            break;
+        }
+        size_t share = (rest + workersLeft - 1) / workersLeft;
+        posted += worker->tryPostTasks(tasks.data() + posted, share);
+        --workersLeft;
+    }
+    return posted;
+}
+
+namespace detail {
+struct ChunkState {
+    ChunkState(size_t chunkNum, void (*chunkFunc)(void *, size_t), void *context)
+        : chunkNum(chunkNum), chunkFunc(chunkFunc), context(context)
+    {}
+
+    // Claim and run the chunks until none left, return true if the last chunk is finished by this call.
+    // The late ones claim nothing, so they never touch the context which may be gone.
+    bool runChunks()
+    {
+        size_t done = 0;
+        for (size_t chunk = nextChunk.fetch_add(1); chunk < chunkNum; chunk = nextChunk.fetch_add(1)) {
+            chunkFunc(context, chunk);
+            ++done;
+        }
+        return done > 0 && doneChunks.fetch_add(done, std::memory_order_acq_rel) + done == chunkNum;
+    }
+
+    const size_t chunkNum;
+    void (*const chunkFunc)(void *, size_t);
+    void *const context;
+    std::atomic<size_t> nextChunk = 0;
+    std::atomic<size_t> doneChunks = 0;
+
+    std::mutex mutex;
+    std::condition_variable doneCond;
+    bool finished = false;
+};
+} // namespace detail
+
+void ThreadPool::runChunks(size_t chunkNum, void (*chunkFunc)(void *, size_t), void *context)
+{
+    assertIsRunning();
+
+    size_t helperNum = std::min(threadNum_, chunkNum - 1);
+    if (helperNum == 0) {
+        for (size_t chunk = 0; chunk < chunkNum; ++chunk) {
+            chunkFunc(context, chunk);
+        }
+        return;
+    }
+
+    // the helpers may start after we return, they own the state with us.
+    auto state = std::make_shared<detail::ChunkState>(chunkNum, chunkFunc, context);
+    std::vector<Task> helpers;
+    helpers.reserve(helperNum);
+    for (size_t i = 0; i < helperNum; ++i) {
+        helpers.emplace_back([state]() {
+            if (state->runChunks()) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished = true;
+                state->doneCond.notify_one();
+            }
+        });
+    }
+    // the helpers not fitting in the queues are dropped, we do their part.
+    if (mode_ == ThreadPoolMode::WORK_STEALING) {
+        postTasksStealing(helpers);
+    } else {
+        postTasks(helpers);
+    }
+
+    if (!state->runChunks()) {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->doneCond.wait(lock, [&state]() { return state->finished; });
+    }
+}
+
+TaskSubmitResult ThreadPool::submitTask(Task &task, bool mayBlock)
+{
+    auto policy = overloadPolicy();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (workers_.empty() && !isElastic()) {
+        lock.unlock();
         LOG_INFO << "There is no any thread in threadPool(name: " << name_
                  << "), run the task in current thread immediately.";
         task();
+        return TaskSubmitResult::RAN_IN_CALLER;
+    }
+
+    // keep the order: the new tasks queue up behind the spilled ones until the overflow is drained.
+    if (policy == OverloadPolicy::SPILL && hasOverflowTasks()) {
+        lock.unlock();
+        spillTask(std::move(task));
+        return TaskSubmitResult::SPILLED;
+    }
+
+    auto *worker = workers_.empty() ? nullptr : workers_.at(getNextWorker()).get();
+    if (isElastic()) {
+        worker = maybeSpawnWorkerLocked(worker);
+    }
+    if (worker->tryPostTask(task)) {
+        return TaskSubmitResult::QUEUED;
+    }
+
+    switch (policy) {
+        case OverloadPolicy::BLOCK:
+            if (mayBlock) {
+                worker->postTask(std::move(task));
+                return TaskSubmitResult::QUEUED;
+            }
+            [[fallthrough]];
+        case OverloadPolicy::REJECT:
+            rejectedCount_.fetch_add(1, std::memory_order_relaxed);
+            return TaskSubmitResult::REJECTED;
+        case OverloadPolicy::CALLER_RUNS:
+            lock.unlock();
+            callerRunsCount_.fetch_add(1, std::memory_order_relaxed);
+            task();
+            return TaskSubmitResult::RAN_IN_CALLER;
+        case OverloadPolicy::DROP_OLDEST: {
+            auto oldest = worker->replaceOldestTask(std::move(task));
+            lock.unlock();
+            droppedOldestCount_.fetch_add(1, std::memory_order_relaxed);
+            // the dropped task is destroyed out of the lock.
+            oldest = nullptr;
+            return TaskSubmitResult::DROPPED_OLDEST;
+        }
+        case OverloadPolicy::SPILL:
+            lock.unlock();
+            spillTask(std::move(task));
+            return TaskSubmitResult::SPILLED;
+    }
+    return TaskSubmitResult::REJECTED;
+}
+
+ThreadPool::TaskWorker *ThreadPool::startWorkerLocked()
+{
+    size_t index = nextWorkerIndex_++;
+    int cpu = CpuTopology::system().cpuFor(affinityPolicy_, index, coreList_);
+    auto worker = std::make_unique<TaskWorker>(this, name_ + "_" + std::to_string(index), cpu);
+    worker->setTaskCapacity(taskQueueCapacity_);
+    auto tid = worker->start();
+    LOG_FATAL_IF(tid <= 0) << "Failed to start a worker in ThreadPool(name: " << name_ << ")!";
+
+    auto *result = worker.get();
+    workers_[tid] = std::move(worker);
+    return result;
+}
+
+ThreadPool::TaskWorker *ThreadPool::maybeSpawnWorkerLocked(TaskWorker *selected)
+{
+    // no worker with minThreadNum 0, spawn one anyway.
+    if (selected != nullptr && workers_.size() >= maxThreadNum_) {
+        spawnRequestLatency_.store(0, std::memory_order_relaxed);
+        return selected;
+    }
+
+    // the latency seen by the workers at dequeue, or the age of the oldest task of the least loaded worker,
+    // in case all the workers are stuck in long tasks and dequeue nothing.
+    TimeType latency = spawnRequestLatency_.exchange(0, std::memory_order_relaxed);
+    if (latency == 0 && selected != nullptr) {
+        latency = selected->oldestTaskAge(TimeStamp::now());
+        if (latency <= spawnLatency_) {
+            return selected;
+        }
+    }
+    return spawnWorkerLocked(latency);
+}
+
+void ThreadPool::trySpawnWorker()
+{
+    if (spawnRequestLatency_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    // never wait for the lock: the submitter holding it handles the request, and it may be waiting for a worker
+    // to make room in a full queue.
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || !isRunning()) {
+        return;
+    }
+
+    TimeType latency = spawnRequestLatency_.exchange(0, std::memory_order_relaxed);
+    if (latency != 0 && workers_.size() < maxThreadNum_) {
+        spawnWorkerLocked(latency);
+    }
+}
+
+ThreadPool::TaskWorker *ThreadPool::spawnWorkerLocked(TimeType latency)
+{
+    // the queues are not shared, take over half of the backlog of the most loaded worker.
+    TaskWorker *mostLoaded = nullptr;
+    size_t maxQueueSize = 0;
+    for (const auto &[_, worker] : workers_) {
+        auto queueSize = worker->getQueueSize();
+        if (queueSize > maxQueueSize) {
+            maxQueueSize = queueSize;
+            mostLoaded = worker.get();
+        }
+    }
+
+    auto *worker = startWorkerLocked();
+    if (mostLoaded != nullptr) {
+        mostLoaded->handOverTasks(*worker, maxQueueSize / 2);
+    }
+    spawnedCount_.fetch_add(1, std::memory_order_relaxed);
+    if (latency == 0) {
+        LOG_INFO << "ThreadPool(name: " << name_ << ") spawned worker " << worker->name() << ": no worker running.";
     } else {
-        auto workerId = getNextWorker();
-        workers_.at(workerId)->postTask(std::move(task));
+        LOG_INFO << "ThreadPool(name: " << name_ << ") spawned worker " << worker->name() << ": queue latency "
+                 << latency << "us > " << spawnLatency_ << "us, took over " << maxQueueSize / 2 << " tasks, "
+                 << workers_.size() << " workers now.";
+    }
+    return worker;
+}
+
+void ThreadPool::noteQueueLatency(TimeType latency)
+{
+    lastQueueLatency_.store(latency, std::memory_order_relaxed);
+    if (latency > spawnLatency_) {
+        spawnRequestLatency_.store(latency, std::memory_order_relaxed);
+    }
+}
+
+bool ThreadPool::retireWorker(TaskWorker *worker)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isRunning() || workers_.size() <= threadNum_ || !worker->isEmpty()) {
+        return false;
+    }
+
+    auto iter = workers_.find(worker->tid());
+    if (iter == workers_.end()) {
+        return false;
+    }
+
+    // the ones retired before have left their loop, joining them is quick.
+    retiredWorkers_.clear();
+    retiredWorkers_.push_back(std::move(iter->second));
+    workers_.erase(iter);
+    retiredCount_.fetch_add(1, std::memory_order_relaxed);
+    LOG_INFO << "ThreadPool(name: " << name_ << ") retired worker " << worker->name() << ": idle for "
+             << keepAliveTime_ << "us, " << workers_.size() << " workers now.";
+    return true;
+}
+
+void ThreadPool::spillTask(Task task)
+{
+    size_t oldSize = 0;
+    {
+        std::lock_guard<std::mutex> lock(overflowMutex_);
+        overflowTasks_.push(std::move(task));
+        oldSize = overflowSize_.fetch_add(1, std::memory_order_release);
+    }
+    spilledCount_.fetch_add(1, std::memory_order_relaxed);
+
+    // the workers keep checking the overflow queue while it is not empty, only wake them up when it becomes non-empty.
+    if (oldSize == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &[_, worker] : workers_) {
+            worker->wakeUp();
+        }
+    }
+}
+
+ThreadPool::Task ThreadPool::takeOverflowTask()
+{
+    if (!hasOverflowTasks()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(overflowMutex_);
+    if (overflowTasks_.empty()) {
+        return nullptr;
+    }
+    auto task = std::move(overflowTasks_.front());
+    overflowTasks_.pop();
+    overflowSize_.fetch_sub(1, std::memory_order_release);
+    return task;
+}
+
+void ThreadPool::clearOverflowTasks()
+{
+    std::queue<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(overflowMutex_);
+        tasks.swap(overflowTasks_);
+        overflowSize_.store(0, std::memory_order_release);
+    }
+    if (!tasks.empty()) {
+        LOG_WARN << "ThreadPool(name: " << name_ << ") dropped " << tasks.size() << " spilled tasks on stopping.";
     }
 }
 
@@ -277,22 +1037,118 @@ void ThreadPool::start()
 
     running_ = true;
 
+    if (mode_ == ThreadPoolMode::WORK_STEALING) {
+        startStealingWorkers();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
     for (size_t i = 0; i != threadNum_; ++i) {
-        auto worker = std::make_unique<TaskWorker>(name_ + "_" + std::to_string(i));
-        worker->setTaskCapacity(taskQueueCapacity_);
-        auto tid = worker->start();
-        LOG_FATAL_IF(tid <= 0) << "Failed to start a worker in ThreadPool(name: " << name_ << ")!";
+        addEmptyWorkerLocked(startWorkerLocked()->tid());
+    }
+}
 
-        std::lock_guard<std::mutex> lock(mutex_);
-        workers_[tid] = std::move(worker);
-        addEmptyWorkerLocked(tid);
+ThreadPool::StealingWorker *&ThreadPool::currentStealingWorker()
+{
+    static thread_local StealingWorker *worker = nullptr;
+    return worker;
+}
+
+void ThreadPool::startStealingWorkers()
+{
+    // all the workers are created before any of them starts, they look up each other for stealing.
+    for (size_t i = 0; i != threadNum_; ++i) {
+        int cpu = CpuTopology::system().cpuFor(affinityPolicy_, i, coreList_);
+        stealingWorkers_.push_back(std::make_unique<StealingWorker>(this, i, name_ + "_" + std::to_string(i), cpu));
+    }
+    for (auto &worker : stealingWorkers_) {
+        worker->start();
+    }
+}
+
+TaskSubmitResult ThreadPool::runTaskStealing(Task task)
+{
+    if (stealingWorkers_.empty()) {
+        LOG_INFO << "There is no any thread in threadPool(name: " << name_
+                 << "), run the task in current thread immediately.";
+        task();
+        return TaskSubmitResult::RAN_IN_CALLER;
+    }
+
+    StealingWorker *current = currentStealingWorker();
+    if (current != nullptr && current->pool() == this) {
+        current->pushLocal(std::move(task));
+        return TaskSubmitResult::QUEUED;
+    }
+
+    // prefer a sleeping worker, or round robin.
+    size_t workerNum = stealingWorkers_.size();
+    size_t start = nextStealingWorker_.fetch_add(1, std::memory_order_relaxed);
+    size_t target = start % workerNum;
+    if (sleepingWorkers_.load(std::memory_order_relaxed) > 0) {
+        for (size_t i = 0; i < workerNum; ++i) {
+            size_t index = (start + i) % workerNum;
+            if (stealingWorkers_[index]->isSleeping()) {
+                target = index;
+                break;
+            }
+        }
+    }
+    stealingWorkers_[target]->postTask(std::move(task));
+    return TaskSubmitResult::QUEUED;
+}
+
+size_t ThreadPool::postTasksStealing(std::vector<Task> &tasks)
+{
+    if (stealingWorkers_.empty()) {
+        return 0;
+    }
+
+    StealingWorker *current = currentStealingWorker();
+    if (current != nullptr && current->pool() == this) {
+        for (auto &task : tasks) {
+            current->pushLocal(std::move(task));
+        }
+        return tasks.size();
+    }
+
+    // a contiguous share for every worker, starting from the round robin one.
+    size_t workerNum = stealingWorkers_.size();
+    size_t start = nextStealingWorker_.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < workerNum; ++i) {
+        size_t first = tasks.size() * i / workerNum;
+        size_t last = tasks.size() * (i + 1) / workerNum;
+        if (first != last) {
+            stealingWorkers_[(start + i) % workerNum]->postTasks(tasks.data() + first, last - first);
+        }
+    }
+    return tasks.size();
+}
+
+void ThreadPool::wakeUpStealer(size_t except)
+{
+    size_t workerNum = stealingWorkers_.size();
+    size_t start = nextStealingWorker_.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < workerNum; ++i) {
+        size_t index = (start + i) % workerNum;
+        if (index != except && stealingWorkers_[index]->wakeUp()) {
+            return;
+        }
     }
 }
 
 size_t ThreadPool::taskSize() const
 {
+    if (mode_ == ThreadPoolMode::WORK_STEALING) {
+        size_t taskNum = 0;
+        for (const auto &worker : stealingWorkers_) {
+            taskNum += worker->taskSize();
+        }
+        return taskNum;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
-    size_t taskNum = 0;
+    size_t taskNum = overflowSize_.load(std::memory_order_relaxed);
     for (const auto &[_, worker] : workers_) {
         taskNum += worker->getQueueSize();
     }
@@ -301,6 +1157,12 @@ size_t ThreadPool::taskSize() const
 
 void ThreadPool::dump(std::string &out) const
 {
+    if (mode_ == ThreadPoolMode::WORK_STEALING) {
+        dumpStealingWorkers(out);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
     out += "    name        | queue size | queue capacity |   load(%)  |    ready time  \n";
     for (const auto &[_, worker] : workers_) {
         auto queueSize = worker->getQueueSize();
@@ -311,6 +1173,33 @@ void ThreadPool::dump(std::string &out) const
              "   |   " + std::to_string(load) + "    |   " + worker->readyTime().toFormattedString());
         out += "\n";
     }
+
+    auto stats = overloadStats();
+    out +=
+        ("overflow size: " + std::to_string(overflowSize_.load(std::memory_order_relaxed)) +
+         ", rejected: " + std::to_string(stats.rejected) + ", caller runs: " + std::to_string(stats.callerRuns) +
+         ", dropped oldest: " + std::to_string(stats.droppedOldest) + ", spilled: " + std::to_string(stats.spilled));
+    out += "\n";
+    if (isElastic()) {
+        out +=
+            ("threads: " + std::to_string(workers_.size()) + " (" + std::to_string(threadNum_) + " ~ " +
+             std::to_string(maxThreadNum_) + "), spawned: " + std::to_string(spawnedCount_.load()) +
+             ", retired: " + std::to_string(retiredCount_.load()) +
+             ", queue latency: " + std::to_string(lastQueueLatency_.load()) + "us (spawn over " +
+             std::to_string(spawnLatency_) + "us), keep alive: " + std::to_string(keepAliveTime_) + "us");
+        out += "\n";
+    }
+}
+
+void ThreadPool::dumpStealingWorkers(std::string &out) const
+{
+    out += "    name        | queue size |    executed    |    stolen  \n";
+    for (const auto &worker : stealingWorkers_) {
+        out +=
+            (worker->name() + "  |   " + std::to_string(worker->taskSize()) + "  |   " +
+             std::to_string(worker->executedCount()) + "   |   " + std::to_string(worker->stolenCount()));
+        out += "\n";
+    }
 }
 } // namespace base
 } // namespace wind
@@ -22,20 +22,66 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <future>
 #include <mutex>
 #include <queue>
 #include <unordered_map>
+#include <vector>
 
+#include "CpuTopology.h"
 #include "Thread.h"
 #include "TimeStamp.h"
+#include "UniqueFunction.h"
+#include "WorkStealingDeque.h"
 
 namespace wind {
 namespace base {
+enum class ThreadPoolMode {
+    // every worker has a bounded queue, a task goes to the least loaded worker, runTask() blocks if it is full.
+    BALANCED,
+    // every worker has a lock-free deque, tasks posted by the workers stay local, the others are spread
+    // to the workers' inboxes without any lock, and the idle workers steal from random victims.
+    // The queues are unbounded, runTask() never blocks.
+    WORK_STEALING,
+};
+
+// What to do with a new task when all the workers' queues are full, only for BALANCED mode.
+enum class OverloadPolicy {
+    // runTask() waits until a queue has room, tryRunTask() rejects the task.
+    BLOCK,
+    // the task is not run.
+    REJECT,
+    // run the task in the calling thread.
+    CALLER_RUNS,
+    // discard the oldest queued task of a full worker to make room for the new one.
+    DROP_OLDEST,
+    // put the task into an unbounded overflow queue, the workers drain it when their own queues are empty.
+    SPILL,
+};
+
+enum class TaskSubmitResult {
+    QUEUED,
+    REJECTED,
+    RAN_IN_CALLER,
+    DROPPED_OLDEST,
+    SPILLED,
+};
+
+struct OverloadStats {
+    uint64_t rejected = 0;
+    uint64_t callerRuns = 0;
+    uint64_t droppedOldest = 0;
+    uint64_t spilled = 0;
+};
+
 class ThreadPool : NonCopyable {
-    using Task = std::function<void()>;
+    using Task = UniqueFunction<void()>;
     static constexpr size_t DEFAULT_TASK_QUEUE_CAPACITY = 16;
+    static constexpr TimeType DEFAULT_SPAWN_LATENCY = 10 * MICRO_SECS_PER_MILLISECOND;
+    static constexpr TimeType DEFAULT_KEEP_ALIVE_TIME = 60 * MICRO_SECS_PER_SECOND;
 
 public:
     ThreadPool();
@@ -53,7 +99,34 @@ public:
     }
 
     void setThreadNum(size_t threadNum);
+    // Elastic sizing, only for BALANCED mode, should be called before start().
+    // The pool starts with minThreadNum workers, spawns more up to maxThreadNum when the tasks wait in the
+    // queues longer than the spawn latency, and retires the workers idle for the keep alive time.
+    void setThreadNumRange(size_t minThreadNum, size_t maxThreadNum);
+    // in micro seconds.
+    void setSpawnLatency(TimeType latency);
+    // in micro seconds.
+    void setKeepAliveTime(TimeType keepAliveTime);
+    // Count of the running workers.
+    size_t threadNum() const;
+    // Only for BALANCED mode.
     void setTaskQueueCapacity(size_t capacity);
+    // Should be called before start().
+    void setMode(ThreadPoolMode mode);
+    ThreadPoolMode mode() const
+    {
+        return mode_;
+    }
+    // Placement of the workers, should be called before start(). The memory first touched by a pinned worker
+    // is allocated on its NUMA node. @coreList: only for AffinityPolicy::CORE_LIST.
+    void setAffinity(AffinityPolicy policy, std::vector<int> coreList = {});
+    // Thread safe, the default is OverloadPolicy::BLOCK.
+    void setOverloadPolicy(OverloadPolicy policy);
+    OverloadPolicy overloadPolicy() const
+    {
+        return overloadPolicy_.load(std::memory_order_relaxed);
+    }
+    OverloadStats overloadStats() const;
 
     bool empty() const
     {
@@ -70,7 +143,75 @@ public:
     // Put task to run in the threadPool.
     // This func can only be called after calling ThreadPool::start(),
     // and can not be called after calling ThreadPool::stop(),
-    void runTask(Task task);
+    // It blocks when all the queues are full and the overload policy is OverloadPolicy::BLOCK.
+    TaskSubmitResult runTask(Task task);
+    // Same as runTask() but never blocks, it is safe to be called in an EventLoop thread.
+    // The task is left untouched if it is rejected.
+    TaskSubmitResult tryRunTask(Task &&task);
+
+    // Put a batch of tasks with one lock and one notify per worker, instead of one per task.
+    // The tasks not fitting in the queues go through runTask() one by one.
+    void runTasks(std::vector<Task> tasks);
+
+    // The future gets a std::future_error(broken_promise) if the task is dropped by the overload policy.
+    template <typename Func, typename Ret = std::invoke_result_t<Func>>
+    std::future<Ret> submit(Func func)
+    {
+        std::packaged_task<Ret()> packagedTask(std::move(func));
+        auto future = packagedTask.get_future();
+        runTask([t(std::move(packagedTask))]() mutable { t(); });
+        return future;
+    }
+
+    // Submit all the callables of funcs by runTasks(), they are moved from if funcs is not const.
+    template <
+        typename Range,
+        typename Func = std::decay_t<decltype(*std::begin(std::declval<Range &>()))>,
+        typename Ret = std::invoke_result_t<Func>>
+    std::vector<std::future<Ret>> submitBatch(Range &&funcs)
+    {
+        std::vector<Task> tasks;
+        std::vector<std::future<Ret>> futures;
+        for (auto &func : funcs) {
+            std::packaged_task<Ret()> packagedTask(std::move(func));
+            futures.push_back(packagedTask.get_future());
+            tasks.emplace_back([t(std::move(packagedTask))]() mutable { t(); });
+        }
+        runTasks(std::move(tasks));
+        return futures;
+    }
+
+    // Call func(i) for every i in [begin, end), in chunks of grain indexes (0 picks one by the thread number).
+    // The calling thread works on the chunks too, and returns when all of them are done. It never waits for
+    // a task not started yet, so it is fine to be called in a task of this pool. func should not throw.
+    template <typename Func>
+    void parallelFor(size_t begin, size_t end, size_t grain, Func &&func)
+    {
+        if (begin >= end) {
+            return;
+        }
+
+        size_t count = end - begin;
+        if (grain == 0) {
+            grain = std::max<size_t>(1, count / (std::max<size_t>(1, threadNum_) * 4));
+        }
+
+        struct Context {
+            size_t begin;
+            size_t end;
+            size_t grain;
+            std::remove_reference_t<Func> *func;
+        } context{begin, end, grain, &func};
+        auto chunkFunc = [](void *ctx, size_t chunk) {
+            auto *context = static_cast<Context *>(ctx);
+            size_t first = context->begin + chunk * context->grain;
+            size_t last = std::min(context->end, first + context->grain);
+            for (size_t i = first; i < last; ++i) {
+                (*context->func)(i);
+            }
+        };
+        runChunks((count + grain - 1) / grain, chunkFunc, &context);
+    }
 
     // Dump all workers' infomation.
     void dump(std::string &out) const;
@@ -85,12 +226,42 @@ private:
     void addEmptyWorkerLocked(ThreadId workerId);
     void addEmptyWorker(ThreadId workerId);
     ThreadId getNextWorker();
+    TaskSubmitResult submitTask(Task &task, bool mayBlock);
+    // Post the tasks from the front as many as the queues can hold without blocking, return the count posted.
+    size_t postTasks(std::vector<Task> &tasks);
+    // Run chunkFunc(context, chunk) for every chunk in [0, chunkNum) on the workers and the calling thread.
+    void runChunks(size_t chunkNum, void (*chunkFunc)(void *, size_t), void *context);
+
+    class TaskWorker;
+    bool isElastic() const
+    {
+        return maxThreadNum_ > threadNum_;
+    }
+    // Called with mutex_ locked.
+    TaskWorker *startWorkerLocked();
+    // Called by the submitters with mutex_ locked, return the worker to post to, a new one or the selected one
+    // which may be nullptr if there is no worker.
+    TaskWorker *maybeSpawnWorkerLocked(TaskWorker *selected);
+    TaskWorker *spawnWorkerLocked(TimeType latency);
+    // Called by the workers.
+    void noteQueueLatency(TimeType latency);
+    void trySpawnWorker();
+    // Called by a worker idle for the keep alive time, return true if it is retired and should exit.
+    bool retireWorker(TaskWorker *worker);
 
     mutable std::mutex mutex_;
+    ThreadPoolMode mode_ = ThreadPoolMode::BALANCED;
+    std::atomic<OverloadPolicy> overloadPolicy_ = OverloadPolicy::BLOCK;
 
     class TaskWorker : NonCopyable {
     public:
-        explicit TaskWorker(std::string name);
+        struct QueuedTask {
+            Task task;
+            TimeStamp enqueueTime;
+        };
+
+        // @cpu: -1 for no pinning.
+        TaskWorker(ThreadPool *pool, std::string name, int cpu);
         ~TaskWorker() noexcept;
 
         const std::string &name() const
@@ -122,7 +293,23 @@ private:
         }
 
         ThreadId start();
+        ThreadId tid() const
+        {
+            return tid_;
+        }
         void postTask(Task task);
+        // Return false and leave the task untouched if the queue is full.
+        bool tryPostTask(Task &task);
+        // Post at most count tasks the queue can hold, return the count posted.
+        size_t tryPostTasks(Task *tasks, size_t count);
+        // Queue the task even if the queue is full, return the oldest one which is discarded.
+        Task replaceOldestTask(Task task);
+        // Wake up the worker if it is waiting for tasks, to check the overflow queue.
+        void wakeUp();
+        // How long the oldest task has been waiting, 0 if the queue is empty or the pool is not elastic.
+        TimeType oldestTaskAge(TimeStamp now) const;
+        // Move at most count tasks from the front of the queue to the new worker, regardless of its capacity.
+        void handOverTasks(TaskWorker &to, size_t count);
 
         TimeStamp readyTime() const
         {
@@ -131,8 +318,11 @@ private:
 
     private:
         void stop() noexcept;
-        Task fetchTask();
+        // idleTimeout is set if no task comes in the keep alive time.
+        Task fetchTask(bool &idleTimeout);
         void threadMain();
+        // only recorded when the pool is elastic.
+        TimeStamp enqueueTime() const;
 
         bool isFullLocked() const
         {
@@ -151,7 +341,9 @@ private:
             return taskQueueCapacity_;
         }
 
+        ThreadPool *pool_ = nullptr;
         std::string name_;
+        int cpu_ = -1;
 
         mutable std::mutex mutex_;
         std::condition_variable initCond_;
@@ -162,7 +354,7 @@ private:
         ThreadId tid_ = 0;
         Thread thread_;
 
-        std::queue<Task> tasks_;
+        std::queue<QueuedTask> tasks_;
         size_t taskQueueCapacity_ = ThreadPool::DEFAULT_TASK_QUEUE_CAPACITY;
 
         TimeStamp readyTime_;
@@ -170,9 +362,145 @@ private:
     friend class TaskWorker;
     std::unordered_map<ThreadId, std::unique_ptr<TaskWorker>> workers_;
     std::queue<ThreadId> emptyWorkers_;
+    // joined by the next retiring worker or stop().
+    std::vector<std::unique_ptr<TaskWorker>> retiredWorkers_;
+    size_t nextWorkerIndex_ = 0;
+
+    size_t maxThreadNum_ = 0;
+    TimeType spawnLatency_ = DEFAULT_SPAWN_LATENCY;
+    TimeType keepAliveTime_ = DEFAULT_KEEP_ALIVE_TIME;
+    // the latest queue latency over spawnLatency_ seen by the workers, 0 if none since the last spawn.
+    std::atomic<TimeType> spawnRequestLatency_ = 0;
+    std::atomic<TimeType> lastQueueLatency_ = 0;
+    std::atomic<uint64_t> spawnedCount_ = 0;
+    std::atomic<uint64_t> retiredCount_ = 0;
+
+    // Overflow queue of OverloadPolicy::SPILL.
+    bool hasOverflowTasks() const
+    {
+        return overflowSize_.load(std::memory_order_acquire) > 0;
+    }
+    void spillTask(Task task);
+    Task takeOverflowTask();
+    void clearOverflowTasks();
+
+    std::mutex overflowMutex_;
+    std::queue<Task> overflowTasks_;
+    std::atomic<size_t> overflowSize_ = 0;
+
+    std::atomic<uint64_t> rejectedCount_ = 0;
+    std::atomic<uint64_t> callerRunsCount_ = 0;
+    std::atomic<uint64_t> droppedOldestCount_ = 0;
+    std::atomic<uint64_t> spilledCount_ = 0;
+
+    // Worker of WORK_STEALING mode.
+    class StealingWorker : NonCopyable {
+    public:
+        // A task is allocated once when it is submitted and freed after it runs,
+        // it is linked in the inbox first, then the deques only move the pointer.
+        struct TaskNode {
+            explicit TaskNode(Task &&t) : task(std::move(t)) {}
+
+            Task task;
+            TaskNode *next = nullptr;
+        };
+
+        StealingWorker(ThreadPool *pool, size_t index, std::string name, int cpu);
+        ~StealingWorker() noexcept;
+
+        const std::string &name() const
+        {
+            return name_;
+        }
+        const ThreadPool *pool() const
+        {
+            return pool_;
+        }
+
+        void start();
+        void stop() noexcept;
+
+        // Called by the owner thread.
+        void pushLocal(Task task);
+        // Thread safe.
+        void postTask(Task task);
+        void postTasks(Task *tasks, size_t count);
+        TaskNode *steal()
+        {
+            return deque_.steal();
+        }
+        bool isSleeping() const
+        {
+            return sleeping_.load(std::memory_order_seq_cst);
+        }
+        // Thread safe, return false if it is not sleeping or woken by others already.
+        bool wakeUp();
+
+        // count of tasks not started yet, only a hint.
+        size_t taskSize() const
+        {
+            return deque_.size() + inboxSize_.load(std::memory_order_relaxed);
+        }
+        uint64_t executedCount() const
+        {
+            return executedCount_.load(std::memory_order_relaxed);
+        }
+        uint64_t stolenCount() const
+        {
+            return stolenCount_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void threadMain();
+        TaskNode *findTask();
+        // push the linked nodes to the inbox, thread safe.
+        void pushInbox(TaskNode *first, TaskNode *last);
+        // move the tasks posted by other threads to the deque, return the count moved.
+        size_t drainInbox();
+        TaskNode *stealFromOthers();
+        void park();
+        size_t randomIndex();
+
+        ThreadPool *pool_ = nullptr;
+        size_t index_ = 0;
+        std::string name_;
+        int cpu_ = -1;
+        Thread thread_;
+        std::atomic<bool> running_ = false;
+
+        WorkStealingDeque<TaskNode *> deque_;
+        // the tasks posted by other threads, linked in LIFO order.
+        std::atomic<TaskNode *> inbox_ = nullptr;
+        std::atomic<size_t> inboxSize_ = 0;
+
+        std::mutex parkMutex_;
+        std::condition_variable parkCond_;
+        bool notified_ = false;
+        std::atomic<bool> sleeping_ = false;
+
+        uint64_t randomState_ = 0;
+        std::atomic<uint64_t> executedCount_ = 0;
+        std::atomic<uint64_t> stolenCount_ = 0;
+    };
+    friend class StealingWorker;
+
+    // the StealingWorker of the current thread, or nullptr.
+    static StealingWorker *&currentStealingWorker();
+    void startStealingWorkers();
+    TaskSubmitResult runTaskStealing(Task task);
+    size_t postTasksStealing(std::vector<Task> &tasks);
+    // wake up a sleeping worker to steal the tasks of others, except the one of index except.
+    void wakeUpStealer(size_t except);
+    void dumpStealingWorkers(std::string &out) const;
+
+    std::vector<std::unique_ptr<StealingWorker>> stealingWorkers_;
+    std::atomic<size_t> nextStealingWorker_ = 0;
+    std::atomic<int> sleepingWorkers_ = 0;
 
     size_t threadNum_ = 0;
     size_t taskQueueCapacity_ = DEFAULT_TASK_QUEUE_CAPACITY;
+    AffinityPolicy affinityPolicy_ = AffinityPolicy::NONE;
+    std::vector<int> coreList_;
 };
 } // namespace base
 } // namespace wind
@@ -23,8 +23,11 @@
 #include "TimeStamp.h"
 
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <cinttypes>
+#include <cstring>
+#include <ctime>
+
+#include "Utils.h"
 
 namespace wind {
 namespace base {
@@ -34,6 +37,45 @@ TimeType microSecondsSinceEpoch()
     auto tp = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now());
     return tp.time_since_epoch().count();
 }
+
+// the calendar second and the fraction into it, which is never negative even before the epoch.
+inline void splitMicros(TimeType microSecondsSinceEpoch, TimeType &seconds, TimeType &micros)
+{
+    seconds = microSecondsSinceEpoch / MICRO_SECS_PER_SECOND;
+    micros = microSecondsSinceEpoch % MICRO_SECS_PER_SECOND;
+    if (micros < 0) {
+        seconds -= 1;
+        micros += MICRO_SECS_PER_SECOND;
+    }
+}
+
+// "." and the zero padded fraction of the precision.
+char *appendFraction(char *buf, TimeType micros, TimePrecision precision)
+{
+    TimeType fraction = 0;
+    int digits = 3;
+    if (precision == TimePrecision::MILLI) {
+        fraction = micros / MICRO_SECS_PER_MILLISECOND;
+    } else if (precision == TimePrecision::MICRO) {
+        fraction = micros;
+        digits = 6;
+    }
+
+    *buf++ = '.';
+    for (int i = digits - 1; i >= 0; --i) {
+        buf[i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    return buf + digits;
+}
+
+// the formatted date and time of the second last formatted by the thread.
+struct FormattedSecond {
+    TimeType second = 0;
+    char prefix[MAX_TIME_STRING_SIZE] = {0};
+    size_t len = 0;
+};
+thread_local FormattedSecond t_formattedSecond;
 } // namespace detail
 
 TimeStamp TimeStamp::now() noexcept
@@ -43,58 +85,59 @@ TimeStamp TimeStamp::now() noexcept
 
 std::string TimeStamp::toString(TimePrecision precision) const noexcept
 {
-    TimeType seconds = microSecondsSinceEpoch_ / MICRO_SECS_PER_SECOND;
-    TimeType micros = microSecondsSinceEpoch_ % MICRO_SECS_PER_SECOND;
-
-    std::stringstream ss;
-    ss << seconds << "." << std::setfill('0');
-    switch (precision) {
-        case TimePrecision::SECOND: {
-            ss << std::setw(3) << 0;
-            break;
-        }
-        case TimePrecision::MILLI: {
-            TimeType millis = micros / MICRO_SECS_PER_MILLISECOND;
-            ss << std::setw(3) << millis;
-            break;
-        }
-        case TimePrecision::MICRO: {
-            ss << std::setw(6) << micros;
-            break;
-        }
-        default:
-            break;
+    char buf[MAX_TIME_STRING_SIZE];
+    size_t len = toString(buf, sizeof(buf), precision);
+    return std::string(buf, len);
+}
+
+std::string TimeStamp::toFormattedString(TimePrecision precision) const noexcept
+{
+    char buf[MAX_TIME_STRING_SIZE];
+    size_t len = toFormattedString(buf, sizeof(buf), precision);
+    return std::string(buf, len);
+}
+
+size_t TimeStamp::toString(char *buf, size_t size, TimePrecision precision) const noexcept
+{
+    if (size < MAX_TIME_STRING_SIZE) {
+        return 0;
     }
 
-    return ss.str();
+    // the sign and the magnitude are formatted apart, so that -1 reads "-0.000001".
+    char *end = buf;
+    uint64_t magnitude = static_cast<uint64_t>(microSecondsSinceEpoch_);
+    if (microSecondsSinceEpoch_ < 0) {
+        *end++ = '-';
+        magnitude = 0 - magnitude;
+    }
+    end += ::snprintf(end, size - static_cast<size_t>(end - buf), "%" PRIu64, magnitude / MICRO_SECS_PER_SECOND);
+    end = detail::appendFraction(end, static_cast<TimeType>(magnitude % MICRO_SECS_PER_SECOND), precision);
+    *end = '\0';
+    return static_cast<size_t>(end - buf);
 }
 
-std::string TimeStamp::toFormattedString(TimePrecision precision) const noexcept
+size_t TimeStamp::toFormattedString(char *buf, size_t size, TimePrecision precision) const noexcept
 {
-    TimeType seconds = microSecondsSinceEpoch_ / MICRO_SECS_PER_SECOND;
-    TimeType micros = microSecondsSinceEpoch_ % MICRO_SECS_PER_SECOND;
-
-    std::stringstream ss;
-    ss << std::put_time(::localtime(&seconds), "%F %X") << "." << std::setfill('0');
-    switch (precision) {
-        case TimePrecision::SECOND: {
-            ss << std::setw(3) << 0;
-            break;
-        }
-        case TimePrecision::MILLI: {
-            TimeType millis = micros / MICRO_SECS_PER_MILLISECOND;
-            ss << std::setw(3) << millis;
-            break;
-        }
-        case TimePrecision::MICRO: {
-            ss << std::setw(6) << micros;
-            break;
-        }
-        default:
-            break;
+    if (size < MAX_TIME_STRING_SIZE) {
+        return 0;
+    }
+
+    TimeType seconds = 0;
+    TimeType micros = 0;
+    detail::splitMicros(microSecondsSinceEpoch_, seconds, micros);
+    auto &cache = detail::t_formattedSecond;
+    if (WIND_UNLIKELY(cache.second != seconds || cache.len == 0)) {
+        time_t t = static_cast<time_t>(seconds);
+        struct tm tm {};
+        ::localtime_r(&t, &tm);
+        cache.len = ::strftime(cache.prefix, sizeof(cache.prefix), "%F %X", &tm);
+        cache.second = seconds;
     }
 
-    return ss.str();
+    ::memcpy(buf, cache.prefix, cache.len);
+    char *end = detail::appendFraction(buf + cache.len, micros, precision);
+    *end = '\0';
+    return static_cast<size_t>(end - buf);
 }
 } // namespace base
 } // namespace wind
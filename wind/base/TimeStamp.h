@@ -35,6 +35,9 @@ constexpr int NANO_SECS_PER_SECOND = NANO_SECS_PER_MILLISECOND * MILLI_SECS_PER_
 
 enum class TimePrecision { SECOND, MILLI, MICRO };
 
+// enough for toString() and toFormattedString() of any precision, with the terminating null.
+constexpr size_t MAX_TIME_STRING_SIZE = 32;
+
 // copyable
 class TimeStamp {
 public:
@@ -71,6 +74,13 @@ public:
     std::string toString(TimePrecision precision = TimePrecision::MILLI) const noexcept;
     std::string toFormattedString(TimePrecision precision = TimePrecision::MILLI) const noexcept;
 
+    // Allocation free versions, write the null terminated string to buf.
+    // The date and time of toFormattedString() are cached per thread, and only formatted again when the
+    // second changes, so the logging threads only write the fraction for every line.
+    // @return: the length of the string, 0 if size is less than MAX_TIME_STRING_SIZE.
+    size_t toString(char *buf, size_t size, TimePrecision precision = TimePrecision::MILLI) const noexcept;
+    size_t toFormattedString(char *buf, size_t size, TimePrecision precision = TimePrecision::MILLI) const noexcept;
+
 private:
     TimeType microSecondsSinceEpoch_ = 0;
 };
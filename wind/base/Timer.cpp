@@ -22,26 +22,33 @@
 
 #include "Timer.h"
 
-#include <atomic>
-
 #include "Log.h"
 
 namespace wind {
 namespace base {
 namespace detail {
-uint64_t genSequenceId()
+// Round expireTime up to the coarsest power of 2 boundary within [expireTime, expireTime + slack],
+// timers with close expire times and similar slacks end up with the same expire time.
+TimeStamp applySlack(TimeStamp expireTime, TimeType slack)
 {
-    static std::atomic<uint64_t> id(0);
-    return id.fetch_add(1, std::memory_order_relaxed);
+    if (slack <= 0 || expireTime.get() <= 0) {
+        return expireTime;
+    }
+
+    auto limit = static_cast<uint64_t>(expireTime.get() + slack);
+    auto diff = static_cast<uint64_t>(expireTime.get()) ^ limit;
+    int bit = 63 - __builtin_clzll(diff);
+    auto mask = (1ULL << bit) - 1;
+    return TimeStamp(static_cast<TimeType>(limit & ~mask));
 }
 } // namespace detail
 
-Timer::Timer(TimerCallback callback, TimeStamp expireTime, TimeType interval)
+Timer::Timer(TimerCallback callback, TimeStamp expireTime, TimeType interval, TimeType slack)
     : cb_(std::move(callback)),
-      expireTime_(expireTime),
+      expireTime_(detail::applySlack(expireTime, slack)),
       interval_(interval),
-      repeat_(interval > 0),
-      id_(detail::genSequenceId(), this)
+      slack_(slack),
+      repeat_(interval > 0)
 {}
 
 void Timer::execute()
@@ -58,7 +65,7 @@ void Timer::execute()
 void Timer::restart()
 {
     ASSERT(isRepeat());
-    expireTime_ = timeAdd(TimeStamp::now(), interval_);
+    expireTime_ = detail::applySlack(timeAdd(TimeStamp::now(), interval_), slack_);
 }
 } // namespace base
 } // namespace wind
@@ -22,28 +22,24 @@
 
 #pragma once
 
-#include <functional>
-
 #include "NonCopyable.h"
-#include "TimerId.h"
 #include "TimeStamp.h"
+#include "UniqueFunction.h"
 
 namespace wind {
 namespace base {
-using TimerCallback = std::function<void()>;
+using TimerCallback = UniqueFunction<void()>;
 
 class Timer : NonCopyable {
 public:
     // @callback: TimerCallback
     // @expireTime: expire TimeStamp
     // @interval: interval in micro seconds, 0 for only run once.
-    Timer(TimerCallback callback, TimeStamp expireTime, TimeType interval = 0);
+    // @slack: the timer may be delayed for at most slack micro seconds, so that the timers expiring
+    //         close together are aligned to the same time and handled by one wakeup. 0 for exact.
+    Timer(TimerCallback callback, TimeStamp expireTime, TimeType interval = 0, TimeType slack = 0);
     ~Timer() noexcept = default;
 
-    TimerId id() const
-    {
-        return id_;
-    }
     bool isRepeat() const
     {
         return repeat_;
@@ -63,8 +59,8 @@ private:
     TimerCallback cb_;
     TimeStamp expireTime_;
     TimeType interval_ = 0;
+    TimeType slack_ = 0;
     bool repeat_ = false;
-    TimerId id_;
 };
 } // namespace base
 } // namespace wind
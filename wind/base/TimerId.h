@@ -26,18 +26,29 @@
 
 namespace wind {
 namespace base {
-class Timer;
+// Handle of a timer in the TimerPool of its loop, copyable and cheap.
+// The generation changes every time the pool slot is reused, so a stale TimerId never refers to a new timer.
 struct TimerId {
-    TimerId(uint64_t id, Timer *timer) : id(id), timer(timer) {}
-    uint64_t id = 0;
-    Timer *timer = nullptr;
+    TimerId() = default;
+    TimerId(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+    uint32_t index = 0;
+    uint32_t generation = 0; // 0 is never used by a timer.
+
+    bool valid() const
+    {
+        return generation != 0;
+    }
+    uint64_t value() const
+    {
+        return (static_cast<uint64_t>(generation) << 32) | index;
+    }
     bool operator==(const TimerId &other) const
     {
-        return id == other.id && timer == other.timer;
+        return value() == other.value();
     }
     bool operator<(const TimerId &other) const
     {
-        return id < other.id || timer < other.timer;
+        return value() < other.value();
     }
 };
 } // namespace base
@@ -48,7 +59,7 @@ template <>
 struct hash<typename wind::base::TimerId> {
     size_t operator()(wind::base::TimerId timerId) const
     {
-        return static_cast<size_t>(timerId.id ^ reinterpret_cast<uintptr_t>(timerId.timer));
+        return std::hash<uint64_t>()(timerId.value());
     }
 };
 } // namespace std
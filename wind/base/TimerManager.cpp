@@ -26,6 +26,8 @@
 
 #include "EventLoop.h"
 #include "Log.h"
+#include "SortedTimerManager.h"
+#include "WheelTimerManager.h"
 
 namespace wind {
 namespace base {
@@ -43,6 +45,9 @@ int createTimerFd()
 itimerspec generateTimerSpec(TimeStamp dstTime)
 {
     itimerspec newValue{};
+    if (dstTime == TimeStamp::invalid()) {
+        return newValue; // all zero to disarm the timerFd.
+    }
 
     auto diffMicros = timeDiff(dstTime, TimeStamp::now());
     // set minimum diffMicros to 1 us to make sure the timer can be triggered.
@@ -54,13 +59,29 @@ itimerspec generateTimerSpec(TimeStamp dstTime)
 }
 } // namespace detail
 
-TimerManager::TimerManager(EventLoop *loop)
+std::unique_ptr<TimerManager> TimerManager::create(EventLoop *loop, TimerManagerType type)
+{
+    if (type == TimerManagerType::WHEEL) {
+        return std::make_unique<WheelTimerManager>(loop);
+    }
+
+    return std::make_unique<SortedTimerManager>(loop);
+}
+
+TimerManager::TimerManager(EventLoop *loop, TimerManagerType type)
     : loop_(loop),
+      type_(type),
+      completionIo_(loop_->supportsCompletionIo()),
       timerFd_(detail::createTimerFd()),
       timerFdChannel_(std::make_shared<EventChannel>(timerFd_.get(), loop_))
 {
     timerFdChannel_->setReadCallback([this](TimeStamp t) { handleRead(t); });
-    timerFdChannel_->enableReading();
+    if (completionIo_) {
+        // register the channel with no timeout in flight.
+        timerFdChannel_->submitTimeout(TimeStamp::invalid());
+    } else {
+        timerFdChannel_->enableReading();
+    }
 }
 
 TimerManager::~TimerManager() noexcept
@@ -68,105 +89,123 @@ TimerManager::~TimerManager() noexcept
     timerFdChannel_->disableAll();
 }
 
-TimerId TimerManager::addTimer(TimerCallback callback, TimeStamp expireTime, TimeType interval)
+TimerId TimerManager::addTimer(TimerCallback callback, TimeStamp expireTime, TimeType interval, TimeType slack)
 {
-    auto future = loop_->schedule([=, cb(std::move(callback))]() mutable -> TimerId {
-        auto newTimer = std::make_unique<Timer>(std::move(cb), expireTime, interval);
-        TimerId id = newTimer->id();
-        addTimerInLoop(std::move(newTimer));
-        return id;
-    });
-    return future.get();
+    TimerId timerId = pool_.create(std::move(callback), expireTime, interval, slack);
+    queueOp(TimerOp{timerId, true});
+    return timerId;
 }
 
-void TimerManager::addTimerInLoop(std::unique_ptr<Timer> &&timer)
+void TimerManager::cancelTimer(const TimerId &timerId)
 {
-    ASSERT(timer != nullptr);
-    assertInLoopThread();
-
-    TimeStamp expireTime = timer->expireTime();
-    bool needToResetTimerFd = (timerEntries_.empty() || expireTime < timerEntries_.cbegin()->first);
+    if (!timerId.valid()) {
+        return;
+    }
+    queueOp(TimerOp{timerId, false});
+}
 
-    TimerId timerId = timer->id();
-    timerEntries_.insert(std::make_pair(expireTime, timerId));
-    timers_[timerId] = std::move(timer);
+void TimerManager::queueOp(TimerOp op)
+{
+    if (loop_->isInLoopThread()) {
+        // the queued ones go first, the op may refer to a timer added by other threads.
+        applyPendingOps();
+        applyOp(op);
+        return;
+    }
 
-    if (needToResetTimerFd) {
-        timerFdReset(expireTime);
+    pendingOps_.push(op);
+    if (!opsPending_.exchange(true)) {
+        loop_->queueToLoop([this]() { applyPendingOps(); }, FunctorPriority::HIGH);
     }
 }
 
-void TimerManager::cancelTimer(const TimerId &timerId)
+void TimerManager::applyOp(TimerOp op)
 {
-    loop_->runInLoop([=]() { cancelTimerInLoop(timerId); });
+    if (op.add) {
+        insertTimer(op.timerId.index);
+    } else {
+        cancelTimerInLoop(op.timerId);
+    }
 }
 
 void TimerManager::cancelTimerInLoop(const TimerId &timerId)
 {
-    assertInLoopThread();
-
-    auto timer = timerId.timer;
-    if (timer == nullptr) {
+    // released already, or its slot has been reused.
+    if (pool_.get(timerId) == nullptr) {
         return;
     }
 
-    auto timerEntry = std::make_pair(timer->expireTime(), timerId);
-    if (timers_.count(timerId) == 0 || timerEntries_.count(timerEntry) == 0) {
+    LOG_DEBUG << "Cancel Timer(index: " << timerId.index << ", generation: " << timerId.generation << ").";
+    if (timerId.index == running_) {
+        // cancelled by its own callback, released after the callback returns.
+        runningCancelled_ = true;
         return;
     }
 
-    LOG_DEBUG << "Cancel Timer(id: " << timerId.id << ").";
-    bool needToResetTimerFd = (timerEntry == *timerEntries_.cbegin());
-    timers_.erase(timerId);
-    timerEntries_.erase(timerEntry);
+    removeTimer(timerId.index);
+    pool_.release(timerId.index);
+}
 
-    if (needToResetTimerFd) {
-        timerFdReset(timerEntries_.cbegin()->first);
+bool TimerManager::executeTimer(uint32_t index)
+{
+    Timer &timer = pool_.at(index);
+    running_ = index;
+    runningCancelled_ = false;
+    timer.execute(); // Will implicitly restart the timer if it is repeat.
+    running_ = NO_TIMER;
+
+    if (timer.isRepeat() && !runningCancelled_) {
+        return true;
     }
+
+    pool_.release(index);
+    return false;
 }
 
-void TimerManager::assertInLoopThread()
+void TimerManager::applyPendingOps()
 {
-    ASSERT(loop_ != nullptr);
-    loop_->assertInLoopThread();
+    assertInLoopThread();
+
+    // Must be cleared before consuming, producers which see it set are sure to be consumed this time.
+    opsPending_.exchange(false);
+    if (pendingOps_.empty()) {
+        return;
+    }
+
+    ++batchDepth_;
+    pendingOps_.consumeAll([this](TimerOp op) { applyOp(op); });
+    endBatch();
 }
 
-std::vector<TimerEntry> TimerManager::getExpiredTimers(TimeStamp receivedTime)
+void TimerManager::endBatch()
 {
-    std::vector<TimerEntry> expiredTimers;
-
-    TimerEntry pivot = std::make_pair(receivedTime, TimerId(0, nullptr));
-    auto it = timerEntries_.lower_bound(pivot);
-    ASSERT(receivedTime <= it->first || it == timerEntries_.cend());
-    std::copy(timerEntries_.begin(), it, std::back_inserter(expiredTimers));
-    timerEntries_.erase(timerEntries_.begin(), it);
+    ASSERT(batchDepth_ > 0);
+    if (--batchDepth_ == 0 && batchedReset_) {
+        batchedReset_ = false;
+        timerFdSetTime(batchedExpireTime_);
+    }
+}
 
-    return expiredTimers;
+void TimerManager::assertInLoopThread()
+{
+    ASSERT(loop_ != nullptr);
+    loop_->assertInLoopThread();
 }
 
 void TimerManager::handleRead(TimeStamp receivedTime)
 {
     assertInLoopThread();
-    timerFdRead();
-
-    {
-        auto expiredTimers = getExpiredTimers(receivedTime);
-        for (const auto &[_, timerId] : expiredTimers) {
-            ASSERT(timers_.count(timerId) > 0);
-            auto &timer = timers_.at(timerId);
-            ASSERT(timer != nullptr);
-            timer->execute(); // Will implicitly restart the timer if it is repeat.
-
-            if (timer->isRepeat()) {
-                timerEntries_.insert(std::make_pair(timer->expireTime(), timerId));
-            } else {
-                timers_.erase(timerId);
-            }
-        }
+    loop_->setCallbackType(LoopCallbackType::TIMER);
+    if (!completionIo_) {
+        timerFdRead();
+    } else if (timerFdChannel_->readResult() < 0) {
+        LOG_WARN << "Timeout request of timerFd " << timerFd_.get() << " failed: "
+                 << strerror(-timerFdChannel_->readResult()) << ".";
     }
 
-    auto nextExpiredTime = timerEntries_.cbegin()->first;
-    timerFdReset(nextExpiredTime);
+    ++batchDepth_;
+    handleExpiredTimers(receivedTime);
+    endBatch();
 }
 
 void TimerManager::timerFdRead()
@@ -181,6 +220,22 @@ void TimerManager::timerFdRead()
 
 void TimerManager::timerFdReset(TimeStamp expireTime)
 {
+    if (batchDepth_ > 0) {
+        batchedReset_ = true;
+        batchedExpireTime_ = expireTime;
+        return;
+    }
+
+    timerFdSetTime(expireTime);
+}
+
+void TimerManager::timerFdSetTime(TimeStamp expireTime)
+{
+    if (completionIo_) {
+        timerFdChannel_->submitTimeout(expireTime);
+        return;
+    }
+
     auto newValue = detail::generateTimerSpec(expireTime);
     int ret = TEMP_FAILURE_RETRY(::timerfd_settime(timerFd_.get(), 0, &newValue, nullptr));
     if (ret != 0) {
@@ -22,53 +22,112 @@
 
 #pragma once
 
-#include <set>
-#include <unordered_map>
-
 #include "EventChannel.h"
-#include "Timer.h"
+#include "MpscQueue.h"
+#include "TimerPool.h"
 #include "UniqueFd.h"
 
 namespace wind {
 namespace base {
 class EventLoop;
 
-using TimerPtr = std::unique_ptr<Timer>;
-using TimerMap = std::unordered_map<TimerId, TimerPtr>; // To hold timers, manager the timers' ownership.
-using TimerEntry = std::pair<TimeStamp, TimerId>;       // Make sure every TimerEntry is unique.
-using TimerEntrySet = std::set<TimerEntry>;             // To sort timers ordered by expireTime
+enum class TimerManagerType {
+    SORTED, // timers sorted by expire time, exact but O(log n) per add and cancel.
+    WHEEL,  // hierarchical timing wheel, O(1) per add and cancel, fires at tick granularity.
+};
+
+// The TimerManager owns the timerFd and the TimerPool of the loop, the backend only needs to order the timers
+// by their pool indexes and decide when the timerFd should fire next.
+// Timers are created and get their ids in the caller's thread, so adding and cancelling never wait for the loop,
+// the operations from other threads are queued and applied by the loop in batches.
 class TimerManager : NonCopyable {
 public:
-    explicit TimerManager(EventLoop *loop);
-    ~TimerManager() noexcept;
+    static std::unique_ptr<TimerManager> create(EventLoop *loop, TimerManagerType type = TimerManagerType::SORTED);
+    virtual ~TimerManager() noexcept;
+
+    TimerManagerType type() const
+    {
+        return type_;
+    }
 
     // @callback: TimerCallback
     // @expireTime: expire TimeStamp
     // @interval: interval in micro seconds, 0 for only run once.
+    // @slack: tolerated delay in micro seconds, see Timer.
     // @return: TimerId
-    TimerId addTimer(TimerCallback callback, TimeStamp expireTime, TimeType interval = 0);
+    // thread safe, never blocks.
+    TimerId addTimer(TimerCallback callback, TimeStamp expireTime, TimeType interval = 0, TimeType slack = 0);
 
     // @timerId: TimerId to cancel
-    // can only be called in loop thread
+    // thread safe, never blocks. Cancelling is ordered after the adding as long as
+    // the TimerId was got before, even if the adding is not applied yet.
     void cancelTimer(const TimerId &timerId);
 
-private:
+protected:
+    TimerManager(EventLoop *loop, TimerManagerType type);
+
     void assertInLoopThread();
 
-    void addTimerInLoop(std::unique_ptr<Timer> &&timer);
+    // arm the timerFd to fire at expireTime, or disarm it if expireTime is invalid.
+    // Deferred to the end of the batch when applying queued operations or handling expired timers,
+    // only the last one takes effect.
+    void timerFdReset(TimeStamp expireTime);
+
+    Timer &timerAt(uint32_t index)
+    {
+        return pool_.at(index);
+    }
+    uint32_t poolCapacity() const
+    {
+        return pool_.capacity();
+    }
+
+    // Run the timer of index which has been removed from backend.
+    // @return: true if the timer is repeat and should be inserted back, or it is released.
+    bool executeTimer(uint32_t index);
+
+    // Backend interfaces, all of them are called in loop thread.
+    virtual void insertTimer(uint32_t index) = 0;
+    // the timer must have been inserted, it is released by the caller after removed.
+    virtual void removeTimer(uint32_t index) = 0;
+    // run the timers expired at receivedTime with executeTimer() and rearm the timerFd for the rest.
+    virtual void handleExpiredTimers(TimeStamp receivedTime) = 0;
+
+    EventLoop *loop_ = nullptr;
+
+private:
+    static constexpr uint32_t NO_TIMER = UINT32_MAX;
+
+    struct TimerOp {
+        TimerId timerId;
+        bool add = false; // add or cancel
+    };
+
+    void queueOp(TimerOp op);
+    void applyOp(TimerOp op);
+    void applyPendingOps();
+    void endBatch();
     void cancelTimerInLoop(const TimerId &timerId);
-    std::vector<TimerEntry> getExpiredTimers(TimeStamp receivedTime);
 
     void handleRead(TimeStamp receivedTime);
     void timerFdRead();
-    void timerFdReset(TimeStamp expireTime);
-
-    EventLoop *loop_ = nullptr;
+    void timerFdSetTime(TimeStamp expireTime);
+
+    TimerManagerType type_;
+    TimerPool pool_;
+    uint32_t running_ = NO_TIMER; // the timer being executed.
+    bool runningCancelled_ = false;
+    // with completion based io, the timers are waited by a timeout request of the channel instead of reading the
+    // timerFd, which only keys the channel then.
+    bool completionIo_ = false;
     UniqueFd timerFd_;
     std::shared_ptr<EventChannel> timerFdChannel_;
 
-    TimerMap timers_;
-    TimerEntrySet timerEntries_;
+    std::atomic<bool> opsPending_ = false; // whether an applyPendingOps() is queued to loop and not run yet.
+    MpscQueue<TimerOp> pendingOps_;
+    int batchDepth_ = 0;
+    bool batchedReset_ = false;
+    TimeStamp batchedExpireTime_;
 };
 } // namespace base
 } // namespace wind
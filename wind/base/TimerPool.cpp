@@ -0,0 +1,126 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "TimerPool.h"
+
+#include "Log.h"
+
+namespace wind {
+namespace base {
+namespace detail {
+constexpr uint64_t FREE_INDEX_MASK = 0xFFFFFFFFULL;
+
+inline uint64_t makeFreeHead(uint64_t oldHead, uint32_t index1)
+{
+    return (((oldHead >> 32) + 1) << 32) | index1;
+}
+} // namespace detail
+
+TimerPool::~TimerPool() noexcept
+{
+    uint32_t capacity = capacity_.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < capacity; ++i) {
+        Slot &slot = slotAt(i);
+        if (slot.alive.load(std::memory_order_acquire)) {
+            slot.timer()->~Timer();
+        }
+    }
+
+    for (auto &chunk : chunks_) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+TimerId TimerPool::create(TimerCallback callback, TimeStamp expireTime, TimeType interval, TimeType slack)
+{
+    uint32_t index = allocate();
+    Slot &slot = slotAt(index);
+    new (slot.storage) Timer(std::move(callback), expireTime, interval, slack);
+    // publish the constructed timer to the owner thread.
+    slot.alive.store(true, std::memory_order_release);
+    return TimerId(index, slot.generation.load(std::memory_order_acquire));
+}
+
+void TimerPool::release(uint32_t index)
+{
+    Slot &slot = slotAt(index);
+    ASSERT(slot.alive.load(std::memory_order_relaxed));
+    slot.timer()->~Timer();
+    slot.alive.store(false, std::memory_order_release);
+    uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+    slot.generation.store(generation == 0 ? 1 : generation, std::memory_order_release);
+    pushFree(index, index);
+}
+
+uint32_t TimerPool::allocate()
+{
+    uint64_t head = freeHead_.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t index1 = static_cast<uint32_t>(head & detail::FREE_INDEX_MASK);
+        if (index1 == 0) {
+            grow();
+            head = freeHead_.load(std::memory_order_acquire);
+            continue;
+        }
+
+        // the slot may be popped and pushed again by others meanwhile, then the tag changed and CAS fails.
+        uint32_t next1 = slotAt(index1 - 1).nextFree.load(std::memory_order_relaxed);
+        if (freeHead_.compare_exchange_weak(
+                head, detail::makeFreeHead(head, next1), std::memory_order_acquire, std::memory_order_acquire)) {
+            return index1 - 1;
+        }
+    }
+}
+
+void TimerPool::grow()
+{
+    std::lock_guard<std::mutex> lock(growMutex_);
+    if ((freeHead_.load(std::memory_order_acquire) & detail::FREE_INDEX_MASK) != 0) {
+        return; // grown by others.
+    }
+
+    uint32_t capacity = capacity_.load(std::memory_order_relaxed);
+    uint32_t chunkIdx = capacity >> CHUNK_BITS;
+    if (chunkIdx >= MAX_CHUNKS) {
+        LOG_SYS_FATAL << "TimerPool: too many timers(" << capacity << ")!";
+    }
+
+    Slot *chunk = new Slot[CHUNK_SIZE];
+    for (uint32_t i = 0; i + 1 < CHUNK_SIZE; ++i) {
+        chunk[i].nextFree.store(capacity + i + 2, std::memory_order_relaxed);
+    }
+    chunks_[chunkIdx].store(chunk, std::memory_order_release);
+    capacity_.store(capacity + CHUNK_SIZE, std::memory_order_release);
+    pushFree(capacity, capacity + CHUNK_SIZE - 1);
+}
+
+void TimerPool::pushFree(uint32_t first, uint32_t last)
+{
+    Slot &lastSlot = slotAt(last);
+    uint64_t head = freeHead_.load(std::memory_order_relaxed);
+    do {
+        lastSlot.nextFree.store(static_cast<uint32_t>(head & detail::FREE_INDEX_MASK), std::memory_order_relaxed);
+    } while (!freeHead_.compare_exchange_weak(
+        head, detail::makeFreeHead(head, first + 1), std::memory_order_release, std::memory_order_relaxed));
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,109 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include "Timer.h"
+#include "TimerId.h"
+
+namespace wind {
+namespace base {
+// Slab of the timers of a loop. The slots live in fixed size chunks which never move or get freed
+// until the pool is destroyed, the free slots are kept in a lock free stack tagged against ABA.
+// So a timer can be created in any thread without locking, and creating/releasing timers
+// costs no heap allocation once the pool has grown to the peak count of timers.
+class TimerPool : NonCopyable {
+public:
+    static constexpr uint32_t CHUNK_BITS = 10;
+    static constexpr uint32_t CHUNK_SIZE = 1U << CHUNK_BITS;
+    static constexpr uint32_t MAX_CHUNKS = 4096;
+
+    TimerPool() = default;
+    ~TimerPool() noexcept;
+
+    // thread safe.
+    TimerId create(TimerCallback callback, TimeStamp expireTime, TimeType interval, TimeType slack);
+
+    // The following functions can only be called by the owner thread,
+    // and only for the timers whose creation happens before, such as the ones got from a queue.
+
+    // return nullptr if the timer of timerId was released.
+    Timer *get(const TimerId &timerId)
+    {
+        if (!timerId.valid() || timerId.index >= capacity_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        Slot &slot = slotAt(timerId.index);
+        // the acquire pairs with the release in create(), which may run in another thread.
+        bool alive = slot.alive.load(std::memory_order_acquire);
+        return alive && slot.generation.load(std::memory_order_acquire) == timerId.generation ? slot.timer() : nullptr;
+    }
+    Timer &at(uint32_t index)
+    {
+        return *slotAt(index).timer();
+    }
+    // destroy the timer and recycle its slot, the TimerIds of it become stale.
+    void release(uint32_t index);
+
+    // count of slots, including the free ones. thread safe.
+    uint32_t capacity() const
+    {
+        return capacity_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Slot {
+        Timer *timer()
+        {
+            return reinterpret_cast<Timer *>(storage);
+        }
+
+        alignas(Timer) unsigned char storage[sizeof(Timer)];
+        // written by the creating thread and the owner thread in turn.
+        std::atomic<uint32_t> generation = 1;
+        std::atomic<bool> alive = false;
+        std::atomic<uint32_t> nextFree = 0; // index + 1 of the next free slot, 0 for none.
+    };
+
+    Slot &slotAt(uint32_t index)
+    {
+        return chunks_[index >> CHUNK_BITS].load(std::memory_order_acquire)[index & (CHUNK_SIZE - 1)];
+    }
+
+    // pop a free slot, grow the pool if there is none.
+    uint32_t allocate();
+    void grow();
+    // push the slots first..last(linked already) to the free stack.
+    void pushFree(uint32_t first, uint32_t last);
+
+    std::array<std::atomic<Slot *>, MAX_CHUNKS> chunks_{};
+    std::atomic<uint32_t> capacity_ = 0;
+    // (tag << 32) | (index + 1) of the top free slot.
+    std::atomic<uint64_t> freeHead_ = 0;
+    std::mutex growMutex_;
+};
+} // namespace base
+} // namespace wind
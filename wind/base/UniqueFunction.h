@@ -0,0 +1,230 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "NonCopyable.h"
+
+namespace wind {
+namespace base {
+// Big enough for a lambda capturing a this pointer, a shared_ptr and a std::string.
+constexpr size_t DEFAULT_FUNCTION_INLINE_SIZE = 64;
+
+template <typename Signature, size_t INLINE_SIZE = DEFAULT_FUNCTION_INLINE_SIZE>
+class UniqueFunction;
+
+// A move-only replacement of std::function with a small buffer:
+// callables no bigger than INLINE_SIZE (and nothrow movable) are stored inline without heap allocation,
+// bigger ones are stored on heap. Move-only callables (such as std::packaged_task) are supported.
+template <typename R, typename... Args, size_t INLINE_SIZE>
+class UniqueFunction<R(Args...), INLINE_SIZE> : NonCopyable {
+    struct Ops {
+        R (*invoke)(void *storage, Args &&...args);
+        // move construct the callable from src storage to dst storage, and destroy the src one.
+        void (*relocate)(void *dst, void *src) noexcept;
+        void (*destroy)(void *storage) noexcept;
+    };
+
+    // Pointer alignment is enough for almost all lambdas, and keeps sizeof(UniqueFunction) == INLINE_SIZE + 8.
+    static constexpr size_t INLINE_ALIGN = alignof(void *);
+
+    template <typename F>
+    static constexpr bool STORED_INLINE = sizeof(F) <= INLINE_SIZE && INLINE_ALIGN % alignof(F) == 0 &&
+                                          std::is_nothrow_move_constructible_v<F>;
+
+    template <typename F>
+    struct InlineOps {
+        static F *get(void *storage)
+        {
+            return std::launder(static_cast<F *>(storage));
+        }
+        static R invoke(void *storage, Args &&...args)
+        {
+            return std::invoke(*get(storage), std::forward<Args>(args)...);
+        }
+        static void relocate(void *dst, void *src) noexcept
+        {
+            ::new (dst) F(std::move(*get(src)));
+            get(src)->~F();
+        }
+        static void destroy(void *storage) noexcept
+        {
+            get(storage)->~F();
+        }
+        static constexpr Ops OPS = {&invoke, &relocate, &destroy};
+    };
+
+    template <typename F>
+    struct HeapOps {
+        static F *&get(void *storage)
+        {
+            return *std::launder(static_cast<F **>(storage));
+        }
+        static R invoke(void *storage, Args &&...args)
+        {
+            return std::invoke(*get(storage), std::forward<Args>(args)...);
+        }
+        static void relocate(void *dst, void *src) noexcept
+        {
+            ::new (dst) F *(get(src));
+        }
+        static void destroy(void *storage) noexcept
+        {
+            delete get(storage);
+        }
+        static constexpr Ops OPS = {&invoke, &relocate, &destroy};
+    };
+
+    template <typename F>
+    struct IsStdFunction : std::false_type {};
+    template <typename Signature2>
+    struct IsStdFunction<std::function<Signature2>> : std::true_type {};
+
+    template <typename F>
+    static bool isNull(const F &f)
+    {
+        if constexpr (std::is_pointer_v<F> || std::is_member_pointer_v<F> || IsStdFunction<F>::value) {
+            return f == nullptr;
+        } else {
+            return false;
+        }
+    }
+
+public:
+    UniqueFunction() noexcept = default;
+    UniqueFunction(std::nullptr_t) noexcept {}
+
+    template <
+        typename Callable,
+        typename F = std::decay_t<Callable>,
+        typename = std::enable_if_t<
+            !std::is_same_v<F, UniqueFunction> && std::is_invocable_r_v<R, F &, Args...>>>
+    UniqueFunction(Callable &&callable)
+    {
+        if (isNull<F>(callable)) {
+            return;
+        }
+
+        if constexpr (STORED_INLINE<F>) {
+            ::new (static_cast<void *>(storage_)) F(std::forward<Callable>(callable));
+            ops_ = &InlineOps<F>::OPS;
+        } else {
+            ::new (static_cast<void *>(storage_)) F *(new F(std::forward<Callable>(callable)));
+            ops_ = &HeapOps<F>::OPS;
+        }
+    }
+
+    ~UniqueFunction() noexcept
+    {
+        reset();
+    }
+
+    // movable
+    UniqueFunction(UniqueFunction &&other) noexcept
+    {
+        moveFrom(other);
+    }
+    UniqueFunction &operator=(UniqueFunction &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+    UniqueFunction &operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    R operator()(Args... args) const
+    {
+        return ops_->invoke(storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ops_ != nullptr;
+    }
+
+    void swap(UniqueFunction &other) noexcept
+    {
+        UniqueFunction tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+private:
+    void reset() noexcept
+    {
+        if (ops_ != nullptr) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    void moveFrom(UniqueFunction &other) noexcept
+    {
+        if (other.ops_ != nullptr) {
+            other.ops_->relocate(storage_, other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    // mutable since calling a const UniqueFunction may change the state of its callable, same as std::function.
+    alignas(INLINE_ALIGN) mutable unsigned char storage_[INLINE_SIZE];
+    const Ops *ops_ = nullptr;
+};
+
+template <typename R, typename... Args, size_t INLINE_SIZE>
+inline bool operator==(const UniqueFunction<R(Args...), INLINE_SIZE> &f, std::nullptr_t) noexcept
+{
+    return !f;
+}
+
+template <typename R, typename... Args, size_t INLINE_SIZE>
+inline bool operator==(std::nullptr_t, const UniqueFunction<R(Args...), INLINE_SIZE> &f) noexcept
+{
+    return !f;
+}
+
+template <typename R, typename... Args, size_t INLINE_SIZE>
+inline bool operator!=(const UniqueFunction<R(Args...), INLINE_SIZE> &f, std::nullptr_t) noexcept
+{
+    return static_cast<bool>(f);
+}
+
+template <typename R, typename... Args, size_t INLINE_SIZE>
+inline bool operator!=(std::nullptr_t, const UniqueFunction<R(Args...), INLINE_SIZE> &f) noexcept
+{
+    return static_cast<bool>(f);
+}
+} // namespace base
+} // namespace wind
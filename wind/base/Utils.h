@@ -27,6 +27,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/eventfd.h>
+#include <time.h>
 
 #define UNUSED(val) (void)val;
 
@@ -52,6 +53,14 @@ inline void memZero(void *data, size_t len)
     ::memset(data, 0, len);
 }
 
+// monotonic clock in nano seconds, for measuring durations.
+inline uint64_t monotonicNanos()
+{
+    struct timespec ts {};
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
 int createEventFdOrDie();
 
 int createIdleFdOrDie();
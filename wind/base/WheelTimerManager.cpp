@@ -0,0 +1,214 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "WheelTimerManager.h"
+
+#include "Log.h"
+
+namespace wind {
+namespace base {
+WheelTimerManager::WheelTimerManager(EventLoop *loop, TimeType tick)
+    : TimerManager(loop, TimerManagerType::WHEEL),
+      origin_(TimeStamp::now()),
+      tick_(std::max(tick, TimeType(1))),
+      slots_(ROOT_SIZE + (LEVELS - 1) * LEVEL_SIZE, NIL)
+{}
+
+uint64_t WheelTimerManager::ceilTick(TimeStamp t) const
+{
+    auto diff = timeDiff(t, origin_);
+    return diff <= 0 ? 0 : static_cast<uint64_t>((diff + tick_ - 1) / tick_);
+}
+
+uint64_t WheelTimerManager::floorTick(TimeStamp t) const
+{
+    auto diff = timeDiff(t, origin_);
+    return diff <= 0 ? 0 : static_cast<uint64_t>(diff / tick_);
+}
+
+uint32_t WheelTimerManager::slotOf(uint64_t expireTick) const
+{
+    ASSERT(expireTick >= currentTick_);
+    uint64_t span = expireTick - currentTick_;
+    if (span < ROOT_SIZE) {
+        return static_cast<uint32_t>(expireTick & (ROOT_SIZE - 1));
+    }
+
+    // too far away, park it in the last slot it can reach, it will be cascaded again.
+    if (span >= MAX_SPAN) {
+        expireTick = currentTick_ + MAX_SPAN - 1;
+    }
+
+    int level = 1;
+    while (span >= (1ULL << (ROOT_BITS + level * LEVEL_BITS)) && level < LEVELS - 1) {
+        ++level;
+    }
+    uint64_t index = (expireTick >> (ROOT_BITS + (level - 1) * LEVEL_BITS)) & (LEVEL_SIZE - 1);
+    return static_cast<uint32_t>(ROOT_SIZE + (level - 1) * LEVEL_SIZE + index);
+}
+
+void WheelTimerManager::link(uint32_t index)
+{
+    Node &node = nodes_[index];
+    uint32_t slot = slotOf(node.expireTick);
+    node.slot = slot;
+    node.prev = NIL;
+    node.next = slots_[slot];
+    if (node.next != NIL) {
+        nodes_[node.next].prev = index;
+    }
+    slots_[slot] = index;
+}
+
+void WheelTimerManager::unlink(uint32_t index)
+{
+    Node &node = nodes_[index];
+    ASSERT(node.slot != NIL);
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        slots_[node.slot] = node.next;
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = NIL;
+    node.next = NIL;
+    node.slot = NIL;
+}
+
+void WheelTimerManager::insertTimer(uint32_t index)
+{
+    assertInLoopThread();
+
+    if (index >= nodes_.size()) {
+        nodes_.resize(poolCapacity());
+    }
+
+    if (timerCount_ == 0) {
+        // nothing to expire, just catch up with the wall clock.
+        currentTick_ = std::max(currentTick_, floorTick(TimeStamp::now()));
+    }
+
+    // the slot of currentTick_ has been expired already.
+    uint64_t expireTick = std::max(ceilTick(timerAt(index).expireTime()), currentTick_ + 1);
+    nodes_[index].expireTick = expireTick;
+    link(index);
+    ++timerCount_;
+
+    // never arm beyond the next root wrap, the outer wheels must be cascaded there.
+    uint64_t wakeTick = std::min(expireTick, (currentTick_ | (ROOT_SIZE - 1)) + 1);
+    if (armedTick_ == 0 || wakeTick < armedTick_) {
+        armedTick_ = wakeTick;
+        timerFdReset(tickTime(wakeTick));
+    }
+}
+
+void WheelTimerManager::removeTimer(uint32_t index)
+{
+    assertInLoopThread();
+    ASSERT(index < nodes_.size());
+
+    // keep the timerFd as it is, a spurious wakeup is cheaper than resetting it on every cancel.
+    unlink(index);
+    --timerCount_;
+}
+
+void WheelTimerManager::handleExpiredTimers(TimeStamp receivedTime)
+{
+    // armedTick_ is stale until rearm(), so the timers added by the callbacks will not reset the timerFd.
+    advanceTo(floorTick(receivedTime));
+    rearm();
+}
+
+void WheelTimerManager::advanceTo(uint64_t tick)
+{
+    while (currentTick_ < tick) {
+        if (timerCount_ == 0) {
+            currentTick_ = tick;
+            break;
+        }
+
+        ++currentTick_;
+        if ((currentTick_ & (ROOT_SIZE - 1)) == 0) {
+            cascade(1);
+        }
+        expireSlot(static_cast<uint32_t>(currentTick_ & (ROOT_SIZE - 1)));
+    }
+}
+
+void WheelTimerManager::cascade(int level)
+{
+    uint64_t index = (currentTick_ >> (ROOT_BITS + (level - 1) * LEVEL_BITS)) & (LEVEL_SIZE - 1);
+    if (index == 0 && level < LEVELS - 1) {
+        cascade(level + 1);
+    }
+
+    uint32_t &slot = slots_[ROOT_SIZE + (level - 1) * LEVEL_SIZE + index];
+    uint32_t timer = slot;
+    slot = NIL;
+    while (timer != NIL) {
+        uint32_t next = nodes_[timer].next;
+        link(timer);
+        timer = next;
+    }
+}
+
+void WheelTimerManager::expireSlot(uint32_t slot)
+{
+    // pop one by one, the callbacks may cancel the other timers in this slot.
+    while (slots_[slot] != NIL) {
+        uint32_t index = slots_[slot];
+        unlink(index);
+
+        // nodes_ may grow in the callback, do not hold any reference of it.
+        if (executeTimer(index)) {
+            nodes_[index].expireTick = std::max(ceilTick(timerAt(index).expireTime()), currentTick_ + 1);
+            link(index);
+        } else {
+            --timerCount_;
+        }
+    }
+}
+
+uint64_t WheelTimerManager::nextWakeTick() const
+{
+    uint64_t tick = currentTick_ + 1;
+    while ((tick & (ROOT_SIZE - 1)) != 0 && slots_[tick & (ROOT_SIZE - 1)] == NIL) {
+        ++tick;
+    }
+    return tick;
+}
+
+void WheelTimerManager::rearm()
+{
+    if (timerCount_ == 0) {
+        armedTick_ = 0;
+        timerFdReset(TimeStamp::invalid());
+        return;
+    }
+
+    armedTick_ = nextWakeTick();
+    timerFdReset(tickTime(armedTick_));
+}
+} // namespace base
+} // namespace wind
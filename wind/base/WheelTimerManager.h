@@ -0,0 +1,100 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <vector>
+
+#include "TimerManager.h"
+
+namespace wind {
+namespace base {
+// Hierarchical timing wheel: a root wheel of 256 ticks and 3 outer wheels of 64 slots each,
+// timers in outer wheels are cascaded down when the root wheel wraps.
+// Add, cancel and rearm are O(1), but timers fire at tick granularity (never earlier than expireTime),
+// and the timerFd is only armed to tick boundaries.
+class WheelTimerManager : public TimerManager {
+public:
+    static constexpr TimeType DEFAULT_TICK = MICRO_SECS_PER_MILLISECOND;
+
+    // @tick: granularity in micro seconds.
+    explicit WheelTimerManager(EventLoop *loop, TimeType tick = DEFAULT_TICK);
+    ~WheelTimerManager() noexcept override = default;
+
+    TimeType tick() const
+    {
+        return tick_;
+    }
+
+protected:
+    void insertTimer(uint32_t index) override;
+    void removeTimer(uint32_t index) override;
+    void handleExpiredTimers(TimeStamp receivedTime) override;
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int ROOT_BITS = 8;
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr uint64_t ROOT_SIZE = 1ULL << ROOT_BITS;
+    static constexpr uint64_t LEVEL_SIZE = 1ULL << LEVEL_BITS;
+    static constexpr uint64_t MAX_SPAN = 1ULL << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS);
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    // Intrusive list node of a timer, indexed by the pool index, linked by pool indexes.
+    struct Node {
+        uint64_t expireTick = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t slot = NIL; // the slot linked in, NIL if not linked.
+    };
+
+    // the first tick not earlier than t.
+    uint64_t ceilTick(TimeStamp t) const;
+    // the last tick not later than t.
+    uint64_t floorTick(TimeStamp t) const;
+    TimeStamp tickTime(uint64_t tick) const
+    {
+        return timeAdd(origin_, static_cast<TimeType>(tick) * tick_);
+    }
+
+    uint32_t slotOf(uint64_t expireTick) const;
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+
+    void advanceTo(uint64_t tick);
+    void cascade(int level);
+    void expireSlot(uint32_t slot);
+
+    // the tick the timerFd should fire at: next non-empty root slot or next root wrap.
+    uint64_t nextWakeTick() const;
+    void rearm();
+
+    TimeStamp origin_;
+    TimeType tick_;
+    uint64_t currentTick_ = 0; // all the slots up to currentTick_ have been expired.
+    uint64_t armedTick_ = 0;   // 0 means the timerFd is not armed.
+    size_t timerCount_ = 0;    // linked timers and the one being executed.
+    std::vector<uint32_t> slots_; // head of every slot.
+    std::vector<Node> nodes_;
+};
+} // namespace base
+} // namespace wind
@@ -0,0 +1,160 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "NonCopyable.h"
+#include "Types.h"
+
+namespace wind {
+namespace base {
+// Lock-free Chase-Lev work stealing deque of pointers.
+// The owner thread pushes and pops at the bottom (LIFO, cache friendly), the other threads steal
+// from the top (FIFO). The buffer grows on demand, the old buffers are kept until the deque is destroyed
+// since a thief may still be reading them.
+template <typename T>
+class WorkStealingDeque : NonCopyable {
+    static_assert(std::is_pointer_v<T>, "WorkStealingDeque only holds pointers.");
+
+    struct Buffer {
+        explicit Buffer(int64_t capacity) : capacity(capacity), slots(new std::atomic<T>[capacity]) {}
+
+        T get(int64_t i) const
+        {
+            return slots[i & (capacity - 1)].load(std::memory_order_relaxed);
+        }
+        void put(int64_t i, T value)
+        {
+            slots[i & (capacity - 1)].store(value, std::memory_order_relaxed);
+        }
+
+        int64_t capacity; // power of 2
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+public:
+    static constexpr int64_t DEFAULT_CAPACITY = 256;
+
+    explicit WorkStealingDeque(int64_t capacity = DEFAULT_CAPACITY)
+    {
+        int64_t realCapacity = 1;
+        while (realCapacity < capacity) {
+            realCapacity <<= 1;
+        }
+        buffers_.push_back(std::make_unique<Buffer>(realCapacity));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+    ~WorkStealingDeque() noexcept = default;
+
+    // Only the owner thread.
+    void push(T value)
+    {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+        if (b - t > buffer->capacity - 1) {
+            buffer = grow(buffer, t, b);
+        }
+        buffer->put(b, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Only the owner thread, return nullptr if empty.
+    T pop()
+    {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T value = buffer->get(b);
+        if (t == b) {
+            // the last one, race with the thieves.
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                value = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    // Thread safe, return nullptr if empty or lost the race with others.
+    T steal()
+    {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+
+        Buffer *buffer = buffer_.load(std::memory_order_acquire);
+        T value = buffer->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return value;
+    }
+
+    // Thread safe, only a hint if there are other threads operating.
+    size_t size() const
+    {
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        int64_t t = top_.load(std::memory_order_acquire);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+private:
+    Buffer *grow(Buffer *old, int64_t t, int64_t b)
+    {
+        auto buffer = std::make_unique<Buffer>(old->capacity * 2);
+        for (int64_t i = t; i < b; ++i) {
+            buffer->put(i, old->get(i));
+        }
+        buffers_.push_back(std::move(buffer));
+        buffer_.store(buffers_.back().get(), std::memory_order_release);
+        return buffers_.back().get();
+    }
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    std::atomic<Buffer *> buffer_{nullptr};
+    std::vector<std::unique_ptr<Buffer>> buffers_; // only touched by the owner.
+};
+} // namespace base
+} // namespace wind
@@ -0,0 +1,98 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Counts every heap allocation of the process, so a benchmark can tell
+// how many allocations its hot path does.
+// NOTE: include this header in only one source file of a benchmark executable,
+// since it replaces the global operator new/delete.
+namespace wind {
+namespace bench {
+inline std::atomic<uint64_t> g_allocCount{0};
+
+inline uint64_t allocCount()
+{
+    return g_allocCount.load(std::memory_order_relaxed);
+}
+
+class StopWatch {
+public:
+    StopWatch() : start_(std::chrono::steady_clock::now()) {}
+
+    void reset()
+    {
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    int64_t elapsedNanos() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_)
+            .count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+} // namespace bench
+} // namespace wind
+
+void *operator new(size_t size)
+{
+    wind::bench::g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    void *p = ::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    ::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    ::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    ::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    ::free(p);
+}
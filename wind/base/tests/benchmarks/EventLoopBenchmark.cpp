@@ -0,0 +1,89 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BenchmarkHelper.h"
+
+#include "EventLoop.h"
+#include "Utils.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// Measure the steady-state cost of EventLoop::start() iterations:
+// every channel is kept readable (level triggered, never drained),
+// so each epoll_wait returns all of them immediately.
+constexpr size_t CHANNEL_NUM = 64;
+constexpr uint64_t WARMUP_ITERATIONS = 1000;
+constexpr uint64_t MEASURE_ITERATIONS = 100000;
+
+int main()
+{
+    EventLoop loop;
+    std::vector<UniqueFd> fds;
+    std::vector<std::shared_ptr<EventChannel>> channels;
+
+    uint64_t iterations = 0;
+    uint64_t allocsBegin = 0;
+    uint64_t allocsEnd = 0;
+    bench::StopWatch watch;
+    int64_t elapsedNanos = 0;
+
+    for (size_t i = 0; i < CHANNEL_NUM; ++i) {
+        fds.emplace_back(utils::createEventFdOrDie());
+        uint64_t one = 1;
+        (void)TEMP_FAILURE_RETRY(::write(fds.back().get(), &one, sizeof(one)));
+
+        auto channel = std::make_shared<EventChannel>(fds.back().get(), &loop);
+        if (i == 0) {
+            channel->setReadCallback([&](TimeStamp) {
+                ++iterations;
+                if (iterations == WARMUP_ITERATIONS) {
+                    allocsBegin = bench::allocCount();
+                    watch.reset();
+                } else if (iterations == WARMUP_ITERATIONS + MEASURE_ITERATIONS) {
+                    elapsedNanos = watch.elapsedNanos();
+                    allocsEnd = bench::allocCount();
+                    loop.stop();
+                }
+            });
+        } else {
+            channel->setReadCallback([](TimeStamp) {});
+        }
+        channel->enableReading();
+        channels.push_back(std::move(channel));
+    }
+
+    loop.start();
+
+    for (auto &channel : channels) {
+        channel->disableAll();
+    }
+
+    double allocsPerIteration = static_cast<double>(allocsEnd - allocsBegin) / MEASURE_ITERATIONS;
+    ::printf(
+        "EventLoopBenchmark: %zu channels, %" PRIu64 " iterations, %.1f ns/iteration, %.3f allocations/iteration\n",
+        CHANNEL_NUM,
+        MEASURE_ITERATIONS,
+        static_cast<double>(elapsedNanos) / MEASURE_ITERATIONS,
+        allocsPerIteration);
+    return allocsEnd == allocsBegin ? 0 : 1;
+}
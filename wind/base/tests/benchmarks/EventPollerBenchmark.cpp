@@ -0,0 +1,209 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BenchmarkHelper.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "EpollPoller.h"
+#include "EventLoopThread.h"
+#include "Utils.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// 1. Show the per-poller epoll_wait event array growing under a burst of ready fds and
+//    shrinking back after the burst.
+// 2. Compare epoll and io_uring pollers when every channel changes its interest in every iteration:
+//    epoll needs one epoll_ctl per change, io_uring submits all of them with the wait in one syscall.
+//    In burst mode every channel enables and disables writing in the same iteration, which is
+//    collapsed by the poller and costs no syscall.
+// 3. Measure the cross-thread wakeup latency (queueToLoop -> functor executed)
+//    with blocking wait and with busy polling, for both pollers.
+constexpr size_t BURST_CHANNEL_NUM = 1000;
+constexpr size_t IDLE_CHANNEL_NUM = 4;
+constexpr size_t IDLE_POLLS = 1024;
+constexpr size_t CHURN_CHANNEL_NUM = 64;
+constexpr size_t CHURN_ITERATIONS = 20000;
+constexpr size_t LATENCY_SAMPLES = 20000;
+constexpr int64_t SAMPLE_INTERVAL_MICROS = 20;
+
+int64_t nowNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+bool benchEventSize()
+{
+    EventLoop loop;
+    EpollPoller poller(&loop);
+    std::vector<UniqueFd> fds;
+    std::vector<std::shared_ptr<EventChannel>> channels;
+    for (size_t i = 0; i < BURST_CHANNEL_NUM; ++i) {
+        fds.emplace_back(utils::createEventFdOrDie());
+        uint64_t one = 1;
+        (void)TEMP_FAILURE_RETRY(::write(fds.back().get(), &one, sizeof(one)));
+        auto channel = std::make_shared<EventChannel>(fds.back().get(), &loop);
+        channel->enableReading(false);
+        poller.updateChannel(channel);
+        channels.push_back(std::move(channel));
+    }
+
+    std::vector<EventChannel *> activeChannels;
+    ::printf("EventSize: initial %zu", poller.eventSize());
+    for (size_t i = 0; i < 8; ++i) {
+        activeChannels.clear();
+        poller.pollOnce(activeChannels, 0);
+        ::printf(" -> %zu", poller.eventSize());
+    }
+    size_t burstSize = poller.eventSize();
+
+    for (size_t i = IDLE_CHANNEL_NUM; i < BURST_CHANNEL_NUM; ++i) {
+        poller.removeChannel(channels[i]->fd(), channels[i].get());
+    }
+    poller.releaseRetiredChannels();
+    for (size_t i = 0; i < IDLE_POLLS; ++i) {
+        activeChannels.clear();
+        poller.pollOnce(activeChannels, 0);
+    }
+    size_t idleSize = poller.eventSize();
+    ::printf(", after %zu idle polls: %zu\n", IDLE_POLLS, idleSize);
+
+    for (size_t i = 0; i < IDLE_CHANNEL_NUM; ++i) {
+        poller.removeChannel(channels[i]->fd(), channels[i].get());
+    }
+    poller.releaseRetiredChannels();
+    return burstSize >= BURST_CHANNEL_NUM && idleSize < burstSize;
+}
+
+const char *pollerTypeName(PollerType type)
+{
+    return type == PollerType::IO_URING ? "io_uring" : "epoll";
+}
+
+void benchInterestChurn(PollerType type, bool burst)
+{
+    EventLoop loop;
+    auto poller = EventPoller::create(&loop, type);
+    std::vector<UniqueFd> fds;
+    std::vector<std::shared_ptr<EventChannel>> channels;
+    for (size_t i = 0; i < CHURN_CHANNEL_NUM; ++i) {
+        // an empty eventfd is always writable and never readable.
+        fds.emplace_back(utils::createEventFdOrDie());
+        auto channel = std::make_shared<EventChannel>(fds.back().get(), &loop);
+        channel->enableReading(false);
+        poller->updateChannel(channel);
+        channels.push_back(std::move(channel));
+    }
+
+    std::vector<EventChannel *> activeChannels;
+    size_t events = 0;
+    bench::StopWatch watch;
+    for (size_t i = 0; i < CHURN_ITERATIONS; ++i) {
+        for (auto &channel : channels) {
+            if (burst || i % 2 == 0) {
+                channel->enableWriting(false);
+                poller->updateChannel(channel);
+            }
+            if (burst || i % 2 == 1) {
+                channel->disableWriting(false);
+                poller->updateChannel(channel);
+            }
+        }
+        activeChannels.clear();
+        poller->pollOnce(activeChannels, 0);
+        events += activeChannels.size();
+    }
+    auto elapsedNanos = watch.elapsedNanos();
+
+    for (auto &channel : channels) {
+        poller->removeChannel(channel->fd(), channel.get());
+    }
+    poller->releaseRetiredChannels();
+    ::printf(
+        "Interest%s(%-8s): %zu channels, %8.1f ns/iteration, %.1f events/iteration\n",
+        burst ? "Burst" : "Churn",
+        pollerTypeName(poller->type()),
+        CHURN_CHANNEL_NUM,
+        static_cast<double>(elapsedNanos) / CHURN_ITERATIONS,
+        static_cast<double>(events) / CHURN_ITERATIONS);
+}
+
+void benchWakeUpLatency(EventLoop *loop, TimeType busyPollTime)
+{
+    loop->setBusyPollTime(busyPollTime);
+    loop->schedule([]() {}).wait();
+
+    std::vector<int64_t> latencies(LATENCY_SAMPLES);
+    std::atomic<bool> done = false;
+    for (size_t i = 0; i < LATENCY_SAMPLES; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(SAMPLE_INTERVAL_MICROS));
+        done.store(false, std::memory_order_relaxed);
+        auto sendTime = nowNanos();
+        loop->queueToLoop([&latencies, &done, i, sendTime]() {
+            latencies[i] = nowNanos() - sendTime;
+            done.store(true, std::memory_order_release);
+        });
+        while (!done.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return static_cast<double>(latencies[static_cast<size_t>(p * (latencies.size() - 1))]) / 1000.0;
+    };
+    ::printf(
+        "WakeUpLatency(%-8s, busyPollTime: %4" PRId64 "us): p50 %7.1fus, p90 %7.1fus, p99 %7.1fus, p99.9 %7.1fus, max "
+        "%7.1fus\n",
+        pollerTypeName(loop->pollerType()),
+        busyPollTime,
+        percentile(0.5),
+        percentile(0.9),
+        percentile(0.99),
+        percentile(0.999),
+        percentile(1.0));
+}
+
+int main()
+{
+    bool ok = benchEventSize();
+
+    for (bool burst : {false, true}) {
+        for (auto type : {PollerType::EPOLL, PollerType::IO_URING}) {
+            benchInterestChurn(type, burst);
+        }
+    }
+
+    for (auto type : {PollerType::EPOLL, PollerType::IO_URING}) {
+        EventLoopThread loopThread("WakeUpLatency", type);
+        EventLoop *loop = loopThread.start();
+        for (TimeType busyPollTime : {0, 50, 200}) {
+            benchWakeUpLatency(loop, busyPollTime);
+        }
+        loop->setBusyPollTime(0);
+    }
+    return ok ? 0 : 1;
+}
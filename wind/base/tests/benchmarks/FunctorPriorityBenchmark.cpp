@@ -0,0 +1,113 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BenchmarkHelper.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "EventLoopThread.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// Latency of the control functors (like closing a connection) queued to a loop flooded by sending functors.
+// The flood comes in bursts of about FLOOD_BURST * FLOOD_WORK_NANOS of work, which keeps the loop half busy.
+constexpr int64_t RUN_NANOS = 2000LL * NANO_SECS_PER_MILLISECOND;
+constexpr size_t FLOOD_BURST = 2000;
+constexpr int64_t FLOOD_WORK_NANOS = 1000;
+constexpr int64_t FLOOD_PAUSE_MICROS = 4000;
+constexpr int64_t CONTROL_INTERVAL_MICROS = 1000;
+
+struct LatencyResult {
+    double p50;
+    double p99;
+    double max;
+    size_t count;
+};
+
+LatencyResult benchLatency(FunctorPriority floodPriority, FunctorPriority controlPriority, TimeType budget)
+{
+    EventLoopThread loopThread("BenchLoop");
+    EventLoop *loop = loopThread.start();
+    loop->setLowPriorityBudget(budget);
+
+    std::atomic<bool> running = true;
+    std::vector<int64_t> latencies; // only accessed in the loop thread until the end.
+    latencies.reserve(RUN_NANOS / CONTROL_INTERVAL_MICROS / NANO_SECS_PER_MICROSECOND + 1);
+
+    std::thread flooder([loop, floodPriority, &running]() {
+        while (running.load(std::memory_order_relaxed)) {
+            for (size_t i = 0; i < FLOOD_BURST; ++i) {
+                loop->queueToLoop(
+                    []() {
+                        bench::StopWatch work;
+                        while (work.elapsedNanos() < FLOOD_WORK_NANOS) {
+                        }
+                    },
+                    floodPriority);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(FLOOD_PAUSE_MICROS));
+        }
+    });
+
+    bench::StopWatch clock;
+    while (clock.elapsedNanos() < RUN_NANOS) {
+        auto queued = clock.elapsedNanos();
+        loop->queueToLoop(
+            [&latencies, &clock, queued]() { latencies.push_back(clock.elapsedNanos() - queued); }, controlPriority);
+        std::this_thread::sleep_for(std::chrono::microseconds(CONTROL_INTERVAL_MICROS));
+    }
+    running = false;
+    flooder.join();
+    // drain everything before reading the latencies.
+    loop->schedule([]() {}).wait();
+    loop->setLowPriorityBudget(0);
+    loop->schedule([]() {}).wait();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return static_cast<double>(latencies[static_cast<size_t>(p * (latencies.size() - 1))]) /
+            NANO_SECS_PER_MICROSECOND;
+    };
+    return {percentile(0.5), percentile(0.99), percentile(1.0), latencies.size()};
+}
+
+void report(const char *name, FunctorPriority floodPriority, FunctorPriority controlPriority, TimeType budget)
+{
+    auto result = benchLatency(floodPriority, controlPriority, budget);
+    ::printf(
+        "%-40s | %9.1f | %9.1f | %9.1f | %zu\n", name, result.p50, result.p99, result.max, result.count);
+}
+
+int main()
+{
+    Logger::setLogLevel(LogLevel::WARN);
+
+    ::printf("%-40s | p50(us)   | p99(us)   | max(us)   | samples\n", "control latency under a send flood");
+    report("single lane (all NORMAL)", FunctorPriority::NORMAL, FunctorPriority::NORMAL, 0);
+    report("flood LOW, control HIGH, no budget", FunctorPriority::LOW, FunctorPriority::HIGH, 0);
+    report("flood LOW, control HIGH, 1 ms budget", FunctorPriority::LOW, FunctorPriority::HIGH, 1000);
+    report("flood LOW, control NORMAL, 1 ms budget", FunctorPriority::LOW, FunctorPriority::NORMAL, 1000);
+    return 0;
+}
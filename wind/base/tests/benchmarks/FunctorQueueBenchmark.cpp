@@ -0,0 +1,137 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BenchmarkHelper.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "EventLoopThread.h"
+#include "MpscQueue.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// Compare the lock free pending functor queue of EventLoop with
+// the previous mutex + vector swapping implementation under fan-in.
+constexpr size_t TASKS_PER_PRODUCER = 200000;
+
+// The previous implementation of EventLoop::pendingFunctors_.
+class LockedFunctorQueue {
+public:
+    void push(Functor func)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        functors_.push_back(std::move(func));
+    }
+
+    template <typename Func>
+    size_t consumeAll(Func &&func)
+    {
+        std::vector<Functor> functors;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            functors.swap(functors_);
+        }
+        for (auto &functor : functors) {
+            func(functor);
+        }
+        return functors.size();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<Functor> functors_;
+};
+
+template <typename Queue>
+double benchQueue(size_t producerNum)
+{
+    Queue queue;
+    uint64_t sum = 0;
+    const size_t total = producerNum * TASKS_PER_PRODUCER;
+
+    bench::StopWatch watch;
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producerNum; ++i) {
+        producers.emplace_back([&queue, &sum]() {
+            for (size_t j = 0; j < TASKS_PER_PRODUCER; ++j) {
+                queue.push([&sum]() { ++sum; });
+            }
+        });
+    }
+
+    size_t consumed = 0;
+    while (consumed < total) {
+        size_t cnt = queue.consumeAll([](Functor &func) { func(); });
+        if (cnt == 0) {
+            std::this_thread::yield();
+        }
+        consumed += cnt;
+    }
+    auto elapsedNanos = watch.elapsedNanos();
+
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    return static_cast<double>(elapsedNanos) / static_cast<double>(total);
+}
+
+double benchEventLoop(size_t producerNum)
+{
+    EventLoopThread loopThread("BenchLoop");
+    EventLoop *loop = loopThread.start();
+
+    std::atomic<uint64_t> executed = 0;
+    const size_t total = producerNum * TASKS_PER_PRODUCER;
+
+    bench::StopWatch watch;
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producerNum; ++i) {
+        producers.emplace_back([loop, &executed]() {
+            for (size_t j = 0; j < TASKS_PER_PRODUCER; ++j) {
+                loop->queueToLoop([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    while (executed.load(std::memory_order_relaxed) < total) {
+        std::this_thread::yield();
+    }
+    auto elapsedNanos = watch.elapsedNanos();
+    return static_cast<double>(elapsedNanos) / static_cast<double>(total);
+}
+
+int main()
+{
+    ::printf("producers | mutex+vector(ns/task) | MpscQueue(ns/task) | EventLoop::queueToLoop(ns/task)\n");
+    for (size_t producerNum : {1, 2, 4, 8, 16}) {
+        double locked = benchQueue<LockedFunctorQueue>(producerNum);
+        double lockFree = benchQueue<MpscQueue<Functor>>(producerNum);
+        double loop = benchEventLoop(producerNum);
+        ::printf("%9zu | %21.1f | %18.1f | %31.1f\n", producerNum, locked, lockFree, loop);
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BenchmarkHelper.h"
+
+#include <filesystem>
+#include <vector>
+
+#include "BinaryLog.h"
+#include "LogDaemon.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// Cost of a log line written to the LogDaemon, from several threads at once.
+constexpr uint64_t LINE_NUM = 200000;
+const char *LOG_DIR = "/tmp/wind_log_benchmark/";
+
+template <bool BINARY>
+void benchThreads(size_t threadNum)
+{
+    std::vector<Thread> threads;
+    uint64_t allocsBegin = bench::allocCount();
+    bench::StopWatch watch;
+    for (size_t i = 0; i < threadNum; ++i) {
+        threads.push_back(make_thread("LogBench" + std::to_string(i), [threadNum]() {
+            for (uint64_t j = 0; j < LINE_NUM / threadNum; ++j) {
+                if constexpr (BINARY) {
+                    LOG_BIN_INFO("benchmark line {}, value: {}, name: {}", j, 3.14, "wind");
+                } else {
+                    LOG_INFO << "benchmark line " << j << ", value: " << 3.14 << ", name: " << "wind";
+                }
+            }
+        }));
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    auto elapsedNanos = watch.elapsedNanos();
+    ::printf(
+        "LogBenchmark: %-6s %2zu threads, %8.1f ns/line, %.3f allocations/line\n",
+        BINARY ? "binary" : "text",
+        threadNum,
+        static_cast<double>(elapsedNanos) / LINE_NUM,
+        static_cast<double>(bench::allocCount() - allocsBegin) / LINE_NUM);
+}
+
+// Cost on the calling thread only: the bursts fit in its ring, so the daemon is not woken up during a burst,
+// then the burst is flushed out of the timing.
+template <bool BINARY>
+void benchBurst()
+{
+    constexpr uint64_t BURST_SIZE = 1000;
+    constexpr uint64_t BURST_NUM = 200;
+    int64_t elapsedNanos = 0;
+    uint64_t allocs = 0;
+    for (uint64_t i = 0; i < BURST_NUM; ++i) {
+        uint64_t allocsBegin = bench::allocCount();
+        bench::StopWatch watch;
+        for (uint64_t j = 0; j < BURST_SIZE; ++j) {
+            if constexpr (BINARY) {
+                LOG_BIN_INFO("benchmark line {}, value: {}, name: {}", j, 3.14, "wind");
+            } else {
+                LOG_INFO << "benchmark line " << j << ", value: " << 3.14 << ", name: " << "wind";
+            }
+        }
+        elapsedNanos += watch.elapsedNanos();
+        allocs += bench::allocCount() - allocsBegin;
+        LOG_INFO << "burst " << i << " done" << endl;
+    }
+    ::printf(
+        "LogBenchmark: %-6s burst,      %8.1f ns/line, %.3f allocations/line\n",
+        BINARY ? "binary" : "text",
+        static_cast<double>(elapsedNanos) / (BURST_SIZE * BURST_NUM),
+        static_cast<double>(allocs) / (BURST_SIZE * BURST_NUM));
+}
+
+int main()
+{
+    std::filesystem::create_directories(LOG_DIR);
+    Logger::setLogLevel(LogLevel::INFO);
+    {
+        LogDaemon logDaemon("log_benchmark", LOG_DIR);
+        logDaemon.start();
+        for (size_t threadNum : {1, 4, 16}) {
+            benchThreads<false>(threadNum);
+        }
+        for (size_t threadNum : {1, 4, 16}) {
+            benchThreads<true>(threadNum);
+        }
+        benchBurst<false>();
+        benchBurst<true>();
+    }
+    std::filesystem::remove_all(LOG_DIR);
+    return 0;
+}
@@ -0,0 +1,119 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include "BenchmarkHelper.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "LogFile.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// Throughput of writing the staged log buffers out, as LogDaemon does every harvest.
+constexpr size_t BUFFER_SIZE = 1024 * 1024;
+constexpr size_t BUFFERS_PER_FLUSH = 4;
+constexpr size_t TOTAL_SIZE = 512 * 1024 * 1024;
+const char *LOG_FILE = "/tmp/wind_log_file_benchmark.log";
+
+std::vector<std::string> makeBuffers()
+{
+    std::string line = "2020-01-01 00:00:00.000000 12345 12345 Wind INFO: benchmark line -- LogFileBenchmark.cpp:42\n";
+    std::vector<std::string> buffers;
+    for (size_t i = 0; i < BUFFERS_PER_FLUSH; ++i) {
+        std::string buffer;
+        while (buffer.size() + line.size() <= BUFFER_SIZE) {
+            buffer += line;
+        }
+        buffers.push_back(std::move(buffer));
+    }
+    return buffers;
+}
+
+void report(const char *name, size_t bytes, int64_t elapsedNanos)
+{
+    ::printf(
+        "LogFileBenchmark: %-24s %8.1f MB/s\n",
+        name,
+        static_cast<double>(bytes) / (1024 * 1024) / (static_cast<double>(elapsedNanos) / 1e9));
+}
+
+void benchLogFile(const char *name, LogSyncPolicy policy, bool directIo)
+{
+    std::filesystem::remove(LOG_FILE);
+    auto buffers = makeBuffers();
+    std::vector<struct iovec> vecs;
+    for (auto &buffer : buffers) {
+        vecs.push_back({buffer.data(), buffer.size()});
+    }
+
+    size_t bytes = 0;
+    bench::StopWatch watch;
+    {
+        LogFile file(LOG_FILE, policy);
+        if (directIo && !file.setDirectIo(true)) {
+            ::printf("LogFileBenchmark: %-24s not supported\n", name);
+            return;
+        }
+        while (bytes < TOTAL_SIZE) {
+            file.write(vecs.data(), vecs.size());
+            file.flush();
+            bytes += BUFFER_SIZE * BUFFERS_PER_FLUSH;
+        }
+    }
+    report(name, bytes, watch.elapsedNanos());
+}
+
+// what LogFile did before: an ofstream, one write() per buffer.
+void benchOfstream()
+{
+    std::filesystem::remove(LOG_FILE);
+    auto buffers = makeBuffers();
+
+    size_t bytes = 0;
+    bench::StopWatch watch;
+    {
+        std::ofstream output(LOG_FILE, std::ios::out);
+        while (bytes < TOTAL_SIZE) {
+            for (auto &buffer : buffers) {
+                output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            }
+            output.flush();
+            bytes += BUFFER_SIZE * BUFFERS_PER_FLUSH;
+        }
+    }
+    report("ofstream", bytes, watch.elapsedNanos());
+}
+
+int main()
+{
+    benchOfstream();
+    benchLogFile("writev", LogSyncPolicy::NONE, false);
+    benchLogFile("writev + ON_CLOSE", LogSyncPolicy::ON_CLOSE, false);
+    benchLogFile("writev + EVERY_FLUSH", LogSyncPolicy::EVERY_FLUSH, false);
+    benchLogFile("direct io", LogSyncPolicy::NONE, true);
+    benchLogFile("direct io + EVERY_FLUSH", LogSyncPolicy::EVERY_FLUSH, true);
+    std::filesystem::remove(LOG_FILE);
+    return 0;
+}
@@ -0,0 +1,69 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include "BenchmarkHelper.h"
+
+#include "Log.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// Cost of building a log line, the output is discarded.
+constexpr uint64_t LINE_NUM = 1000000;
+
+void benchEnabled()
+{
+    uint64_t allocsBegin = bench::allocCount();
+    bench::StopWatch watch;
+    for (uint64_t i = 0; i < LINE_NUM; ++i) {
+        LOG_INFO << "benchmark line " << i;
+    }
+    auto elapsedNanos = watch.elapsedNanos();
+    ::printf(
+        "LoggerBenchmark: LOG_INFO,             %6.1f ns/line, %.3f allocations/line\n",
+        static_cast<double>(elapsedNanos) / LINE_NUM,
+        static_cast<double>(bench::allocCount() - allocsBegin) / LINE_NUM);
+}
+
+// below the runtime level, only the level check is paid.
+void benchDisabled()
+{
+    uint64_t allocsBegin = bench::allocCount();
+    bench::StopWatch watch;
+    for (uint64_t i = 0; i < LINE_NUM; ++i) {
+        LOG_TRACE << "benchmark line " << i;
+    }
+    auto elapsedNanos = watch.elapsedNanos();
+    ::printf(
+        "LoggerBenchmark: LOG_TRACE (disabled), %6.1f ns/line, %.3f allocations/line\n",
+        static_cast<double>(elapsedNanos) / LINE_NUM,
+        static_cast<double>(bench::allocCount() - allocsBegin) / LINE_NUM);
+}
+
+int main()
+{
+    LogStream::setOutputFunc([](const char *, size_t) {});
+    Logger::setLogLevel(LogLevel::INFO);
+
+    benchEnabled();
+    benchDisabled();
+    return 0;
+}
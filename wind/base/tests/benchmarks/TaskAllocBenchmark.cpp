@@ -0,0 +1,120 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BenchmarkHelper.h"
+
+#include <functional>
+#include <future>
+#include <string>
+
+#include "EventLoopThread.h"
+#include "MpscQueue.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// Count heap allocations per posted task. The posted lambda captures
+// a this-like pointer, a shared_ptr and a short std::string, which is what
+// TcpConnection posts to its loop.
+constexpr uint64_t TASK_NUM = 100000;
+
+struct Payload {
+    void *owner = nullptr;
+    std::shared_ptr<int> self = std::make_shared<int>(0);
+    std::string msg = "hello";
+};
+
+template <typename Func>
+double allocsPerTask(const char *name, Func &&postTasks)
+{
+    uint64_t allocsBegin = bench::allocCount();
+    bench::StopWatch watch;
+    postTasks();
+    auto elapsedNanos = watch.elapsedNanos();
+    double allocs = static_cast<double>(bench::allocCount() - allocsBegin) / TASK_NUM;
+    ::printf(
+        "%-40s %8.1f ns/task, %.3f allocations/task\n",
+        name,
+        static_cast<double>(elapsedNanos) / TASK_NUM,
+        allocs);
+    return allocs;
+}
+
+template <typename Function>
+void postToQueue()
+{
+    Payload payload;
+    uint64_t sum = 0;
+    MpscQueue<Function> queue;
+    for (uint64_t i = 0; i < TASK_NUM; ++i) {
+        queue.push([&sum, owner(payload.owner), self(payload.self), msg(payload.msg)]() { sum += msg.size(); });
+        queue.consumeAll([](Function &func) { func(); });
+    }
+}
+
+int main()
+{
+    allocsPerTask("MpscQueue<std::function>", postToQueue<std::function<void()>>);
+    double queueAllocs = allocsPerTask("MpscQueue<UniqueFunction>", postToQueue<Functor>);
+
+    EventLoopThread loopThread;
+    EventLoop *loop = loopThread.start();
+    double loopAllocs = allocsPerTask("EventLoop::queueToLoop", [loop]() {
+        Payload payload;
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < TASK_NUM; ++i) {
+            loop->queueToLoop([&sum, owner(payload.owner), self(payload.self), msg(payload.msg)]() {
+                sum += msg.size();
+            });
+        }
+        loop->schedule([]() {}).wait();
+    });
+
+    allocsPerTask("EventLoop::schedule", [loop]() {
+        for (uint64_t i = 0; i < TASK_NUM; ++i) {
+            loop->schedule([]() { return 0; }).get();
+        }
+    });
+
+    ThreadPool pool("BenchPool");
+    pool.setThreadNum(1);
+    pool.setTaskQueueCapacity(TASK_NUM);
+    pool.start();
+    allocsPerTask("ThreadPool::runTask", [&pool]() {
+        Payload payload;
+        std::atomic<uint64_t> sum{0};
+        for (uint64_t i = 0; i < TASK_NUM; ++i) {
+            pool.runTask([&sum, owner(payload.owner), self(payload.self), msg(payload.msg)]() {
+                sum.fetch_add(msg.size(), std::memory_order_relaxed);
+            });
+        }
+        while (sum.load(std::memory_order_relaxed) < TASK_NUM * payload.msg.size()) {
+            std::this_thread::yield();
+        }
+    });
+    pool.stop();
+
+    // Only the queue node should be allocated for a posted task.
+    return (queueAllocs < 1.01 && loopAllocs < 1.01) ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BenchmarkHelper.h"
+
+#include <thread>
+#include <vector>
+
+#include "Log.h"
+#include "ThreadPool.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// Submission throughput of the ThreadPool modes: several threads submit tiny tasks concurrently,
+// and a fork case where the tasks submit tasks themselves, like a parallel divide and conquer.
+// Only meaningful on a machine with at least WORKER_NUM + 4 cores.
+constexpr size_t WORKER_NUM = 4;
+constexpr size_t TASKS_PER_SUBMITTER = 200000;
+constexpr int FORK_DEPTH = 16;
+constexpr size_t FORK_LEAVES = size_t(1) << FORK_DEPTH;
+constexpr size_t FORK_TASKS = FORK_LEAVES * 2 - 1;
+constexpr size_t BATCH_SIZE = 64;
+constexpr size_t PARALLEL_FOR_ITEMS = 4096;
+constexpr size_t PARALLEL_FOR_ROUNDS = 2000;
+
+const char *modeName(ThreadPoolMode mode)
+{
+    return mode == ThreadPoolMode::WORK_STEALING ? "stealing" : "balanced";
+}
+
+void startPool(ThreadPool &pool, ThreadPoolMode mode)
+{
+    pool.setThreadNum(WORKER_NUM);
+    pool.setMode(mode);
+    if (mode == ThreadPoolMode::BALANCED) {
+        pool.setTaskQueueCapacity(1024);
+    }
+    pool.start();
+}
+
+void waitFor(const std::atomic<size_t> &counter, size_t expected)
+{
+    while (counter.load(std::memory_order_acquire) != expected) {
+        std::this_thread::yield();
+    }
+}
+
+void benchSubmit(ThreadPoolMode mode, size_t submitterNum)
+{
+    ThreadPool pool(modeName(mode));
+    startPool(pool, mode);
+
+    std::atomic<size_t> executed = 0;
+    bench::StopWatch watch;
+    std::vector<std::thread> submitters;
+    for (size_t i = 0; i < submitterNum; ++i) {
+        submitters.emplace_back([&pool, &executed]() {
+            for (size_t j = 0; j < TASKS_PER_SUBMITTER; ++j) {
+                pool.runTask([&executed]() { executed.fetch_add(1, std::memory_order_release); });
+            }
+        });
+    }
+    for (auto &t : submitters) {
+        t.join();
+    }
+    auto submitNanos = watch.elapsedNanos();
+    size_t total = submitterNum * TASKS_PER_SUBMITTER;
+    waitFor(executed, total);
+    auto totalNanos = watch.elapsedNanos();
+
+    ::printf(
+        "ThreadPoolBenchmark(%s): %zu submitters, %.1f ns/submit, %.2f M tasks/s\n",
+        modeName(mode),
+        submitterNum,
+        static_cast<double>(submitNanos) * submitterNum / total,
+        static_cast<double>(total) * 1000.0 / totalNanos);
+}
+
+// one submitter putting the same tasks as benchSubmit() by runTasks(), BATCH_SIZE a time.
+void benchBatch(ThreadPoolMode mode)
+{
+    ThreadPool pool(modeName(mode));
+    startPool(pool, mode);
+
+    std::atomic<size_t> executed = 0;
+    bench::StopWatch watch;
+    for (size_t i = 0; i < TASKS_PER_SUBMITTER; i += BATCH_SIZE) {
+        std::vector<UniqueFunction<void()>> tasks;
+        tasks.reserve(BATCH_SIZE);
+        for (size_t j = 0; j < BATCH_SIZE; ++j) {
+            tasks.emplace_back([&executed]() { executed.fetch_add(1, std::memory_order_release); });
+        }
+        pool.runTasks(std::move(tasks));
+    }
+    auto submitNanos = watch.elapsedNanos();
+    size_t total = (TASKS_PER_SUBMITTER + BATCH_SIZE - 1) / BATCH_SIZE * BATCH_SIZE;
+    waitFor(executed, total);
+    auto totalNanos = watch.elapsedNanos();
+
+    ::printf(
+        "ThreadPoolBenchmark(%s): batch of %zu, %.1f ns/submit, %.2f M tasks/s\n",
+        modeName(mode),
+        BATCH_SIZE,
+        static_cast<double>(submitNanos) / total,
+        static_cast<double>(total) * 1000.0 / totalNanos);
+}
+
+// a request handler fanning out a small loop.
+void benchParallelFor(ThreadPoolMode mode)
+{
+    ThreadPool pool(modeName(mode));
+    startPool(pool, mode);
+
+    std::vector<uint64_t> values(PARALLEL_FOR_ITEMS);
+    bench::StopWatch watch;
+    for (size_t round = 0; round < PARALLEL_FOR_ROUNDS; ++round) {
+        pool.parallelFor(0, values.size(), 256, [&values, round](size_t i) { values[i] = i * round; });
+    }
+    auto nanos = watch.elapsedNanos();
+
+    ::printf(
+        "ThreadPoolBenchmark(%s): parallelFor of %zu items, %.1f us/call\n",
+        modeName(mode),
+        PARALLEL_FOR_ITEMS,
+        static_cast<double>(nanos) / PARALLEL_FOR_ROUNDS / 1000.0);
+}
+
+void fork(ThreadPool &pool, int depth, std::atomic<size_t> &leaves)
+{
+    if (depth == 0) {
+        leaves.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    pool.runTask([&pool, depth, &leaves]() { fork(pool, depth - 1, leaves); });
+    pool.runTask([&pool, depth, &leaves]() { fork(pool, depth - 1, leaves); });
+}
+
+void benchFork(ThreadPoolMode mode)
+{
+    ThreadPool pool(modeName(mode));
+    startPool(pool, mode);
+
+    std::atomic<size_t> leaves = 0;
+    bench::StopWatch watch;
+    pool.runTask([&pool, &leaves]() { fork(pool, FORK_DEPTH, leaves); });
+    waitFor(leaves, FORK_LEAVES);
+    auto nanos = watch.elapsedNanos();
+
+    std::string dumpInfo;
+    pool.dump(dumpInfo);
+    ::printf(
+        "ThreadPoolBenchmark(%s): fork %zu tasks in %.1f ms, %.2f M tasks/s\n%s",
+        modeName(mode),
+        FORK_TASKS,
+        static_cast<double>(nanos) / NANO_SECS_PER_MILLISECOND,
+        static_cast<double>(FORK_TASKS) * 1000.0 / nanos,
+        dumpInfo.c_str());
+}
+
+int main()
+{
+    Logger::setLogLevel(LogLevel::WARN);
+
+    for (auto mode : {ThreadPoolMode::BALANCED, ThreadPoolMode::WORK_STEALING}) {
+        for (size_t submitterNum : {1, 2, 4}) {
+            benchSubmit(mode, submitterNum);
+        }
+        benchBatch(mode);
+        benchParallelFor(mode);
+    }
+    // not for BALANCED mode: the workers block each other when posting to the full queues.
+    benchFork(ThreadPoolMode::WORK_STEALING);
+    return 0;
+}
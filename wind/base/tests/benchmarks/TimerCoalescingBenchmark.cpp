@@ -0,0 +1,97 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BenchmarkHelper.h"
+
+#include <random>
+#include <sys/resource.h>
+
+#include "EventLoop.h"
+#include "Log.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// 100k heartbeats with the same interval but random phases, count how many times the loop thread
+// is woken up per second, with and without slack. Every blocking epoll_wait which really sleeps is
+// a voluntary context switch of the loop thread.
+constexpr size_t HEARTBEAT_NUM = 100000;
+constexpr TimeType HEARTBEAT_INTERVAL = MICRO_SECS_PER_SECOND;
+constexpr TimeType WARMUP_TIME = 1 * MICRO_SECS_PER_SECOND;
+constexpr TimeType MEASURE_TIME = 3 * MICRO_SECS_PER_SECOND;
+
+const char *timerManagerTypeName(TimerManagerType type)
+{
+    return type == TimerManagerType::WHEEL ? "wheel" : "sorted";
+}
+
+long voluntarySwitches()
+{
+    rusage usage{};
+    ::getrusage(RUSAGE_THREAD, &usage);
+    return usage.ru_nvcsw;
+}
+
+void benchHeartbeats(TimerManagerType type, TimeType slack)
+{
+    EventLoop loop(PollerType::EPOLL, type);
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<TimeType> phase(0, HEARTBEAT_INTERVAL - 1);
+
+    uint64_t beats = 0;
+    for (size_t i = 0; i < HEARTBEAT_NUM; ++i) {
+        loop.runEvery([&beats]() { ++beats; }, HEARTBEAT_INTERVAL, phase(rng), slack);
+    }
+
+    uint64_t beatsBegin = 0;
+    long switchesBegin = 0;
+    bench::StopWatch watch;
+    loop.runAfter(
+        [&]() {
+            beatsBegin = beats;
+            switchesBegin = voluntarySwitches();
+            watch.reset();
+        },
+        WARMUP_TIME);
+    loop.runAfter([&]() { loop.stop(); }, WARMUP_TIME + MEASURE_TIME);
+    loop.start();
+
+    double seconds = static_cast<double>(watch.elapsedNanos()) / NANO_SECS_PER_SECOND;
+    ::printf(
+        "TimerCoalescingBenchmark(%s): slack %6" PRId64 " us, %.0f beats/s, %.0f wakeups/s\n",
+        timerManagerTypeName(type),
+        slack,
+        static_cast<double>(beats - beatsBegin) / seconds,
+        static_cast<double>(voluntarySwitches() - switchesBegin) / seconds);
+}
+
+int main()
+{
+    Logger::setLogLevel(LogLevel::INFO);
+
+    for (auto type : {TimerManagerType::SORTED, TimerManagerType::WHEEL}) {
+        for (TimeType slackMs : {0, 10, 50}) {
+            benchHeartbeats(type, slackMs * MICRO_SECS_PER_MILLISECOND);
+        }
+    }
+    return 0;
+}
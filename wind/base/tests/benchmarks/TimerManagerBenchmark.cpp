@@ -0,0 +1,165 @@
+// MIT License
+
+// Copyright (c) 2022 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BenchmarkHelper.h"
+
+#include <vector>
+
+#include "EventLoopThread.h"
+#include "Log.h"
+
+using namespace wind;
+using namespace wind::base;
+
+// Compare the timer managers with the idle timeout pattern: every connection holds one timeout,
+// which is cancelled and added again on every message. The operations are done in the loop thread,
+// so addTimer() runs inline and the numbers are the cost of the manager itself.
+constexpr size_t CONNECTION_NUM = 200000;
+constexpr size_t REARM_ROUNDS = 5;
+constexpr TimeType IDLE_TIMEOUT = 30 * MICRO_SECS_PER_SECOND;
+// fire phase: timers spread over FIRE_SPAN after FIRE_DELAY, the loop runs until all of them fired.
+constexpr size_t FIRE_NUM = 100000;
+constexpr TimeType FIRE_DELAY = MICRO_SECS_PER_SECOND;
+constexpr TimeType FIRE_SPAN = 500 * MICRO_SECS_PER_MILLISECOND;
+
+const char *timerManagerTypeName(TimerManagerType type)
+{
+    return type == TimerManagerType::WHEEL ? "wheel" : "sorted";
+}
+
+void printOp(TimerManagerType type, const char *op, size_t count, int64_t elapsedNanos, uint64_t allocs)
+{
+    ::printf(
+        "TimerManagerBenchmark(%s): %-6s %zu ops, %.1f ns/op, %.2f allocations/op\n",
+        timerManagerTypeName(type),
+        op,
+        count,
+        static_cast<double>(elapsedNanos) / count,
+        static_cast<double>(allocs) / count);
+}
+
+void benchIdleTimeouts(TimerManagerType type)
+{
+    EventLoop loop(PollerType::EPOLL, type);
+    std::vector<TimerId> ids;
+    ids.reserve(CONNECTION_NUM);
+
+    // spread the timeouts a bit, like connections accepted at different times.
+    auto timeoutOf = [](size_t i) -> TimeType { return IDLE_TIMEOUT + (i % 1000) * MICRO_SECS_PER_MILLISECOND; };
+
+    bench::StopWatch watch;
+    uint64_t allocsBegin = bench::allocCount();
+    for (size_t i = 0; i < CONNECTION_NUM; ++i) {
+        ids.push_back(loop.runAfter([]() {}, timeoutOf(i)));
+    }
+    printOp(type, "add", CONNECTION_NUM, watch.elapsedNanos(), bench::allocCount() - allocsBegin);
+
+    watch.reset();
+    allocsBegin = bench::allocCount();
+    for (size_t round = 0; round < REARM_ROUNDS; ++round) {
+        for (size_t i = 0; i < CONNECTION_NUM; ++i) {
+            loop.cancel(ids[i]);
+            ids[i] = loop.runAfter([]() {}, timeoutOf(i + round));
+        }
+    }
+    printOp(
+        type, "rearm", CONNECTION_NUM * REARM_ROUNDS, watch.elapsedNanos(), bench::allocCount() - allocsBegin);
+
+    watch.reset();
+    allocsBegin = bench::allocCount();
+    for (auto &id : ids) {
+        loop.cancel(id);
+    }
+    printOp(type, "cancel", CONNECTION_NUM, watch.elapsedNanos(), bench::allocCount() - allocsBegin);
+}
+
+void benchFire(TimerManagerType type)
+{
+    EventLoop loop(PollerType::EPOLL, type);
+
+    size_t fired = 0;
+    TimeType totalLateness = 0;
+    TimeType maxLateness = 0;
+    auto start = timeAdd(TimeStamp::now(), FIRE_DELAY);
+    for (size_t i = 0; i < FIRE_NUM; ++i) {
+        auto expireTime = timeAdd(start, static_cast<TimeType>(i * FIRE_SPAN / FIRE_NUM));
+        loop.runAt(
+            [&, expireTime]() {
+                auto lateness = timeDiff(TimeStamp::now(), expireTime);
+                totalLateness += lateness;
+                maxLateness = std::max(maxLateness, lateness);
+                if (++fired == FIRE_NUM) {
+                    loop.stop();
+                }
+            },
+            expireTime);
+    }
+    loop.start();
+
+    ::printf(
+        "TimerManagerBenchmark(%s): fire   %zu timers over %" PRId64 " ms, lateness avg %.1f us, max %" PRId64 " us\n",
+        timerManagerTypeName(type),
+        FIRE_NUM,
+        FIRE_SPAN / MICRO_SECS_PER_MILLISECOND,
+        static_cast<double>(totalLateness) / FIRE_NUM,
+        maxLateness);
+}
+
+// add and cancel from a thread other than the loop, the caller never waits for the loop.
+void benchForeignThread(TimerManagerType type)
+{
+    EventLoopThread loopThread("TimerLoop", PollerType::EPOLL, type);
+    EventLoop *loop = loopThread.start();
+    std::vector<TimerId> ids;
+    ids.reserve(CONNECTION_NUM);
+
+    bench::StopWatch watch;
+    for (size_t i = 0; i < CONNECTION_NUM; ++i) {
+        ids.push_back(loop->runAfter([]() {}, IDLE_TIMEOUT));
+    }
+    for (auto &id : ids) {
+        loop->cancel(id);
+    }
+    auto callerNanos = watch.elapsedNanos();
+    // wait until the loop applied all of them.
+    loop->schedule([]() {}).wait();
+    auto totalNanos = watch.elapsedNanos();
+
+    ::printf(
+        "TimerManagerBenchmark(%s): foreign add+cancel %zu timers, caller %.1f ns/op, applied in %.1f ms\n",
+        timerManagerTypeName(type),
+        CONNECTION_NUM,
+        static_cast<double>(callerNanos) / (2 * CONNECTION_NUM),
+        static_cast<double>(totalNanos) / NANO_SECS_PER_MILLISECOND);
+}
+
+int main()
+{
+    Logger::setLogLevel(LogLevel::INFO);
+
+    for (auto type : {TimerManagerType::SORTED, TimerManagerType::WHEEL}) {
+        benchIdleTimeouts(type);
+        benchFire(type);
+        benchForeignThread(type);
+    }
+    return 0;
+}
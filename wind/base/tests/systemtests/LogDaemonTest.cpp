@@ -21,7 +21,9 @@
 // SOFTWARE.
 
 #define LOG_TAG "LogDaemonTest"
-#include "Log.h"
+#include "BinaryLog.h"
+
+#include <vector>
 
 #include "LogDaemon.h"
 #include "EventLoop.h"
@@ -29,7 +31,7 @@
 using namespace wind;
 using namespace base;
 
-int main()
+void logWithDaemon()
 {
     LogDaemon logDaemon("log_daemon_test");
     logDaemon.start();
@@ -39,6 +41,28 @@ int main()
     LOG_INFO << "This is LOG_INFO";
     LOG_WARN << "This is LOG_WARN";
     LOG_ERROR << "This is LOG_ERROR";
+    LOG_BIN_INFO("This is LOG_BIN_INFO, formatted by the daemon: {} {} {}", 1, 2.5, "three");
+
+    // every thread logs to its own buffer, the lines of a thread keep their order in the file.
+    std::vector<Thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.push_back(make_thread("LogThread" + std::to_string(i), [i]() {
+            for (int j = 0; j < 10000; ++j) {
+                LOG_INFO << "thread " << i << " line " << j;
+            }
+        }));
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+int main()
+{
+    logWithDaemon();
 
+    // the daemon restored the default outputs when destroyed.
+    LOG_INFO << "This is LOG_INFO after the daemon, written to stdout";
+    LOG_BIN_INFO("This is LOG_BIN_INFO after the daemon, formatted in place: {}", 1);
     return 0;
 }
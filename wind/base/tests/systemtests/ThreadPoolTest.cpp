@@ -116,11 +116,43 @@ void ThreadPoolTest4()
     }
 }
 
+// test5: work stealing mode, tasks posted by tasks stay in the local deque and get stolen by idle workers.
+void ThreadPoolTest5()
+{
+    ThreadPool threadPool("ThreadPool_stealing");
+    threadPool.setThreadNum(4);
+    threadPool.setMode(ThreadPoolMode::WORK_STEALING);
+    threadPool.start();
+
+    std::atomic<int> finished = 0;
+    for (int i = 0; i < 4; ++i) {
+        threadPool.runTask([&threadPool, &finished]() {
+            for (int j = 0; j < 100; ++j) {
+                threadPool.runTask([&finished]() {
+                    usleep(1000);
+                    ++finished;
+                });
+            }
+            ++finished;
+        });
+    }
+
+    while (finished != 404) {
+        std::string dumpInfo;
+        dumpInfo += "\n";
+        threadPool.dump(dumpInfo);
+        ::utils::writeDebugInfo(dumpInfo);
+        sleep(1);
+    }
+    ::utils::writeDebugInfo("All the 404 tasks finished.");
+}
+
 int main()
 {
     ThreadPoolTest1();
     ThreadPoolTest2();
     ThreadPoolTest3();
     ThreadPoolTest4();
+    ThreadPoolTest5();
     return 0;
 }
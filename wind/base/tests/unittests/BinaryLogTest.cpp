@@ -0,0 +1,153 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// INFO and above are kept only, whatever the level at runtime is.
+#define WIND_LOG_MIN_LEVEL 3
+#define LOG_TAG "BinaryLogTest"
+#include "BinaryLog.h"
+
+#include <string>
+#include <vector>
+
+#include "TestHelper.h"
+
+namespace wind {
+namespace base {
+namespace {
+static_assert(detail::countLogPlaceholders("") == 0);
+static_assert(detail::countLogPlaceholders("{} and {}{}, {") == 3);
+
+enum class Color { RED = 1, BLUE };
+
+// keeps the records instead of formatting them in place.
+class RecordCollector {
+public:
+    RecordCollector()
+    {
+        BinaryLogRecord::setOutputFunc([this](const char *record, size_t len) {
+            records_.emplace_back(record, len);
+        });
+    }
+    ~RecordCollector()
+    {
+        BinaryLogRecord::setOutputFunc(nullptr);
+    }
+
+    size_t size() const
+    {
+        return records_.size();
+    }
+
+    const std::string &record(size_t i) const
+    {
+        return records_[i];
+    }
+
+    std::string line(size_t i) const
+    {
+        char buf[MAX_BINARY_LOG_LINE_SIZE];
+        size_t len = BinaryLogRecord::format(records_[i].data(), records_[i].size(), buf, sizeof(buf));
+        return std::string(buf, len);
+    }
+
+private:
+    std::vector<std::string> records_;
+};
+} // namespace
+
+TEST(BinaryLogTest, FormatTest)
+{
+    WIND_TEST_BEGIN(BinaryLogTest, FormatTest);
+
+    Logger::setLogLevel(LogLevel::TRACE);
+    RecordCollector collector;
+    std::string name = "wind";
+    const char *nullString = nullptr;
+    int line = __LINE__ + 1;
+    LOG_BIN_INFO("int {}, uint {}, double {}, bool {}, char {}, enum {}", -42, 42U, 1.5, true, 'x', Color::BLUE);
+    LOG_BIN_WARN("string {} {} {}, null {}", name, "literal", std::string_view("view"), nullString);
+    LOG_BIN_ERROR("no arguments");
+    ASSERT_EQ(collector.size(), 3);
+
+    auto first = collector.line(0);
+    EXPECT_EQ(first.back(), '\n');
+    EXPECT_NE(first.find(" " + std::string(CurrentThread::tidString()) + " BinaryLogTest INFO: "), std::string::npos);
+    EXPECT_NE(first.find("int -42, uint 42, double 1.5, bool true, char x, enum 2"), std::string::npos);
+#ifndef LOG_HIDE_FILE_LINE
+    EXPECT_NE(first.find(" -- BinaryLogTest.cpp:" + std::to_string(line)), std::string::npos);
+#endif
+    EXPECT_NE(collector.line(1).find("WARN: string wind literal view, null (null)"), std::string::npos);
+    EXPECT_NE(collector.line(2).find("ERROR: no arguments"), std::string::npos);
+
+    // the prefix is the same as Logger's.
+    char timeBuf[MAX_TIME_STRING_SIZE];
+    TimeStamp::now().toFormattedString(timeBuf, sizeof(timeBuf), TimePrecision::SECOND);
+    EXPECT_EQ(first.compare(0, 10, timeBuf, 10), 0);
+}
+
+TEST(BinaryLogTest, LevelTest)
+{
+    WIND_TEST_BEGIN(BinaryLogTest, LevelTest);
+
+    RecordCollector collector;
+    // compiled away.
+    Logger::setLogLevel(LogLevel::TRACE);
+    LOG_BIN_TRACE("trace {}", 1);
+    LOG_BIN_DEBUG("debug {}", 2);
+    EXPECT_EQ(collector.size(), 0);
+
+    // filtered at runtime.
+    Logger::setLogLevel(LogLevel::WARN);
+    LOG_BIN_INFO("info {}", 3);
+    EXPECT_EQ(collector.size(), 0);
+    LOG_BIN_WARN("warn {}", 4);
+    EXPECT_EQ(collector.size(), 1);
+    Logger::setLogLevel(LogLevel::TRACE);
+}
+
+TEST(BinaryLogTest, TruncateTest)
+{
+    WIND_TEST_BEGIN(BinaryLogTest, TruncateTest);
+
+    RecordCollector collector;
+    Logger::setLogLevel(LogLevel::TRACE);
+    std::string longString(MAX_BINARY_LOG_RECORD_SIZE * 2, 'y');
+    LOG_BIN_INFO("{} then {}", longString, 7);
+    ASSERT_EQ(collector.size(), 1);
+
+    // the string is cut at the end of the record, the argument left is missing.
+    auto line = collector.line(0);
+    EXPECT_NE(line.find("yyyy then {}"), std::string::npos);
+
+    // the line is cut at the end of the buffer, but still ends the line.
+    char buf[MAX_TIME_STRING_SIZE + 8];
+    const auto &record = collector.record(0);
+    size_t len = BinaryLogRecord::format(record.data(), record.size(), buf, sizeof(buf));
+    EXPECT_EQ(len, sizeof(buf));
+    EXPECT_EQ(buf[len - 1], '\n');
+    EXPECT_EQ(std::string(buf, len - 1), line.substr(0, len - 1));
+
+    // a broken record is not formatted.
+    EXPECT_EQ(BinaryLogRecord::format(record.data(), 1, buf, sizeof(buf)), 0);
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,86 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <sched.h>
+
+#include <thread>
+
+#include "CpuTopology.h"
+#include "TestHelper.h"
+
+namespace wind {
+namespace base {
+TEST(CpuTopologyTest, ParseTest)
+{
+    WIND_TEST_BEGIN(CpuTopologyTest, ParseTest);
+
+    EXPECT_EQ(parseCpuList("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(parseCpuList("5"), (std::vector<int>{5}));
+    EXPECT_EQ(parseCpuList(""), (std::vector<int>{}));
+    EXPECT_EQ(parseCpuList("x,2,3-a,4-4"), (std::vector<int>{2, 4}));
+}
+
+TEST(CpuTopologyTest, PolicyTest)
+{
+    WIND_TEST_BEGIN(CpuTopologyTest, PolicyTest);
+
+    // two nodes with 4 cpus each, interleaved as on some dual-socket machines.
+    CpuTopology topology({{0, {0, 2, 4, 6}}, {1, {1, 3, 5, 7}}});
+    EXPECT_EQ(topology.cpuCount(), 8u);
+    EXPECT_EQ(topology.nodeCount(), 2u);
+    EXPECT_EQ(topology.nodeOfCpu(3), 1);
+    EXPECT_EQ(topology.nodeOfCpu(4), 0);
+    EXPECT_EQ(topology.nodeOfCpu(8), -1);
+    EXPECT_EQ(topology.nodeOfCpu(-1), -1);
+
+    std::vector<int> spread;
+    std::vector<int> compact;
+    for (size_t i = 0; i < 10; ++i) {
+        spread.push_back(topology.cpuFor(AffinityPolicy::SPREAD, i));
+        compact.push_back(topology.cpuFor(AffinityPolicy::COMPACT, i));
+    }
+    EXPECT_EQ(spread, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 0, 1}));
+    EXPECT_EQ(compact, (std::vector<int>{0, 2, 4, 6, 1, 3, 5, 7, 0, 2}));
+
+    EXPECT_EQ(topology.cpuFor(AffinityPolicy::NONE, 3), -1);
+    EXPECT_EQ(topology.cpuFor(AffinityPolicy::CORE_LIST, 3), -1);
+    EXPECT_EQ(topology.cpuFor(AffinityPolicy::CORE_LIST, 3, {5, 7}), 7);
+}
+
+TEST(CpuTopologyTest, PinTest)
+{
+    WIND_TEST_BEGIN(CpuTopologyTest, PinTest);
+
+    const auto &topology = CpuTopology::system();
+    ASSERT_GT(topology.cpuCount(), 0u);
+    ASSERT_GT(topology.nodeCount(), 0u);
+
+    int cpu = topology.cpuFor(AffinityPolicy::COMPACT, topology.cpuCount() - 1);
+    std::thread([&topology, cpu]() {
+        EXPECT_TRUE(pinCurrentThread(cpu));
+        EXPECT_EQ(::sched_getcpu(), cpu);
+        EXPECT_EQ(currentNumaNode(), topology.nodeOfCpu(cpu));
+    }).join();
+    EXPECT_FALSE(pinCurrentThread(-1));
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,254 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <dlfcn.h>
+#include <sys/epoll.h>
+
+#include "EventLoop.h"
+#include "TestHelper.h"
+#include "Utils.h"
+
+namespace wind {
+namespace base {
+namespace {
+const PollerType POLLER_TYPES[] = {PollerType::EPOLL, PollerType::IO_URING};
+
+void notify(int eventFd)
+{
+    uint64_t buf = 1;
+    ASSERT_EQ(::write(eventFd, &buf, sizeof(buf)), sizeof(buf));
+}
+
+void consume(int eventFd)
+{
+    uint64_t buf = 0;
+    UNUSED(::read(eventFd, &buf, sizeof(buf)));
+}
+
+// Runs the loop until some callback stops it, gives up after a second so that a lost event fails instead of hangs.
+void runLoop(EventLoop &loop)
+{
+    auto timerId = loop.runAfter([&loop]() { loop.stop(); }, MICRO_SECS_PER_SECOND);
+    loop.start();
+    loop.cancel(timerId);
+}
+
+// Counts the epoll_ctl calls on one fd, by operation, while alive.
+int g_countedFd = INVALID_FD;
+int g_epollCtlCounts[EPOLL_CTL_MOD + 1] = {0};
+
+class EpollCtlCounter {
+public:
+    explicit EpollCtlCounter(int fd)
+    {
+        g_countedFd = fd;
+        std::fill(std::begin(g_epollCtlCounts), std::end(g_epollCtlCounts), 0);
+    }
+    ~EpollCtlCounter() noexcept
+    {
+        g_countedFd = INVALID_FD;
+    }
+
+    int count(int operation) const
+    {
+        return g_epollCtlCounts[operation];
+    }
+};
+} // namespace
+} // namespace base
+} // namespace wind
+
+extern "C" int epoll_ctl(int epfd, int op, int fd, epoll_event *event) noexcept
+{
+    using EpollCtl = int (*)(int, int, int, epoll_event *);
+    static auto realEpollCtl = reinterpret_cast<EpollCtl>(::dlsym(RTLD_NEXT, "epoll_ctl"));
+    if (fd == wind::base::g_countedFd && op >= 0 && op <= EPOLL_CTL_MOD) {
+        ++wind::base::g_epollCtlCounts[op];
+    }
+    return realEpollCtl(epfd, op, fd, event);
+}
+
+namespace wind {
+namespace base {
+
+TEST(EventPollerTest, RemovedInBatchTest)
+{
+    WIND_TEST_BEGIN(EventPollerTest, RemovedInBatchTest);
+
+    for (auto pollerType : POLLER_TYPES) {
+        EventLoop loop(pollerType);
+        UniqueFd fd1(utils::createEventFdOrDie());
+        UniqueFd fd2(utils::createEventFdOrDie());
+        auto channel1 = std::make_shared<EventChannel>(fd1.get(), &loop);
+        auto channel2 = std::make_shared<EventChannel>(fd2.get(), &loop);
+        int called = 0;
+        // both fds are ready in the same batch, whichever runs first removes the other one.
+        channel1->setReadCallback([&](TimeStamp) {
+            ++called;
+            channel2->disableAll();
+            loop.stop();
+        });
+        channel2->setReadCallback([&](TimeStamp) {
+            ++called;
+            channel1->disableAll();
+            loop.stop();
+        });
+        channel1->enableReading();
+        channel2->enableReading();
+        notify(fd1.get());
+        notify(fd2.get());
+        runLoop(loop);
+        EXPECT_EQ(called, 1);
+        channel1->disableAll();
+        channel2->disableAll();
+    }
+}
+
+TEST(EventPollerTest, FdReusedTest)
+{
+    WIND_TEST_BEGIN(EventPollerTest, FdReusedTest);
+
+    for (auto pollerType : POLLER_TYPES) {
+        EventLoop loop(pollerType);
+        UniqueFd oldFd(utils::createEventFdOrDie());
+        int fd = oldFd.get();
+        auto oldChannel = std::make_shared<EventChannel>(fd, &loop);
+        int oldCalled = 0;
+        oldChannel->setReadCallback([&](TimeStamp) {
+            ++oldCalled;
+            loop.stop();
+        });
+        oldChannel->enableReading();
+        // closed without removing the channel, the next fd created gets the same number.
+        oldFd.reset();
+
+        UniqueFd newFd(utils::createEventFdOrDie());
+        ASSERT_EQ(newFd.get(), fd);
+        auto newChannel = std::make_shared<EventChannel>(fd, &loop);
+        int newCalled = 0;
+        newChannel->setReadCallback([&](TimeStamp) {
+            consume(fd);
+            ++newCalled;
+            loop.stop();
+        });
+        newChannel->enableReading();
+        notify(fd);
+        runLoop(loop);
+        EXPECT_EQ(newCalled, 1);
+        EXPECT_EQ(oldCalled, 0);
+
+        // the late removal of the old channel must leave the new registration intact.
+        oldChannel->disableAll();
+        notify(fd);
+        runLoop(loop);
+        EXPECT_EQ(newCalled, 2);
+        EXPECT_EQ(oldCalled, 0);
+        newChannel->disableAll();
+    }
+}
+
+TEST(EventPollerTest, LazyUpdateTest)
+{
+    WIND_TEST_BEGIN(EventPollerTest, LazyUpdateTest);
+
+    EventLoop loop(PollerType::EPOLL);
+    UniqueFd eventFd(utils::createEventFdOrDie());
+    int fd = eventFd.get();
+    auto channel = std::make_shared<EventChannel>(fd, &loop);
+    int readCalled = 0;
+    int writeCalled = 0;
+    channel->setReadCallback([&](TimeStamp) {
+        consume(fd);
+        ++readCalled;
+        loop.stop();
+    });
+    channel->setWriteCallback([&]() {
+        ++writeCalled;
+        loop.stop();
+    });
+    channel->enableReading();
+    EpollCtlCounter counter(fd);
+
+    // a toggle within one iteration has no net change, nothing is issued.
+    channel->enableWriting();
+    channel->disableWriting();
+    notify(fd);
+    runLoop(loop);
+    EXPECT_EQ(readCalled, 1);
+    EXPECT_EQ(writeCalled, 0);
+    EXPECT_EQ(counter.count(EPOLL_CTL_MOD), 0);
+
+    // a net change is deferred to the next wait, and applied there exactly once.
+    channel->enableWriting();
+    channel->disableWriting();
+    channel->enableWriting();
+    EXPECT_EQ(counter.count(EPOLL_CTL_MOD), 0);
+    runLoop(loop);
+    EXPECT_EQ(writeCalled, 1);
+    EXPECT_EQ(counter.count(EPOLL_CTL_MOD), 1);
+
+    channel->disableWriting();
+    notify(fd);
+    runLoop(loop);
+    EXPECT_EQ(readCalled, 2);
+    EXPECT_EQ(writeCalled, 1);
+    EXPECT_EQ(counter.count(EPOLL_CTL_MOD), 2);
+    EXPECT_EQ(counter.count(EPOLL_CTL_ADD), 0);
+    EXPECT_EQ(counter.count(EPOLL_CTL_DEL), 0);
+    channel->disableAll();
+}
+
+TEST(EventPollerTest, KeepWriteRegisteredTest)
+{
+    WIND_TEST_BEGIN(EventPollerTest, KeepWriteRegisteredTest);
+
+    EventLoop loop(PollerType::EPOLL);
+    UniqueFd eventFd(utils::createEventFdOrDie());
+    int fd = eventFd.get();
+    auto channel = std::make_shared<EventChannel>(fd, &loop);
+    int readCalled = 0;
+    channel->setReadCallback([&](TimeStamp) {
+        consume(fd);
+        ++readCalled;
+        loop.stop();
+    });
+    channel->setWriteCallback([]() {});
+    channel->setKeepWriteRegistered(true);
+    channel->enableEdgeTriggered(false);
+    channel->enableReading();
+    EpollCtlCounter counter(fd);
+
+    // the write interest stays registered, toggling writing never reaches epoll.
+    for (int i = 0; i < 3; ++i) {
+        channel->enableWriting();
+        notify(fd);
+        runLoop(loop);
+        channel->disableWriting();
+        notify(fd);
+        runLoop(loop);
+    }
+    EXPECT_EQ(readCalled, 6);
+    EXPECT_EQ(counter.count(EPOLL_CTL_MOD), 0);
+    channel->disableAll();
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,157 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include "LogFile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "CurrentThread.h"
+#include "TestHelper.h"
+
+namespace wind {
+namespace base {
+namespace {
+namespace fs = std::filesystem;
+
+// a file removed when the test ends.
+class TempFile {
+public:
+    explicit TempFile(const std::string &name)
+        : path_(fs::temp_directory_path() / (name + "." + CurrentThread::pidString() + ".log"))
+    {
+        fs::remove(path_);
+    }
+    ~TempFile()
+    {
+        fs::remove(path_);
+    }
+
+    std::string path() const
+    {
+        return path_.string();
+    }
+
+    std::string content() const
+    {
+        std::ifstream input(path_, std::ios::binary);
+        std::stringstream ss;
+        ss << input.rdbuf();
+        return ss.str();
+    }
+
+private:
+    fs::path path_;
+};
+
+std::string makeLine(size_t i)
+{
+    return "line " + std::to_string(i) + std::string(i % 97, 'x') + "\n";
+}
+} // namespace
+
+TEST(LogFileTest, WriteTest)
+{
+    WIND_TEST_BEGIN(LogFileTest, WriteTest);
+
+    TempFile tempFile("LogFileTest_WriteTest");
+    std::string expected;
+    {
+        LogFile file(tempFile.path());
+        file.write("first\n", 6);
+        expected += "first\n";
+
+        // more iovecs than a writev(2) on the stack takes, with empty ones.
+        std::vector<std::string> lines;
+        for (size_t i = 0; i < 200; ++i) {
+            lines.push_back(i % 10 == 0 ? std::string() : makeLine(i));
+            expected += lines.back();
+        }
+        std::vector<struct iovec> vecs;
+        for (auto &line : lines) {
+            vecs.push_back({line.data(), line.size()});
+        }
+        file.write(vecs.data(), vecs.size());
+        file.flush();
+
+        EXPECT_EQ(file.size(), expected.size());
+        EXPECT_EQ(tempFile.content(), expected);
+    }
+
+    // appended to the existing content.
+    LogFile file(tempFile.path());
+    EXPECT_EQ(file.size(), expected.size());
+    file.write("last\n", 5);
+    EXPECT_EQ(tempFile.content(), expected + "last\n");
+}
+
+TEST(LogFileTest, SyncPolicyTest)
+{
+    WIND_TEST_BEGIN(LogFileTest, SyncPolicyTest);
+
+    for (auto policy : {LogSyncPolicy::NONE, LogSyncPolicy::ON_CLOSE, LogSyncPolicy::EVERY_FLUSH}) {
+        TempFile tempFile("LogFileTest_SyncPolicyTest");
+        {
+            LogFile file(tempFile.path(), policy);
+            EXPECT_EQ(file.syncPolicy(), policy);
+            file.write("synced\n", 7);
+            file.flush();
+        }
+        EXPECT_EQ(tempFile.content(), "synced\n");
+    }
+}
+
+TEST(LogFileTest, DirectIoTest)
+{
+    WIND_TEST_BEGIN(LogFileTest, DirectIoTest);
+
+    TempFile tempFile("LogFileTest_DirectIoTest");
+    std::string expected;
+    {
+        LogFile file(tempFile.path());
+        if (!file.setDirectIo(true)) {
+            GTEST_SKIP() << "O_DIRECT is not supported by " << fs::temp_directory_path();
+        }
+        EXPECT_TRUE(file.directIo());
+
+        // flushed in the middle of the blocks, then more than a whole direct io buffer.
+        size_t i = 0;
+        while (expected.size() < LogFile::DIRECT_IO_BUFFER_SIZE + LogFile::DIRECT_IO_ALIGNMENT * 3) {
+            std::string line = makeLine(i++);
+            file.write(line.data(), line.size());
+            expected += line;
+            if (i % 1000 == 0) {
+                file.flush();
+                // the last partial block is padded until the file is closed.
+                std::string content = tempFile.content();
+                EXPECT_EQ(content.size() % LogFile::DIRECT_IO_ALIGNMENT, 0u);
+                EXPECT_EQ(content.substr(0, expected.size()), expected);
+            }
+        }
+        EXPECT_EQ(file.size(), expected.size());
+    }
+    EXPECT_EQ(tempFile.content(), expected);
+}
+} // namespace base
+} // namespace wind
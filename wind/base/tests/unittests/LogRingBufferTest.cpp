@@ -0,0 +1,112 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string>
+#include <thread>
+
+#include "LogRingBuffer.h"
+#include "TestHelper.h"
+
+namespace wind {
+namespace base {
+TEST(LogRingBufferTest, WrapTest)
+{
+    WIND_TEST_BEGIN(LogRingBufferTest, WrapTest);
+
+    LogRingBuffer ring(1);
+    EXPECT_EQ(ring.capacity(), 4096);
+    EXPECT_TRUE(ring.empty());
+
+    // records of odd lengths wrap around the ring many times.
+    LogRingBuffer::Record record;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        std::string line(i % 300, static_cast<char>('a' + i % 26));
+        ASSERT_TRUE(ring.tryAppend(i, line.data(), line.size()));
+        ASSERT_TRUE(ring.peek(record));
+        EXPECT_EQ(record.time, i);
+        EXPECT_EQ(std::string(record.data, record.len), line);
+        ring.pop(record);
+        EXPECT_FALSE(ring.peek(record));
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(LogRingBufferTest, FullTest)
+{
+    WIND_TEST_BEGIN(LogRingBufferTest, FullTest);
+
+    LogRingBuffer ring(4096);
+    std::string line(100, 'x');
+    size_t count = 0;
+    while (ring.tryAppend(count, line.data(), line.size())) {
+        ++count;
+    }
+    EXPECT_GT(count, 0);
+    EXPECT_LE(ring.size(), ring.capacity());
+
+    // room is made by the consumer.
+    LogRingBuffer::Record record;
+    ASSERT_TRUE(ring.peek(record));
+    EXPECT_EQ(record.time, 0);
+    ring.pop(record);
+    EXPECT_TRUE(ring.tryAppend(count, line.data(), line.size()));
+
+    // a line too long is truncated.
+    std::string longLine(ring.capacity(), 'y');
+    LogRingBuffer emptyRing(4096);
+    ASSERT_TRUE(emptyRing.tryAppend(0, longLine.data(), longLine.size()));
+    ASSERT_TRUE(emptyRing.peek(record));
+    EXPECT_EQ(record.len, emptyRing.maxRecordLen());
+}
+
+TEST(LogRingBufferTest, ProducerConsumerTest)
+{
+    WIND_TEST_BEGIN(LogRingBufferTest, ProducerConsumerTest);
+
+    constexpr uint64_t LINE_NUM = 100000;
+    LogRingBuffer ring(8192);
+    std::thread producer([&ring]() {
+        for (uint64_t i = 0; i < LINE_NUM; ++i) {
+            std::string line = std::to_string(i);
+            while (!ring.tryAppend(i, line.data(), line.size())) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    LogRingBuffer::Record record;
+    while (expected < LINE_NUM) {
+        if (!ring.peek(record)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(record.time, expected);
+        ASSERT_EQ(std::string(record.data, record.len), std::to_string(expected));
+        ring.pop(record);
+        ++expected;
+    }
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
+} // namespace base
+} // namespace wind
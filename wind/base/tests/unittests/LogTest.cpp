@@ -0,0 +1,82 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// longer than the small string buffer of std::string.
+#define LOG_TAG "LogTestWithALongTag"
+#include "Log.h"
+
+#include <string>
+
+#include "TestHelper.h"
+
+namespace wind {
+namespace base {
+namespace {
+static_assert(SourceFileName::baseNameOffset("wind/base/Log.cpp") == 10);
+static_assert(SourceFileName::baseNameOffset("Log.cpp") == 0);
+static_assert(SourceFileName::baseNameOffset("wind/") == 5);
+static_assert(SourceFileName("wind/base/Log.cpp").length() == 7);
+static_assert(WIND_SOURCE_FILE_NAME.length() == sizeof("LogTest.cpp") - 1);
+
+// keeps the lines instead of printing them.
+class LineCollector {
+public:
+    LineCollector()
+    {
+        LogStream::setOutputFunc([this](const char *buf, size_t len) { lines_.append(buf, len); });
+    }
+    ~LineCollector()
+    {
+        LogStream::setOutputFunc(nullptr);
+    }
+
+    const std::string &lines() const
+    {
+        return lines_;
+    }
+
+private:
+    std::string lines_;
+};
+} // namespace
+
+TEST(LogTest, LoggerTest)
+{
+    WIND_TEST_BEGIN(LogTest, LoggerTest);
+
+    Logger::setLogLevel(LogLevel::INFO);
+    std::string lines;
+    {
+        LineCollector collector;
+        LOG_DEBUG << "not logged";
+        LOG_WARN << "logged " << 1;
+        lines = collector.lines();
+    }
+
+    EXPECT_EQ(lines.find("not logged"), std::string::npos);
+    EXPECT_NE(lines.find(" LogTestWithALongTag WARN: logged 1"), std::string::npos);
+#ifndef LOG_HIDE_FILE_LINE
+    EXPECT_NE(lines.find(" -- LogTest.cpp:"), std::string::npos);
+#endif // LOG_HIDE_FILE_LINE
+    EXPECT_EQ(lines.back(), '\n');
+}
+} // namespace base
+} // namespace wind
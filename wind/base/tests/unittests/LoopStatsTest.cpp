@@ -0,0 +1,126 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <thread>
+
+#include "EventLoop.h"
+#include "LoopStats.h"
+#include "TestHelper.h"
+#include "Utils.h"
+
+namespace wind {
+namespace base {
+TEST(LoopStatsTest, HistogramTest)
+{
+    WIND_TEST_BEGIN(LoopStatsTest, HistogramTest);
+
+    // every bucket starts right after the previous one, and values map to the bucket containing them.
+    for (size_t bucket = 1; bucket < HISTOGRAM_BUCKET_NUM; ++bucket) {
+        uint64_t lower = histogramBucketLowerBound(bucket);
+        EXPECT_GT(lower, histogramBucketLowerBound(bucket - 1));
+        EXPECT_EQ(histogramBucketOf(lower), bucket);
+        EXPECT_EQ(histogramBucketOf(lower - 1), bucket - 1);
+    }
+    EXPECT_EQ(histogramBucketOf(UINT64_MAX), HISTOGRAM_BUCKET_NUM - 1);
+
+    LogLinearHistogram histogram;
+    EXPECT_EQ(histogram.snapshot().percentile(0.5), 0);
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 1000);
+    EXPECT_EQ(snapshot.sum, 500500);
+    EXPECT_EQ(snapshot.max, 1000);
+    // at most 1 / HISTOGRAM_SUB_BUCKET_NUM relative error.
+    EXPECT_GE(snapshot.percentile(0.5), 500);
+    EXPECT_LE(snapshot.percentile(0.5), 500 + 500 / HISTOGRAM_SUB_BUCKET_NUM);
+    EXPECT_GE(snapshot.percentile(0.99), 990);
+    EXPECT_LE(snapshot.percentile(0.99), 1000);
+    EXPECT_EQ(snapshot.percentile(1.0), 1000);
+}
+
+TEST(LoopStatsTest, SlowestCallbackTest)
+{
+    WIND_TEST_BEGIN(LoopStatsTest, SlowestCallbackTest);
+
+    EventLoop loop;
+    UniqueFd eventFd(utils::createEventFdOrDie());
+    auto channel = std::make_shared<EventChannel>(eventFd.get(), &loop);
+    channel->setReadCallback([&](TimeStamp) {
+        uint64_t buf = 0;
+        UNUSED(::read(eventFd.get(), &buf, sizeof(buf)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        loop.stop();
+    });
+    channel->enableReading();
+    uint64_t buf = 1;
+    ASSERT_EQ(::write(eventFd.get(), &buf, sizeof(buf)), sizeof(buf));
+    for (int i = 0; i < 10; ++i) {
+        loop.queueToLoop([]() {});
+    }
+    loop.start();
+
+    auto stats = loop.stats();
+    EXPECT_GE(stats.iterations, 1);
+    EXPECT_EQ(stats.slowestCallbackFd, eventFd.get());
+    EXPECT_GE(stats.slowestCallbackTime, 20ULL * NANO_SECS_PER_MILLISECOND);
+    EXPECT_GE(stats.dispatchTime.max, stats.slowestCallbackTime);
+    EXPECT_GE(stats.eventsPerPoll.max, 1);
+    EXPECT_EQ(stats.functorsPerDrain.sum, 10);
+    EXPECT_EQ(stats.pollWaitTime.count, stats.iterations);
+    channel->disableAll();
+}
+
+TEST(LoopStatsTest, FunctorCountTest)
+{
+    WIND_TEST_BEGIN(LoopStatsTest, FunctorCountTest);
+
+    // the low priority functors yield to a high priority one, every functor run is counted once.
+    EventLoop loop;
+    // long enough that only the high priority functors cut a drain short.
+    loop.setLowPriorityBudget(MICRO_SECS_PER_SECOND);
+    constexpr int LOW_NUM = 20;
+    int executed = 0;
+    std::thread producer([&loop, &executed]() {
+        for (int i = 0; i < LOW_NUM; ++i) {
+            loop.queueToLoop(
+                [&loop, &executed, i]() {
+                    ++executed;
+                    if (i % 5 == 1) {
+                        loop.queueToLoop([&executed]() { ++executed; }, FunctorPriority::HIGH);
+                    }
+                    if (i == LOW_NUM - 1) {
+                        loop.stop();
+                    }
+                },
+                FunctorPriority::LOW);
+        }
+    });
+    loop.start();
+    producer.join();
+
+    EXPECT_EQ(executed, LOW_NUM + LOW_NUM / 5);
+    EXPECT_EQ(loop.stats().functorsPerDrain.sum, static_cast<uint64_t>(executed));
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,132 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <vector>
+
+#include "EventLoopThread.h"
+#include "LoopWatchdog.h"
+#include "TestHelper.h"
+
+namespace wind {
+namespace base {
+namespace {
+constexpr TimeType THRESHOLD = 20 * MICRO_SECS_PER_MILLISECOND;
+
+class StallRecorder {
+public:
+    LoopStallCallback callback()
+    {
+        return [this](const LoopStall &stall) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stalls_.push_back(stall);
+        };
+    }
+
+    std::vector<LoopStall> stalls()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stalls_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<LoopStall> stalls_;
+};
+
+void block(TimeType micros)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(micros));
+}
+} // namespace
+
+TEST(LoopWatchdogTest, FunctorStallTest)
+{
+    WIND_TEST_BEGIN(LoopWatchdogTest, FunctorStallTest);
+
+    EventLoopThread loopThread("StalledLoop");
+    EventLoop *loop = loopThread.start();
+    StallRecorder recorder;
+    LoopWatchdog watchdog(THRESHOLD);
+    watchdog.setStallCallback(recorder.callback());
+    watchdog.watch(loop);
+    watchdog.start();
+
+    // fast functors are never reported.
+    for (int i = 0; i < 100; ++i) {
+        loop->schedule([]() { block(100); }).wait();
+    }
+    EXPECT_EQ(watchdog.stallCount(), 0);
+
+    // a stalled functor is reported once.
+    loop->schedule([]() { block(5 * THRESHOLD); }).wait();
+    watchdog.stop();
+    auto stalls = recorder.stalls();
+    ASSERT_EQ(stalls.size(), 1);
+    EXPECT_EQ(watchdog.stallCount(), 1);
+    EXPECT_EQ(stalls[0].threadName, "StalledLoop");
+    EXPECT_EQ(stalls[0].tid, loop->threadId());
+    EXPECT_EQ(stalls[0].type, LoopCallbackType::FUNCTOR);
+    EXPECT_EQ(stalls[0].fd, -1);
+    EXPECT_GE(stalls[0].duration, THRESHOLD);
+    EXPECT_TRUE(stalls[0].backtrace.empty());
+}
+
+TEST(LoopWatchdogTest, ChannelStallTest)
+{
+    WIND_TEST_BEGIN(LoopWatchdogTest, ChannelStallTest);
+
+    EventLoopThread loopThread("StalledLoop");
+    EventLoop *loop = loopThread.start();
+    StallRecorder recorder;
+    LoopWatchdog watchdog(THRESHOLD);
+    watchdog.setStallCallback(recorder.callback());
+    watchdog.setBacktraceEnabled(true);
+    watchdog.watch(loop);
+    watchdog.start();
+
+    UniqueFd eventFd(utils::createEventFdOrDie());
+    auto channel = std::make_shared<EventChannel>(eventFd.get(), loop);
+    std::promise<void> handled;
+    channel->setReadCallback([&](TimeStamp) {
+        uint64_t buf = 0;
+        UNUSED(::read(eventFd.get(), &buf, sizeof(buf)));
+        block(5 * THRESHOLD);
+        handled.set_value();
+    });
+    loop->schedule([&]() { channel->enableReading(); }).wait();
+    uint64_t buf = 1;
+    ASSERT_EQ(::write(eventFd.get(), &buf, sizeof(buf)), sizeof(buf));
+    handled.get_future().wait();
+    watchdog.stop();
+
+    auto stalls = recorder.stalls();
+    ASSERT_EQ(stalls.size(), 1);
+    EXPECT_EQ(stalls[0].type, LoopCallbackType::READ);
+    EXPECT_EQ(stalls[0].fd, eventFd.get());
+    EXPECT_GE(stalls[0].duration, THRESHOLD);
+    EXPECT_FALSE(stalls[0].backtrace.empty());
+    EXPECT_EQ(stalls[0].backtrace.find("capture backtrace"), std::string::npos);
+
+    loop->schedule([&]() { channel->disableAll(); }).wait();
+}
+} // namespace base
+} // namespace wind
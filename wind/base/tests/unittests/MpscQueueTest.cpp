@@ -0,0 +1,129 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "MpscQueue.h"
+#include "TestHelper.h"
+
+namespace wind {
+namespace base {
+TEST(MpscQueueTest, ConsumeAllTest)
+{
+    WIND_TEST_BEGIN(MpscQueueTest, ConsumeAllTest);
+
+    MpscQueue<int> queue;
+    EXPECT_TRUE(queue.empty());
+    for (int i = 0; i < 10; ++i) {
+        queue.push(i);
+    }
+    EXPECT_FALSE(queue.empty());
+
+    std::vector<int> values;
+    EXPECT_EQ(queue.consumeAll([&](int value) {
+        values.push_back(value);
+        queue.push(value + 100); // not consumed this time.
+    }), 10);
+    ASSERT_EQ(values.size(), 10);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(values[i], i);
+    }
+    EXPECT_FALSE(queue.empty());
+    EXPECT_EQ(queue.consumeAll([](int) {}), 10);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, ConsumeUntilTest)
+{
+    WIND_TEST_BEGIN(MpscQueueTest, ConsumeUntilTest);
+
+    MpscQueue<int> queue;
+    for (int i = 0; i < 10; ++i) {
+        queue.push(i);
+    }
+
+    std::vector<int> values;
+    auto collect = [&values](int value) { values.push_back(value); };
+    EXPECT_EQ(queue.consumeUntil(collect, [&values]() { return values.size() == 4; }), 4);
+    EXPECT_TRUE(queue.hasBacklog());
+    EXPECT_TRUE(queue.empty());
+
+    // values pushed meanwhile go after the backlog.
+    for (int i = 10; i < 15; ++i) {
+        queue.push(i);
+    }
+    EXPECT_EQ(queue.consumeUntil(collect, [&values]() { return values.size() == 8; }), 4);
+    EXPECT_TRUE(queue.hasBacklog());
+    EXPECT_EQ(queue.consumeAll(collect), 7);
+    EXPECT_FALSE(queue.hasBacklog());
+
+    ASSERT_EQ(values.size(), 15);
+    for (int i = 0; i < 15; ++i) {
+        EXPECT_EQ(values[i], i);
+    }
+
+    // the backlog is released on destruction.
+    auto *leftQueue = new MpscQueue<std::unique_ptr<int>>();
+    leftQueue->push(std::make_unique<int>(1));
+    leftQueue->push(std::make_unique<int>(2));
+    leftQueue->consumeUntil([](std::unique_ptr<int> &) {}, []() { return true; });
+    EXPECT_TRUE(leftQueue->hasBacklog());
+    delete leftQueue;
+}
+
+TEST(MpscQueueTest, MultiProducerTest)
+{
+    WIND_TEST_BEGIN(MpscQueueTest, MultiProducerTest);
+
+    constexpr int PRODUCER_NUM = 4;
+    constexpr int VALUE_NUM = 10000;
+    MpscQueue<std::pair<int, int>> queue;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCER_NUM; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < VALUE_NUM; ++i) {
+                queue.push(p, i);
+            }
+        });
+    }
+
+    // values of each producer keep their order, even across partial consumes.
+    std::vector<int> next(PRODUCER_NUM, 0);
+    int consumed = 0;
+    auto check = [&](std::pair<int, int> &value) {
+        EXPECT_EQ(value.second, next[value.first]);
+        next[value.first] = value.second + 1;
+        ++consumed;
+    };
+    while (consumed < PRODUCER_NUM * VALUE_NUM) {
+        queue.consumeUntil(check, [&consumed]() { return consumed % 7 == 0; });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.hasBacklog());
+}
+} // namespace base
+} // namespace wind
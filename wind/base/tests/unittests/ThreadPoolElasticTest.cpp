@@ -0,0 +1,99 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <unistd.h>
+
+#include <atomic>
+#include <functional>
+
+#include "TestHelper.h"
+#include "ThreadPool.h"
+
+namespace wind {
+namespace base {
+namespace {
+// poll for at most 3 seconds.
+bool waitUntil(const std::function<bool()> &condition)
+{
+    for (int i = 0; i < 3000; ++i) {
+        if (condition()) {
+            return true;
+        }
+        usleep(1000);
+    }
+    return condition();
+}
+} // namespace
+
+TEST(ThreadPoolElasticTest, SpawnRetireTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolElasticTest, SpawnRetireTest);
+
+    ThreadPool pool;
+    pool.setThreadNumRange(1, 4);
+    pool.setSpawnLatency(2 * MICRO_SECS_PER_MILLISECOND);
+    pool.setKeepAliveTime(100 * MICRO_SECS_PER_MILLISECOND);
+    pool.start();
+    EXPECT_EQ(pool.threadNum(), 1u);
+
+    // a burst queued on the only worker, the backlog is handed over to the spawned ones.
+    std::atomic<int> finished = 0;
+    for (int i = 0; i < 16; ++i) {
+        pool.runTask([&finished]() {
+            usleep(20 * 1000);
+            ++finished;
+        });
+    }
+    EXPECT_TRUE(waitUntil([&pool]() { return pool.threadNum() == 4; }));
+    EXPECT_TRUE(waitUntil([&finished]() { return finished == 16; }));
+
+    std::string dumpInfo;
+    pool.dump(dumpInfo);
+    EXPECT_NE(dumpInfo.find("spawned: 3"), std::string::npos) << dumpInfo;
+
+    // the idle ones retire down to the min.
+    EXPECT_TRUE(waitUntil([&pool]() { return pool.threadNum() == 1; }));
+    dumpInfo.clear();
+    pool.dump(dumpInfo);
+    EXPECT_NE(dumpInfo.find("retired: 3"), std::string::npos) << dumpInfo;
+}
+
+TEST(ThreadPoolElasticTest, MinZeroTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolElasticTest, MinZeroTest);
+
+    ThreadPool pool;
+    pool.setThreadNumRange(0, 2);
+    pool.setKeepAliveTime(50 * MICRO_SECS_PER_MILLISECOND);
+    pool.start();
+    EXPECT_EQ(pool.threadNum(), 0u);
+
+    auto tid = CurrentThread::tid();
+    EXPECT_NE(pool.submit([]() { return CurrentThread::tid(); }).get(), tid);
+    EXPECT_EQ(pool.threadNum(), 1u);
+
+    EXPECT_TRUE(waitUntil([&pool]() { return pool.threadNum() == 0; }));
+    EXPECT_EQ(pool.submit([]() { return 1; }).get(), 1);
+    pool.stop();
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,172 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <unistd.h>
+
+#include <atomic>
+#include <future>
+#include <vector>
+
+#include "TestHelper.h"
+#include "ThreadPool.h"
+
+namespace wind {
+namespace base {
+namespace {
+using Task = UniqueFunction<void()>;
+
+// A pool of one worker whose queue (capacity 1) is full: the worker is blocked in a task until release().
+class FullThreadPool {
+public:
+    explicit FullThreadPool(OverloadPolicy policy)
+    {
+        pool_.setThreadNum(1);
+        pool_.setTaskQueueCapacity(1);
+        pool_.setOverloadPolicy(policy);
+        pool_.start();
+
+        std::promise<void> started;
+        auto startedFuture = started.get_future();
+        auto releaseFuture = release_.get_future().share();
+        pool_.runTask([&started, releaseFuture]() {
+            started.set_value();
+            releaseFuture.wait();
+        });
+        startedFuture.wait();
+        EXPECT_EQ(pool_.runTask([this]() { order_.push_back(0); }), TaskSubmitResult::QUEUED);
+    }
+
+    ~FullThreadPool()
+    {
+        release();
+    }
+
+    ThreadPool &pool()
+    {
+        return pool_;
+    }
+
+    void release()
+    {
+        if (!released_) {
+            released_ = true;
+            release_.set_value();
+        }
+    }
+
+    // Wait for all the queued tasks finished, return the ids of the tasks run by the worker in order.
+    std::vector<int> finish()
+    {
+        release();
+        while (!pool_.empty()) {
+            usleep(1000);
+        }
+        pool_.stop(); // joins the worker after its last task.
+        return order_;
+    }
+
+    Task makeTask(int id)
+    {
+        return [this, id]() { order_.push_back(id); };
+    }
+
+private:
+    ThreadPool pool_;
+    std::promise<void> release_;
+    bool released_ = false;
+    std::vector<int> order_; // only accessed by the worker.
+};
+} // namespace
+
+TEST(ThreadPoolOverloadTest, BlockTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolOverloadTest, BlockTest);
+
+    FullThreadPool fullPool(OverloadPolicy::BLOCK);
+    auto task = fullPool.makeTask(1);
+    EXPECT_EQ(fullPool.pool().tryRunTask(std::move(task)), TaskSubmitResult::REJECTED);
+    EXPECT_TRUE(static_cast<bool>(task)); // not consumed, the caller can retry later.
+    EXPECT_EQ(fullPool.pool().overloadStats().rejected, 1u);
+
+    // runTask() waits for the room.
+    std::thread releaser([&fullPool]() {
+        usleep(10 * 1000);
+        fullPool.release();
+    });
+    EXPECT_EQ(fullPool.pool().runTask(std::move(task)), TaskSubmitResult::QUEUED);
+    releaser.join();
+    EXPECT_EQ(fullPool.finish(), (std::vector<int>{0, 1}));
+}
+
+TEST(ThreadPoolOverloadTest, RejectTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolOverloadTest, RejectTest);
+
+    FullThreadPool fullPool(OverloadPolicy::REJECT);
+    EXPECT_EQ(fullPool.pool().tryRunTask(fullPool.makeTask(1)), TaskSubmitResult::REJECTED);
+    EXPECT_EQ(fullPool.pool().runTask(fullPool.makeTask(2)), TaskSubmitResult::REJECTED);
+    EXPECT_EQ(fullPool.pool().overloadStats().rejected, 2u);
+    EXPECT_EQ(fullPool.finish(), (std::vector<int>{0}));
+}
+
+TEST(ThreadPoolOverloadTest, CallerRunsTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolOverloadTest, CallerRunsTest);
+
+    FullThreadPool fullPool(OverloadPolicy::CALLER_RUNS);
+    bool ran = false;
+    EXPECT_EQ(fullPool.pool().tryRunTask([&ran]() { ran = true; }), TaskSubmitResult::RAN_IN_CALLER);
+    EXPECT_TRUE(ran);
+    EXPECT_EQ(fullPool.pool().overloadStats().callerRuns, 1u);
+    EXPECT_EQ(fullPool.finish(), (std::vector<int>{0}));
+}
+
+TEST(ThreadPoolOverloadTest, DropOldestTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolOverloadTest, DropOldestTest);
+
+    FullThreadPool fullPool(OverloadPolicy::DROP_OLDEST);
+    EXPECT_EQ(fullPool.pool().tryRunTask(fullPool.makeTask(1)), TaskSubmitResult::DROPPED_OLDEST);
+    EXPECT_EQ(fullPool.pool().tryRunTask(fullPool.makeTask(2)), TaskSubmitResult::DROPPED_OLDEST);
+    EXPECT_EQ(fullPool.pool().overloadStats().droppedOldest, 2u);
+    EXPECT_EQ(fullPool.finish(), (std::vector<int>{2}));
+}
+
+TEST(ThreadPoolOverloadTest, SpillTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolOverloadTest, SpillTest);
+
+    FullThreadPool fullPool(OverloadPolicy::SPILL);
+    for (int id = 1; id <= 100; ++id) {
+        EXPECT_EQ(fullPool.pool().tryRunTask(fullPool.makeTask(id)), TaskSubmitResult::SPILLED);
+    }
+    EXPECT_EQ(fullPool.pool().overloadStats().spilled, 100u);
+    EXPECT_EQ(fullPool.pool().taskSize(), 101u);
+
+    std::vector<int> expected;
+    for (int id = 0; id <= 100; ++id) {
+        expected.push_back(id);
+    }
+    EXPECT_EQ(fullPool.finish(), expected);
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,135 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <vector>
+
+#include "TestHelper.h"
+#include "ThreadPool.h"
+
+namespace wind {
+namespace base {
+namespace {
+constexpr ThreadPoolMode MODES[] = {ThreadPoolMode::BALANCED, ThreadPoolMode::WORK_STEALING};
+} // namespace
+
+TEST(ThreadPoolSubmitTest, SubmitTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolSubmitTest, SubmitTest);
+
+    for (auto mode : MODES) {
+        ThreadPool pool;
+        pool.setThreadNum(2);
+        pool.setMode(mode);
+        pool.start();
+
+        auto future = pool.submit([]() { return 42; });
+        EXPECT_EQ(future.get(), 42);
+
+        auto voidFuture = pool.submit([]() {});
+        voidFuture.wait();
+    }
+}
+
+TEST(ThreadPoolSubmitTest, BatchTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolSubmitTest, BatchTest);
+
+    for (auto mode : MODES) {
+        ThreadPool pool;
+        pool.setThreadNum(3);
+        pool.setTaskQueueCapacity(8); // most of the batch overflows the queues and goes through runTask().
+        pool.setMode(mode);
+        pool.start();
+
+        std::vector<UniqueFunction<int()>> funcs;
+        for (int i = 0; i < 100; ++i) {
+            funcs.emplace_back([i]() { return i * i; });
+        }
+        auto futures = pool.submitBatch(funcs);
+        ASSERT_EQ(futures.size(), funcs.size());
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_EQ(futures[i].get(), i * i);
+        }
+
+        std::atomic<int> count = 0;
+        std::vector<UniqueFunction<void()>> tasks;
+        for (int i = 0; i < 100; ++i) {
+            tasks.emplace_back([&count]() { ++count; });
+        }
+        std::vector<std::future<void>> done = pool.submitBatch(tasks);
+        for (auto &future : done) {
+            future.wait();
+        }
+        EXPECT_EQ(count.load(), 100);
+    }
+}
+
+TEST(ThreadPoolSubmitTest, ParallelForTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolSubmitTest, ParallelForTest);
+
+    for (auto mode : MODES) {
+        ThreadPool pool;
+        pool.setThreadNum(4);
+        pool.setMode(mode);
+        pool.start();
+
+        std::vector<std::atomic<int>> hits(10007);
+        pool.parallelFor(0, hits.size(), 0, [&hits](size_t i) { hits[i].fetch_add(1); });
+        pool.parallelFor(5, 17, 1, [&hits](size_t i) { hits[i].fetch_add(1); });
+        pool.parallelFor(3, 3, 1, [&hits](size_t i) { hits[i].fetch_add(1); });
+        for (size_t i = 0; i < hits.size(); ++i) {
+            EXPECT_EQ(hits[i].load(), (i >= 5 && i < 17) ? 2 : 1) << i;
+        }
+
+        // nested in the tasks of the pool, the callers never wait for the helpers queued behind them.
+        std::vector<std::future<long>> sums;
+        for (int i = 0; i < 8; ++i) {
+            sums.push_back(pool.submit([&pool]() {
+                std::vector<long> values(1000);
+                pool.parallelFor(0, values.size(), 10, [&values](size_t i) { values[i] = static_cast<long>(i); });
+                return std::accumulate(values.begin(), values.end(), 0L);
+            }));
+        }
+        for (auto &sum : sums) {
+            EXPECT_EQ(sum.get(), 999L * 1000 / 2);
+        }
+    }
+}
+
+TEST(ThreadPoolSubmitTest, NoThreadTest)
+{
+    WIND_TEST_BEGIN(ThreadPoolSubmitTest, NoThreadTest);
+
+    ThreadPool pool;
+    pool.start();
+    EXPECT_EQ(pool.submit([]() { return 1; }).get(), 1);
+
+    int sum = 0;
+    pool.parallelFor(0, 10, 3, [&sum](size_t i) { sum += static_cast<int>(i); });
+    EXPECT_EQ(sum, 45);
+}
+} // namespace base
+} // namespace wind
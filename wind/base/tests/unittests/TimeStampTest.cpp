@@ -23,6 +23,7 @@
 #include "TimeStamp.h"
 
 #include <gtest/gtest.h>
+#include <ctime>
 #include <iostream>
 
 using std::cout;
@@ -49,5 +50,49 @@ TEST(TimeStampTest, NowTest)
     cout << "toFormattedString(second): " << t.toFormattedString(TimePrecision::SECOND) << endl;
     EXPECT_GT(t.get(), 0);
 }
+
+TEST(TimeStampTest, BufferFormatTest)
+{
+    // 2020-01-02 03:04:05.006007 local time.
+    struct tm tm {};
+    tm.tm_year = 2020 - 1900;
+    tm.tm_mon = 0;
+    tm.tm_mday = 2;
+    tm.tm_hour = 3;
+    tm.tm_min = 4;
+    tm.tm_sec = 5;
+    tm.tm_isdst = -1;
+    TimeType seconds = ::mktime(&tm);
+    TimeStamp t(seconds * MICRO_SECS_PER_SECOND + 6007);
+
+    char buf[MAX_TIME_STRING_SIZE];
+    EXPECT_EQ(t.toFormattedString(buf, sizeof(buf), TimePrecision::MICRO), 26);
+    EXPECT_STREQ(buf, "2020-01-02 03:04:05.006007");
+    EXPECT_EQ(t.toFormattedString(buf, sizeof(buf), TimePrecision::MILLI), 23);
+    EXPECT_STREQ(buf, "2020-01-02 03:04:05.006");
+    EXPECT_EQ(t.toFormattedString(buf, sizeof(buf), TimePrecision::SECOND), 23);
+    EXPECT_STREQ(buf, "2020-01-02 03:04:05.000");
+    EXPECT_EQ(t.toFormattedString(), "2020-01-02 03:04:05.006");
+
+    // the cached second is formatted again when it changes.
+    TimeStamp nextSecond(t.get() + MICRO_SECS_PER_SECOND + 900000);
+    nextSecond.toFormattedString(buf, sizeof(buf), TimePrecision::MICRO);
+    EXPECT_STREQ(buf, "2020-01-02 03:04:06.906007");
+    t.toFormattedString(buf, sizeof(buf), TimePrecision::MICRO);
+    EXPECT_STREQ(buf, "2020-01-02 03:04:05.006007");
+
+    std::string epochString = std::to_string(seconds);
+    EXPECT_EQ(t.toString(buf, sizeof(buf), TimePrecision::MICRO), epochString.size() + 7);
+    EXPECT_EQ(buf, epochString + ".006007");
+    EXPECT_EQ(t.toString(), epochString + ".006");
+    EXPECT_EQ(TimeStamp(-1).toString(TimePrecision::MICRO), "-0.000001");
+    EXPECT_EQ(TimeStamp(-MICRO_SECS_PER_SECOND - 6007).toString(TimePrecision::MICRO), "-1.006007");
+    EXPECT_EQ(TimeStamp(-6007).toString(), "-0.006");
+
+    // too small buffer.
+    char smallBuf[8];
+    EXPECT_EQ(t.toString(smallBuf, sizeof(smallBuf)), 0);
+    EXPECT_EQ(t.toFormattedString(smallBuf, sizeof(smallBuf)), 0);
+}
 } // namespace base
 } // namespace wind
@@ -0,0 +1,235 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <vector>
+
+#include "EventLoopThread.h"
+#include "TestHelper.h"
+
+namespace wind {
+namespace base {
+namespace {
+constexpr TimerManagerType TIMER_MANAGER_TYPES[] = {TimerManagerType::SORTED, TimerManagerType::WHEEL};
+constexpr TimeType MS = MICRO_SECS_PER_MILLISECOND;
+} // namespace
+
+TEST(TimerManagerTest, OrderTest)
+{
+    WIND_TEST_BEGIN(TimerManagerTest, OrderTest);
+
+    for (auto type : TIMER_MANAGER_TYPES) {
+        EventLoop loop(PollerType::EPOLL, type);
+        EXPECT_EQ(loop.timerManagerType(), type);
+
+        std::vector<int> order;
+        auto start = TimeStamp::now();
+        // 300ms is beyond the root wheel with 1ms tick, it has to be cascaded.
+        loop.runAfter(
+            [&]() {
+                order.push_back(300);
+                EXPECT_GE(timeDiff(TimeStamp::now(), start), 300 * MS);
+                loop.stop();
+            },
+            300 * MS);
+        loop.runAfter([&]() { order.push_back(30); }, 30 * MS);
+        loop.runAfter([&]() { order.push_back(10); }, 10 * MS);
+        loop.runAfter([&]() { order.push_back(0); }, 0);
+        loop.runAfter([&]() { order.push_back(20); }, 20 * MS);
+        loop.start();
+
+        EXPECT_EQ(order, (std::vector<int>{0, 10, 20, 30, 300}));
+    }
+}
+
+TEST(TimerManagerTest, CancelTest)
+{
+    WIND_TEST_BEGIN(TimerManagerTest, CancelTest);
+
+    for (auto type : TIMER_MANAGER_TYPES) {
+        EventLoop loop(PollerType::EPOLL, type);
+
+        bool cancelledRun = false;
+        auto cancelled = loop.runAfter([&]() { cancelledRun = true; }, 10 * MS);
+        loop.cancel(cancelled);
+        // cancel twice is harmless.
+        loop.cancel(cancelled);
+
+        // the repeat timer cancels itself in its own callback.
+        int repeatCount = 0;
+        TimerId repeatId;
+        repeatId = loop.runEvery(
+            [&]() {
+                if (++repeatCount == 3) {
+                    loop.cancel(repeatId);
+                }
+            },
+            5 * MS);
+
+        loop.runAfter([&]() { loop.stop(); }, 60 * MS);
+        loop.start();
+
+        EXPECT_FALSE(cancelledRun);
+        EXPECT_EQ(repeatCount, 3);
+    }
+}
+
+TEST(TimerManagerTest, RearmTest)
+{
+    WIND_TEST_BEGIN(TimerManagerTest, RearmTest);
+
+    for (auto type : TIMER_MANAGER_TYPES) {
+        EventLoop loop(PollerType::EPOLL, type);
+
+        // an idle timeout pushed back by every "message", it fires only after the messages stop.
+        int messages = 0;
+        int messagesAtTimeout = -1;
+        auto onIdle = [&]() {
+            messagesAtTimeout = messages;
+            loop.stop();
+        };
+        TimerId idle = loop.runAfter(onIdle, 50 * MS);
+        TimerId ticker;
+        ticker = loop.runEvery(
+            [&]() {
+                loop.cancel(idle);
+                idle = loop.runAfter(onIdle, 50 * MS);
+                if (++messages == 10) {
+                    loop.cancel(ticker);
+                }
+            },
+            5 * MS);
+
+        // not timed out in time.
+        loop.runAfter([&]() { loop.stop(); }, 1000 * MS);
+        loop.start();
+
+        EXPECT_EQ(messages, 10);
+        EXPECT_EQ(messagesAtTimeout, 10);
+    }
+}
+TEST(TimerManagerTest, SlackTest)
+{
+    WIND_TEST_BEGIN(TimerManagerTest, SlackTest);
+
+    for (auto type : TIMER_MANAGER_TYPES) {
+        EventLoop loop(PollerType::EPOLL, type);
+
+        constexpr int TIMER_NUM = 100;
+        constexpr TimeType SLACK = 10 * MS;
+        std::vector<TimeStamp> fireTimes;
+        for (int i = 0; i < TIMER_NUM; ++i) {
+            auto dstTime = timeAdd(TimeStamp::now(), 20 * MS + i * 37);
+            loop.runAt(
+                [&, dstTime]() {
+                    auto now = TimeStamp::now();
+                    EXPECT_GE(now, dstTime);
+                    fireTimes.push_back(now);
+                    if (fireTimes.size() == TIMER_NUM) {
+                        loop.stop();
+                    }
+                },
+                dstTime,
+                SLACK);
+        }
+        loop.start();
+
+        // 100 timers within 3.7ms are aligned to at most 2 expire times 8ms apart,
+        // so they are handled in at most 2 bursts.
+        int bursts = 1;
+        for (size_t i = 1; i < fireTimes.size(); ++i) {
+            if (timeDiff(fireTimes[i], fireTimes[i - 1]) > 2 * MS) {
+                ++bursts;
+            }
+        }
+        EXPECT_LE(bursts, 2);
+    }
+}
+
+TEST(TimerManagerTest, StaleIdTest)
+{
+    WIND_TEST_BEGIN(TimerManagerTest, StaleIdTest);
+
+    for (auto type : TIMER_MANAGER_TYPES) {
+        EventLoop loop(PollerType::EPOLL, type);
+
+        // cancelling an invalid id or a fired one does nothing.
+        loop.cancel(TimerId());
+        TimerId fired = loop.runAfter([]() {}, 0);
+
+        bool reusedRun = false;
+        loop.runAfter(
+            [&]() {
+                // the slot of the fired timer is reused by this new one, the stale id must not cancel it.
+                TimerId reused = loop.runAfter([&]() { reusedRun = true; }, 5 * MS);
+                EXPECT_EQ(reused.index, fired.index);
+                EXPECT_NE(reused.generation, fired.generation);
+                loop.cancel(fired);
+                loop.runAfter([&]() { loop.stop(); }, 20 * MS);
+            },
+            5 * MS);
+        loop.start();
+
+        EXPECT_TRUE(reusedRun);
+    }
+}
+
+TEST(TimerManagerTest, ForeignThreadTest)
+{
+    WIND_TEST_BEGIN(TimerManagerTest, ForeignThreadTest);
+
+    for (auto type : TIMER_MANAGER_TYPES) {
+        EventLoopThread loopThread("TimerLoop", PollerType::EPOLL, type);
+        EventLoop *loop = loopThread.start();
+
+        // block the loop, adding and cancelling from this thread must not wait for it.
+        std::promise<void> blocker;
+        std::promise<void> entered;
+        auto blocked = blocker.get_future().share();
+        loop->queueToLoop([blocked, &entered]() {
+            entered.set_value();
+            blocked.wait();
+        });
+        // the timer ops are queued with a higher priority, they must not be applied before the loop is blocked.
+        entered.get_future().wait();
+
+        constexpr int TIMER_NUM = 1000;
+        std::atomic<int> fired = 0;
+        std::vector<TimerId> ids;
+        for (int i = 0; i < TIMER_NUM; ++i) {
+            ids.push_back(loop->runAfter([&fired]() { ++fired; }, (i % 10) * MS));
+        }
+        // cancelled before the adding is applied by the loop.
+        for (int i = 0; i < TIMER_NUM; i += 2) {
+            loop->cancel(ids[i]);
+        }
+
+        std::promise<void> done;
+        loop->runAfter([&done]() { done.set_value(); }, 50 * MS);
+        blocker.set_value();
+        done.get_future().wait();
+
+        EXPECT_EQ(fired.load(), TIMER_NUM / 2);
+    }
+}
+} // namespace base
+} // namespace wind
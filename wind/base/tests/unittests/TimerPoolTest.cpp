@@ -0,0 +1,95 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "TestHelper.h"
+#include "TimerPool.h"
+
+namespace wind {
+namespace base {
+TEST(TimerPoolTest, ReuseTest)
+{
+    WIND_TEST_BEGIN(TimerPoolTest, ReuseTest);
+
+    TimerPool pool;
+    int count = 0;
+    TimerId id = pool.create([&count]() { ++count; }, TimeStamp::now(), 0, 0);
+    ASSERT_NE(pool.get(id), nullptr);
+    pool.at(id.index).execute();
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(pool.capacity(), TimerPool::CHUNK_SIZE);
+
+    pool.release(id.index);
+    EXPECT_EQ(pool.get(id), nullptr);
+
+    TimerId reused = pool.create([]() {}, TimeStamp::now(), 0, 0);
+    EXPECT_EQ(reused.index, id.index);
+    EXPECT_NE(reused.generation, id.generation);
+    EXPECT_EQ(pool.get(id), nullptr);
+    EXPECT_NE(pool.get(reused), nullptr);
+    EXPECT_EQ(pool.get(TimerId()), nullptr);
+}
+
+TEST(TimerPoolTest, ConcurrentCreateTest)
+{
+    WIND_TEST_BEGIN(TimerPoolTest, ConcurrentCreateTest);
+
+    constexpr int THREAD_NUM = 4;
+    constexpr int TIMER_NUM = 3000; // every thread, more than a chunk.
+    TimerPool pool;
+    std::vector<std::vector<TimerId>> ids(THREAD_NUM);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREAD_NUM; ++i) {
+        threads.emplace_back([&pool, &ids, i]() {
+            for (int j = 0; j < TIMER_NUM; ++j) {
+                ids[i].push_back(pool.create([]() {}, TimeStamp::now(), 0, 0));
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    std::set<uint32_t> indexes;
+    for (auto &threadIds : ids) {
+        for (auto &id : threadIds) {
+            EXPECT_TRUE(indexes.insert(id.index).second);
+            EXPECT_NE(pool.get(id), nullptr);
+        }
+    }
+    EXPECT_EQ(indexes.size(), static_cast<size_t>(THREAD_NUM * TIMER_NUM));
+
+    // released slots are reused before growing again.
+    auto capacity = pool.capacity();
+    for (auto &id : ids[0]) {
+        pool.release(id.index);
+    }
+    for (int j = 0; j < TIMER_NUM; ++j) {
+        pool.create([]() {}, TimeStamp::now(), 0, 0);
+    }
+    EXPECT_EQ(pool.capacity(), capacity);
+}
+} // namespace base
+} // namespace wind
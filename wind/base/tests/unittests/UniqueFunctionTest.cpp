@@ -0,0 +1,132 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "TestHelper.h"
+#include "UniqueFunction.h"
+
+namespace wind {
+namespace base {
+TEST(UniqueFunctionTest, EmptyTest)
+{
+    WIND_TEST_BEGIN(UniqueFunctionTest, EmptyTest);
+
+    UniqueFunction<void()> f0;
+    EXPECT_FALSE(f0);
+    EXPECT_TRUE(f0 == nullptr);
+
+    UniqueFunction<void()> f1(nullptr);
+    EXPECT_FALSE(f1);
+
+    void (*nullFuncPtr)() = nullptr;
+    UniqueFunction<void()> f2(nullFuncPtr);
+    EXPECT_FALSE(f2);
+
+    std::function<void()> nullStdFunc;
+    UniqueFunction<void()> f3(nullStdFunc);
+    EXPECT_FALSE(f3);
+}
+
+TEST(UniqueFunctionTest, InvokeTest)
+{
+    WIND_TEST_BEGIN(UniqueFunctionTest, InvokeTest);
+
+    UniqueFunction<int(int, int)> add([](int a, int b) { return a + b; });
+    EXPECT_TRUE(add != nullptr);
+    EXPECT_EQ(add(1, 2), 3);
+
+    int counter = 0;
+    UniqueFunction<void()> incr([&counter]() { ++counter; });
+    incr();
+    incr();
+    EXPECT_EQ(counter, 2);
+
+    // mutable lambda keeps its state between calls.
+    UniqueFunction<int()> gen([n = 0]() mutable { return ++n; });
+    EXPECT_EQ(gen(), 1);
+    EXPECT_EQ(gen(), 2);
+
+    // captures bigger than the inline buffer are stored on heap.
+    std::string big(1024, 'x');
+    std::array<char, 2 * DEFAULT_FUNCTION_INLINE_SIZE> padding{};
+    UniqueFunction<size_t()> heap([big, padding]() { return big.size() + padding.size(); });
+    EXPECT_EQ(heap(), big.size() + padding.size());
+}
+
+TEST(UniqueFunctionTest, MoveOnlyTest)
+{
+    WIND_TEST_BEGIN(UniqueFunctionTest, MoveOnlyTest);
+
+    auto ptr = std::make_unique<int>(42);
+    UniqueFunction<int()> f0([p = std::move(ptr)]() { return *p; });
+    EXPECT_EQ(f0(), 42);
+
+    UniqueFunction<int()> f1(std::move(f0));
+    EXPECT_FALSE(f0);
+    EXPECT_EQ(f1(), 42);
+
+    UniqueFunction<int()> f2;
+    f2 = std::move(f1);
+    EXPECT_FALSE(f1);
+    EXPECT_EQ(f2(), 42);
+
+    std::packaged_task<int()> task([]() { return 7; });
+    auto future = task.get_future();
+    UniqueFunction<void()> f3([t = std::move(task)]() mutable { t(); });
+    f3();
+    EXPECT_EQ(future.get(), 7);
+}
+
+TEST(UniqueFunctionTest, LifetimeTest)
+{
+    WIND_TEST_BEGIN(UniqueFunctionTest, LifetimeTest);
+
+    auto inlineObj = std::make_shared<int>(0);
+    auto heapObj = std::make_shared<int>(0);
+    {
+        UniqueFunction<void()> f0([inlineObj]() {});
+        std::array<char, 2 * DEFAULT_FUNCTION_INLINE_SIZE> padding{};
+        UniqueFunction<void()> f1([heapObj, padding]() {});
+        EXPECT_EQ(inlineObj.use_count(), 2);
+        EXPECT_EQ(heapObj.use_count(), 2);
+
+        UniqueFunction<void()> f2(std::move(f0));
+        UniqueFunction<void()> f3(std::move(f1));
+        EXPECT_EQ(inlineObj.use_count(), 2);
+        EXPECT_EQ(heapObj.use_count(), 2);
+
+        f2.swap(f3);
+        EXPECT_EQ(inlineObj.use_count(), 2);
+        EXPECT_EQ(heapObj.use_count(), 2);
+
+        f2 = nullptr;
+        EXPECT_EQ(heapObj.use_count(), 1);
+    }
+    EXPECT_EQ(inlineObj.use_count(), 1);
+    EXPECT_EQ(heapObj.use_count(), 1);
+}
+} // namespace base
+} // namespace wind
@@ -0,0 +1,105 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "TestHelper.h"
+#include "WorkStealingDeque.h"
+
+namespace wind {
+namespace base {
+TEST(WorkStealingDequeTest, OwnerTest)
+{
+    WIND_TEST_BEGIN(WorkStealingDequeTest, OwnerTest);
+
+    WorkStealingDeque<int *> deque(2);
+    std::vector<int> values(100);
+    for (auto &value : values) {
+        deque.push(&value); // grows several times.
+    }
+    EXPECT_EQ(deque.size(), values.size());
+
+    // the owner pops LIFO, the thieves steal FIFO.
+    EXPECT_EQ(deque.steal(), &values.front());
+    for (size_t i = values.size() - 1; i > 0; --i) {
+        EXPECT_EQ(deque.pop(), &values[i]);
+    }
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST(WorkStealingDequeTest, StealTest)
+{
+    WIND_TEST_BEGIN(WorkStealingDequeTest, StealTest);
+
+    constexpr int ITEM_NUM = 200000;
+    constexpr int THIEF_NUM = 3;
+    std::vector<int> items(ITEM_NUM, 0);
+    std::vector<std::atomic<int>> taken(ITEM_NUM);
+    WorkStealingDeque<int *> deque;
+    std::atomic<bool> done = false;
+    std::atomic<int> takenCount = 0;
+
+    auto take = [&](int *item) {
+        taken[item - items.data()].fetch_add(1);
+        takenCount.fetch_add(1);
+    };
+
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < THIEF_NUM; ++i) {
+        thieves.emplace_back([&]() {
+            while (!done.load()) {
+                if (int *item = deque.steal()) {
+                    take(item);
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < ITEM_NUM; ++i) {
+        deque.push(&items[i]);
+        if (i % 3 == 0) {
+            if (int *item = deque.pop()) {
+                take(item);
+            }
+        }
+    }
+    while (int *item = deque.pop()) {
+        take(item);
+    }
+    while (takenCount.load() != ITEM_NUM) {
+        std::this_thread::yield();
+    }
+    done = true;
+    for (auto &t : thieves) {
+        t.join();
+    }
+
+    for (auto &count : taken) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+} // namespace base
+} // namespace wind
@@ -32,6 +32,7 @@ namespace conn {
 
 Acceptor::Acceptor(base::EventLoop *eventLoop, const SockAddrInet &listenAddr, bool reusePort, int type, int protocol)
     : loop_(eventLoop),
+      completionIo_(loop_->supportsCompletionIo()),
       acceptSocket_(sockets::createNonBlockSocketOrDie(listenAddr.family(), type, protocol)),
       acceptChannel_(std::make_shared<base::EventChannel>(acceptSocket_.fd(), loop_)),
       idleFd_(base::utils::createIdleFdOrDie()),
@@ -45,6 +46,7 @@ Acceptor::Acceptor(base::EventLoop *eventLoop, const SockAddrInet &listenAddr, b
 
 Acceptor::Acceptor(base::EventLoop *eventLoop, const SockAddrUnix &listenAddr, int type, int protocol)
     : loop_(eventLoop),
+      completionIo_(loop_->supportsCompletionIo()),
       acceptSocket_(sockets::createNonBlockSocketOrDie(listenAddr.family(), type, protocol)),
       acceptChannel_(std::make_shared<base::EventChannel>(acceptSocket_.fd(), loop_)),
       idleFd_(base::utils::createIdleFdOrDie()),
@@ -114,7 +116,11 @@ void Acceptor::listen()
 
     loop_->runInLoop([this]() {
         acceptSocket_.listenOrDie();
-        acceptChannel_->enableReading();
+        if (completionIo_) {
+            acceptChannel_->submitAccept();
+        } else {
+            acceptChannel_->enableReading();
+        }
     });
 }
 
@@ -126,7 +132,7 @@ void Acceptor::assertInLoopThread() const
 void Acceptor::acceptNewInetConn()
 {
     SockAddrInet remoteAddr;
-    base::UniqueFd remoteFd(acceptSocket_.accept(remoteAddr));
+    base::UniqueFd remoteFd(acceptConn(remoteAddr));
     if (!remoteFd.valid()) {
         LOG_ERROR << "Socket(fd:" << acceptSocket_.fd() << ") failed: " << strerror(errno) << ".";
         handleAcceptError();
@@ -140,7 +146,7 @@ void Acceptor::acceptNewInetConn()
 void Acceptor::acceptNewUnixConn()
 {
     SockAddrUnix remoteAddr;
-    base::UniqueFd remoteFd(acceptSocket_.accept(remoteAddr));
+    base::UniqueFd remoteFd(acceptConn(remoteAddr));
     if (!remoteFd.valid()) {
         LOG_ERROR << "Socket(fd:" << acceptSocket_.fd() << ") failed: " << strerror(errno) << ".";
         handleAcceptError();
@@ -179,6 +185,11 @@ void Acceptor::handleRead()
             LOG_ERROR << "Not supported acceptor type.";
             break;
     }
+
+    if (completionIo_) {
+        // one connection per accept request, submit the next one.
+        acceptChannel_->submitAccept();
+    }
 }
 } // namespace conn
 } // namespace wind
@@ -28,6 +28,8 @@
 namespace wind {
 namespace conn {
 // This Acceptor can support for both network and unix local ipc.
+// On a loop doing completion based io, the connections are accepted by accept requests submitted to the poller
+// instead of accept() on readiness.
 using AcceptCallbackInet = std::function<void(int, const SockAddrInet &)>;
 using AcceptCallbackUnix = std::function<void(int, const SockAddrUnix &)>;
 
@@ -60,9 +62,28 @@ private:
     void acceptNewUnixConn();
     void handleRead();
 
+    // success: return a valid fd and fill peerAddr, or take the ones of the completed accept request.
+    // failure: return -1 and set errno.
+    template <typename SockType>
+    int acceptConn(SockAddr<SockType> &peerAddr) const
+    {
+        if (!completionIo_) {
+            return acceptSocket_.accept(peerAddr);
+        }
+
+        int fd = acceptChannel_->readResult();
+        if (fd < 0) {
+            errno = -fd;
+            return -1;
+        }
+        ::memcpy(peerAddr.data(), acceptChannel_->readData(), peerAddr.capacity());
+        return fd;
+    }
+
     std::atomic<bool> listening_ = false;
 
     base::EventLoop *loop_ = nullptr;
+    bool completionIo_ = false;
     Socket acceptSocket_;
     std::shared_ptr<base::EventChannel> acceptChannel_;
 
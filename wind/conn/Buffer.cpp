@@ -61,8 +61,8 @@ void Buffer::makeMoreSpace(size_t len)
 {
     // make more space or move the data to the front inside this buffer.
     if ((len + PREPEND_SIZE) > (bytesWritable() + prependBytes())) {
-        // make more space.
-        std::vector<char> newBuf(writeIdx_ + len);
+        // make more space, grow geometrically to keep appending amortized O(1).
+        std::vector<char> newBuf(std::max(writeIdx_ + len, data_.size() * 2));
         std::move(data_.begin(), data_.end(), newBuf.begin());
         data_ = std::move(newBuf);
     } else {
@@ -106,6 +106,16 @@ int getSocketError(int sockFd)
     return err;
 }
 
+int getIncomingCpu(int sockFd)
+{
+    int cpu = -1;
+    auto cpuLen = static_cast<socklen_t>(sizeof(cpu));
+    if (::getsockopt(sockFd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &cpuLen) < 0) {
+        return -1;
+    }
+    return cpu;
+}
+
 bool isSelfConnectInet(int sockFd)
 {
     auto localAddr = getLocalAddrInet(sockFd);
@@ -44,6 +44,8 @@ SockAddrUnix getLocalAddrUnix(int sockFd);
 SockAddrUnix getPeerAddrUnix(int sockFd);
 
 int getSocketError(int sockFd);
+// the cpu which handled the received packets of the socket (SO_INCOMING_CPU), -1 if unknown.
+int getIncomingCpu(int sockFd);
 bool isSelfConnectInet(int sockFd);
 bool isSelfConnectUnix(int sockFd);
 } // namespace sockets
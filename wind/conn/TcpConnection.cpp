@@ -63,6 +63,7 @@ TcpConnection::TcpConnection(EventLoop *loop, std::string name, int sockFd)
     channel_->setErrorCallback([this]() { handleError(); });
     channel_->setCloseCallback([this]() { handleClose(); });
     socket_.setKeepAlive(true);
+    completionIo_ = loop_->supportsCompletionIo();
     setState(TcpConnectionState::CONNECTING);
 }
 
@@ -122,30 +123,49 @@ void TcpConnection::assertInLoopThread()
 
 void TcpConnection::onEstablished()
 {
-    loop_->runInLoop([this]() {
-        ASSERT(state() == TcpConnectionState::CONNECTING);
-        channel_->tie(shared_from_this());
-        channel_->enableReading(true);
-        setState(TcpConnectionState::CONNECTED);
-        callConnectionCallback();
-    });
+    loop_->runInLoop(
+        [this]() {
+            ASSERT(state() == TcpConnectionState::CONNECTING);
+            if (loopLocalBuffers_) {
+                sendBuffer_ = Buffer();
+                recvBuffer_ = Buffer();
+            }
+            channel_->tie(shared_from_this());
+            if (completionIo_) {
+                channel_->submitRead();
+            } else {
+                if (edgeTriggered_) {
+                    channel_->enableEdgeTriggered(false);
+                    channel_->setKeepWriteRegistered(keepWriteRegistered_);
+                }
+                channel_->enableReading(true);
+            }
+            setState(TcpConnectionState::CONNECTED);
+            callConnectionCallback();
+        },
+        FunctorPriority::HIGH);
 }
 
 void TcpConnection::onRemoved()
 {
-    loop_->runInLoop([this]() {
-        if (WIND_UNLIKELY(state() == TcpConnectionState::CONNECTED)) {
-            setState(TcpConnectionState::DISCONNECTED);
-            channel_->disableAll(true);
-
-            callConnectionCallback();
-        }
-    });
+    // hold the connection, it may be released by TcpServer before this functor is executed.
+    loop_->runInLoop(
+        [this, self(shared_from_this())]() {
+            if (WIND_UNLIKELY(state() == TcpConnectionState::CONNECTED)) {
+                setState(TcpConnectionState::DISCONNECTED);
+                channel_->disableAll(true);
+
+                callConnectionCallback();
+            }
+        },
+        FunctorPriority::HIGH);
 }
 
 void TcpConnection::send(std::string message)
 {
-    loop_->runInLoop([this, msg(std::move(message))]() mutable { sendInLoop(std::move(msg)); });
+    loop_->runInLoop(
+        [this, self(shared_from_this()), msg(std::move(message))]() mutable { sendInLoop(std::move(msg)); },
+        FunctorPriority::LOW);
 }
 
 void TcpConnection::sendInLoop(std::string &&message)
@@ -157,6 +177,14 @@ void TcpConnection::sendInLoop(std::string &&message)
         return;
     }
 
+    if (completionIo_) {
+        sendBuffer_.append(message.data(), message.size());
+        if (!writeSubmitted_) {
+            submitSend();
+        }
+        return;
+    }
+
     const char *msgData = message.data();
     size_t msgLen = message.size();
     ssize_t wroteBytes = 0;
@@ -188,6 +216,15 @@ void TcpConnection::handleRead(TimeStamp receivedTime)
 {
     assertInLoopThread();
 
+    if (completionIo_) {
+        handleReadCompletion(receivedTime);
+        return;
+    }
+    if (edgeTriggered_) {
+        handleReadEdgeTriggered(receivedTime);
+        return;
+    }
+
     int savedError = 0;
     auto n = recvBuffer_.handleSocketRead(socket_.fd(), savedError);
 
@@ -205,6 +242,15 @@ void TcpConnection::handleWrite()
 {
     assertInLoopThread();
 
+    if (completionIo_) {
+        handleWriteCompletion();
+        return;
+    }
+    if (edgeTriggered_) {
+        handleWriteEdgeTriggered();
+        return;
+    }
+
     if (WIND_UNLIKELY(!channel_->isWriting())) {
         LOG_ERROR << "TcpConnection::onChannelWritable: channel(fd: " << channel_->fd() << ") is not writable!";
         return;
@@ -222,7 +268,190 @@ void TcpConnection::handleWrite()
     }
 }
 
-void TcpConnection::handleError() {}
+void TcpConnection::handleReadEdgeTriggered(TimeStamp receivedTime)
+{
+    size_t readBytes = 0;
+    bool drained = false;
+    bool closed = false;
+    while (readBytes < ioBudget_) {
+        int savedError = 0;
+        auto n = recvBuffer_.handleSocketRead(socket_.fd(), savedError);
+        if (n > 0) {
+            readBytes += static_cast<size_t>(n);
+            continue;
+        }
+
+        if (n < 0 && savedError == EINTR) {
+            continue;
+        }
+        // n == 0 means peer closed, otherwise it is drained unless a real error occurred.
+        if (n == 0) {
+            closed = true;
+        } else if (savedError != EAGAIN && savedError != EWOULDBLOCK) {
+            LOG_WARN << "TcpConnection " << name_ << " read failed: " << strerror(savedError) << ".";
+            closed = true;
+        }
+        drained = true;
+        break;
+    }
+
+    if (readBytes > 0) {
+        callMessageCallback(receivedTime);
+    }
+
+    if (closed) {
+        if (connected()) {
+            handleClose();
+        }
+        return;
+    }
+
+    // no more edge will come for the data left in socket, continue after the other channels of this round.
+    if (!drained && !readContinuing_) {
+        readContinuing_ = true;
+        loop_->queueToLoop([this, self(shared_from_this())]() {
+            readContinuing_ = false;
+            if (connected()) {
+                handleRead(TimeStamp::now());
+            }
+        });
+    }
+}
+
+void TcpConnection::handleWriteEdgeTriggered()
+{
+    size_t wroteBytes = 0;
+    bool blocked = false;
+    while (sendBuffer_.bytesReadable() > 0 && wroteBytes < ioBudget_) {
+        size_t len = std::min(sendBuffer_.bytesReadable(), ioBudget_ - wroteBytes);
+        // EINTR is retried by the write itself.
+        ssize_t n = socket_.write(sendBuffer_.peek(), len);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            LOG_WARN << "TcpConnection " << name_ << " write failed: " << strerror(errno) << ".";
+            if (connected()) {
+                handleClose();
+            }
+            return;
+        }
+        if (n <= 0) {
+            // wait for the next writable edge.
+            blocked = true;
+            break;
+        }
+        sendBuffer_.resume(static_cast<size_t>(n));
+        wroteBytes += static_cast<size_t>(n);
+    }
+
+    if (sendBuffer_.bytesReadable() == 0) {
+        // write complete, can disable channel's write event.
+        if (channel_->isWriting()) {
+            channel_->disableWriting(true);
+        }
+        return;
+    }
+
+    if (!blocked && !writeContinuing_) {
+        writeContinuing_ = true;
+        loop_->queueToLoop([this, self(shared_from_this())]() {
+            writeContinuing_ = false;
+            if (connected()) {
+                handleWrite();
+            }
+        });
+    }
+}
+
+void TcpConnection::handleReadCompletion(TimeStamp receivedTime)
+{
+    int n = channel_->readResult();
+    // n == 0 means peer closed.
+    bool closed = n == 0 || (n < 0 && n != -EINTR && n != -EAGAIN);
+    if (n < 0 && closed) {
+        LOG_WARN << "TcpConnection " << name_ << " read failed: " << strerror(-n) << ".";
+    }
+
+    if (n > 0) {
+        // the data is in a buffer of the poller, which is reused after this round.
+        recvBuffer_.append(channel_->readData(), static_cast<size_t>(n));
+        // a full read means more data is queued in the socket, read it directly up to the budget instead of a
+        // request per buffer, a bulk stream costs few syscalls per byte anyway.
+        size_t readBytes = static_cast<size_t>(n);
+        while (readBytes >= COMPLETION_READ_SIZE && readBytes < ioBudget_) {
+            int savedError = 0;
+            auto len = recvBuffer_.handleSocketRead(socket_.fd(), savedError);
+            if (len > 0) {
+                readBytes += static_cast<size_t>(len);
+                continue;
+            }
+            if (len < 0 && savedError == EINTR) {
+                continue;
+            }
+            if (len == 0) {
+                closed = true;
+            } else if (savedError != EAGAIN && savedError != EWOULDBLOCK) {
+                LOG_WARN << "TcpConnection " << name_ << " read failed: " << strerror(savedError) << ".";
+                closed = true;
+            }
+            break;
+        }
+        callMessageCallback(receivedTime);
+    }
+
+    if (closed) {
+        if (connected()) {
+            handleClose();
+        }
+        return;
+    }
+
+    // the message callback may have closed the connection.
+    if (connected()) {
+        channel_->submitRead();
+    }
+}
+
+void TcpConnection::handleWriteCompletion()
+{
+    writeSubmitted_ = false;
+    int n = channel_->writeResult();
+    if (n < 0 && n != -EINTR && n != -EAGAIN) {
+        LOG_WARN << "TcpConnection " << name_ << " write failed: " << strerror(-n) << ".";
+        if (connected()) {
+            handleClose();
+        }
+        return;
+    }
+
+    if (n > 0) {
+        sendingBuffer_.resume(static_cast<size_t>(n));
+    }
+    if (connected() && (sendingBuffer_.bytesReadable() > 0 || sendBuffer_.bytesReadable() > 0)) {
+        submitSend();
+    }
+}
+
+void TcpConnection::submitSend()
+{
+    ASSERT(!writeSubmitted_);
+    // the rest of a partial write goes first.
+    if (sendingBuffer_.bytesReadable() == 0) {
+        sendingBuffer_.swap(sendBuffer_);
+    }
+    writeSubmitted_ = true;
+    channel_->submitWrite(sendingBuffer_.peek(), sendingBuffer_.bytesReadable());
+}
+
+void TcpConnection::handleError()
+{
+    assertInLoopThread();
+
+    // the error callback preempts the read and write callbacks, e.g. a reset connection, so close it here.
+    int err = sockets::getSocketError(socket_.fd());
+    LOG_WARN << "TcpConnection " << name_ << " socket error: " << strerror(err) << ".";
+    if (connected()) {
+        handleClose();
+    }
+}
 
 void TcpConnection::handleClose()
 {
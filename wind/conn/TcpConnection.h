@@ -39,6 +39,11 @@ enum class TcpConnectionState {
     DISCONNECTED,
 };
 
+// Max bytes read or written by an edge triggered connection in one loop iteration.
+constexpr size_t DEFAULT_EDGE_TRIGGERED_BUDGET = 256 * 1024;
+
+// On a loop doing completion based io(see EventLoop::supportsCompletionIo()), a connection keeps a read request
+// in flight, and writes the send buffer by write requests, so neither waits for the readiness of the socket.
 class TcpConnection : private base::NonCopyable, public std::enable_shared_from_this<TcpConnection> {
 public:
     TcpConnection(base::EventLoop *loop, std::string name, int sockFd);
@@ -94,6 +99,33 @@ public:
         closeCallback_ = std::move(callback);
     }
 
+    // Should be called before onEstablished(), not thread safe.
+    // An edge triggered connection reads and writes until EAGAIN, but stops once budget bytes are done each way
+    // in a wakeup, the rest is continued by a queued functor so that a busy peer can not starve the loop.
+    // @keepWriteRegistered: keep EPOLLOUT registered, so that toggling the write interest costs no syscall.
+    // Ignored on a loop doing completion based io, which polls no readiness.
+    void setEdgeTriggered(
+        bool edgeTriggered,
+        size_t budget = DEFAULT_EDGE_TRIGGERED_BUDGET,
+        bool keepWriteRegistered = false)
+    {
+        edgeTriggered_ = edgeTriggered;
+        ioBudget_ = budget == 0 ? DEFAULT_EDGE_TRIGGERED_BUDGET : budget;
+        keepWriteRegistered_ = keepWriteRegistered;
+    }
+    bool isEdgeTriggered() const
+    {
+        return edgeTriggered_;
+    }
+
+    // Should be called before onEstablished(), not thread safe.
+    // Re-create the buffers in the io loop when established, instead of using the ones allocated by the
+    // accepting thread, so that they are on the NUMA node of a pinned io loop.
+    void setLoopLocalBuffers(bool on)
+    {
+        loopLocalBuffers_ = on;
+    }
+
     // called by TcpServer when accepting a new connection.
     // enable this connection's read channel and set it's state to connected.
     void onEstablished();
@@ -134,6 +166,12 @@ private:
 
     void handleRead(base::TimeStamp receivedTime);
     void handleWrite();
+    void handleReadEdgeTriggered(base::TimeStamp receivedTime);
+    void handleWriteEdgeTriggered();
+    void handleReadCompletion(base::TimeStamp receivedTime);
+    void handleWriteCompletion();
+    // submit a write request of the data not written yet.
+    void submitSend();
     void handleError();
     void handleClose();
 
@@ -155,6 +193,17 @@ private:
 
     Buffer sendBuffer_;
     Buffer recvBuffer_;
+    // the data of the write request in flight, the messages sent meanwhile are queued in sendBuffer_.
+    Buffer sendingBuffer_;
+
+    bool edgeTriggered_ = false;
+    size_t ioBudget_ = DEFAULT_EDGE_TRIGGERED_BUDGET;
+    bool keepWriteRegistered_ = false;
+    bool loopLocalBuffers_ = false;
+    bool readContinuing_ = false;  // a functor is queued to continue reading.
+    bool writeContinuing_ = false; // a functor is queued to continue writing.
+    bool completionIo_ = false;
+    bool writeSubmitted_ = false; // a write request is in flight.
 };
 
 using TcpConnectionPtr = std::shared_ptr<TcpConnection>;
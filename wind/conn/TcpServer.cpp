@@ -36,7 +36,18 @@ TcpServer::TcpServer(base::EventLoop *loop, const SockAddrInet &listenAddr, std:
         [this](int peerFd, const SockAddrInet &peerAddr) { onNewConnection(peerFd, peerAddr); });
 }
 
-TcpServer::~TcpServer() noexcept {}
+TcpServer::~TcpServer() noexcept
+{
+    // a connection may outlive the server, e.g. held by its write request in flight, so close it here.
+    for (auto &[name, conn] : conns_) {
+        UNUSED(name);
+        conn->onRemoved();
+    }
+    // stop the io loops, so that no connection can call back to the server from them any more,
+    // the removals they have queued to the main loop are dropped by the expired aliveToken_.
+    threadPool_.reset();
+    aliveToken_.reset();
+}
 
 void TcpServer::setConnectionCallback(TcpConnectionCallback callback)
 {
@@ -71,6 +82,74 @@ void TcpServer::setThreadNum(size_t threadNum)
     threadPool_->setThreadNum(threadNum);
 }
 
+void TcpServer::setPollerType(base::PollerType pollerType)
+{
+    if (running_) {
+        LOG_INFO << "TcpServer::setPollerType: server already started.";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    threadPool_->setPollerType(pollerType);
+}
+
+void TcpServer::setTimerManagerType(base::TimerManagerType timerManagerType)
+{
+    if (running_) {
+        LOG_INFO << "TcpServer::setTimerManagerType: server already started.";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    threadPool_->setTimerManagerType(timerManagerType);
+}
+
+void TcpServer::setAffinity(base::AffinityPolicy policy, std::vector<int> coreList)
+{
+    if (running_) {
+        LOG_INFO << "TcpServer::setAffinity: server already started.";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    threadPool_->setAffinity(policy, std::move(coreList));
+}
+
+void TcpServer::setNicLocalDispatch(bool on)
+{
+    if (running_) {
+        LOG_INFO << "TcpServer::setNicLocalDispatch: server already started.";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    nicLocalDispatch_ = on;
+}
+
+void TcpServer::setWatchdog(TimeType threshold, bool backtraceEnabled)
+{
+    if (running_) {
+        LOG_INFO << "TcpServer::setWatchdog: server already started.";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    threadPool_->setWatchdog(threshold, backtraceEnabled);
+}
+
+void TcpServer::setEdgeTriggered(bool edgeTriggered, size_t budget, bool keepWriteRegistered)
+{
+    if (running_) {
+        LOG_INFO << "TcpServer::setEdgeTriggered: server already started.";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    edgeTriggered_ = edgeTriggered;
+    edgeTriggeredBudget_ = budget;
+    keepWriteRegistered_ = keepWriteRegistered;
+}
+
 void TcpServer::start()
 {
     if (running_) {
@@ -93,7 +172,13 @@ void TcpServer::onNewConnection(int peerFd, const SockAddrInet &peerAddr)
 {
     assertInMainLoopThread();
 
-    EventLoop *ioLoop = threadPool_->getNextLoop();
+    EventLoop *ioLoop = nullptr;
+    if (nicLocalDispatch_) {
+        int node = base::CpuTopology::system().nodeOfCpu(sockets::getIncomingCpu(peerFd));
+        ioLoop = threadPool_->getNextLoop(node);
+    } else {
+        ioLoop = threadPool_->getNextLoop();
+    }
     std::string connName = name_ + "-" + peerAddr.toString() + "-" + std::to_string(nextConnId_++);
     auto newConn = std::make_shared<TcpConnection>(ioLoop, connName, peerFd);
     LOG_INFO << "New connection in: " << newConn->name() << ", localAddr: " << newConn->getLocalAddr().toString()
@@ -102,6 +187,8 @@ void TcpServer::onNewConnection(int peerFd, const SockAddrInet &peerAddr)
     newConn->setConnectionCallback(connectionCallback_);
     newConn->setMessageCallback(messageCallback_);
     newConn->setCloseCallback([this](const TcpConnectionPtr &conn) { onRemoveConnection(conn); });
+    newConn->setEdgeTriggered(edgeTriggered_, edgeTriggeredBudget_, keepWriteRegistered_);
+    newConn->setLoopLocalBuffers(threadPool_->affinityPolicy() != base::AffinityPolicy::NONE);
     newConn->onEstablished();
 
     conns_[connName] = newConn;
@@ -109,14 +196,16 @@ void TcpServer::onNewConnection(int peerFd, const SockAddrInet &peerAddr)
 
 void TcpServer::onRemoveConnection(const TcpConnectionPtr &conn)
 {
-    mainLoop_->runInLoop([this, conn]() {
-        if (WIND_UNLIKELY(conn == nullptr)) {
-            return;
-        }
-        auto n = conns_.erase(conn->name());
-        ASSERT(n == 1);
-        conn->onRemoved();
-    });
+    mainLoop_->runInLoop(
+        [this, conn, alive(std::weak_ptr<void>(aliveToken_))]() {
+            if (WIND_UNLIKELY(conn == nullptr || alive.expired())) {
+                return;
+            }
+            auto n = conns_.erase(conn->name());
+            ASSERT(n == 1);
+            conn->onRemoved();
+        },
+        base::FunctorPriority::HIGH);
 }
 } // namespace conn
 } // namespace wind
@@ -52,6 +52,29 @@ public:
     void setMessageCallback(TcpMessageCallback callback);
     // Should be called before calling start(), thread safe.
     void setThreadNum(size_t threadNum);
+    // Poller type of the io loops, should be called before calling start(), thread safe.
+    // With io_uring the connections do completion based io if the kernel supports it, see TcpConnection.
+    void setPollerType(base::PollerType pollerType);
+    // Timer manager type of the io loops, should be called before calling start(), thread safe.
+    void setTimerManagerType(base::TimerManagerType timerManagerType);
+    // Placement of the io loops, see EventLoopThreadPool::setAffinity().
+    // When pinned, the buffers of the connections are allocated by their io loops, on the local NUMA node.
+    // Should be called before calling start(), thread safe.
+    void setAffinity(base::AffinityPolicy policy, std::vector<int> coreList = {});
+    // Dispatch a new connection to an io loop on the NUMA node of the cpu which received its packets, that is
+    // the node of the NIC queue with RSS, only works with the pinned io loops.
+    // Should be called before calling start(), thread safe.
+    void setNicLocalDispatch(bool on);
+    // Report the callbacks, such as message callbacks, blocking the main loop or an io loop for more than
+    // threshold micro seconds, see EventLoopThreadPool::setWatchdog().
+    // Should be called before calling start(), thread safe.
+    void setWatchdog(TimeType threshold, bool backtraceEnabled = false);
+    // Whether the new connections are edge triggered, see TcpConnection::setEdgeTriggered().
+    // Should be called before calling start(), thread safe.
+    void setEdgeTriggered(
+        bool edgeTriggered,
+        size_t budget = DEFAULT_EDGE_TRIGGERED_BUDGET,
+        bool keepWriteRegistered = false);
 
     void start();
 
@@ -67,7 +90,13 @@ private:
     std::unique_ptr<base::EventLoopThreadPool> threadPool_;
     std::unique_ptr<Acceptor> acceptor_;
     std::atomic<uint64_t> nextConnId_ = 0;
+    bool edgeTriggered_ = false;
+    size_t edgeTriggeredBudget_ = DEFAULT_EDGE_TRIGGERED_BUDGET;
+    bool keepWriteRegistered_ = false;
+    bool nicLocalDispatch_ = false;
     ConnectionMap conns_;
+    // expired once the server is destroyed, checked by the removals queued to the main loop.
+    std::shared_ptr<void> aliveToken_ = std::make_shared<bool>(true);
 
     TcpConnectionCallback connectionCallback_;
     TcpMessageCallback messageCallback_;
@@ -0,0 +1,249 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <arpa/inet.h>
+#include <dlfcn.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <thread>
+
+#include "base/EventLoopThread.h"
+#include "TcpServer.h"
+
+using namespace wind;
+using namespace wind::base;
+using namespace wind::conn;
+
+// Ping-pong small messages over many connections through a TcpServer, and count the syscalls the server's loop
+// thread made per request, with epoll and with io_uring doing completion based io.
+// The syscalls are counted by interposing the libc wrappers the loop calls, only in the loop thread.
+constexpr int CONNECTIONS = 64;
+constexpr int ROUNDS = 2000;
+constexpr size_t MESSAGE_SIZE = 64;
+constexpr uint16_t PORT_BASE = 45950;
+
+namespace {
+thread_local bool t_counting = false;
+std::atomic<uint64_t> g_syscalls = 0;
+
+void countSyscall()
+{
+    if (t_counting) {
+        g_syscalls.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template <typename Func>
+Func realFunc(const char *name)
+{
+    return reinterpret_cast<Func>(::dlsym(RTLD_NEXT, name));
+}
+} // namespace
+
+extern "C" {
+ssize_t read(int fd, void *buf, size_t count)
+{
+    static auto realRead = realFunc<ssize_t (*)(int, void *, size_t)>("read");
+    countSyscall();
+    return realRead(fd, buf, count);
+}
+
+ssize_t write(int fd, const void *buf, size_t count)
+{
+    static auto realWrite = realFunc<ssize_t (*)(int, const void *, size_t)>("write");
+    countSyscall();
+    return realWrite(fd, buf, count);
+}
+
+ssize_t readv(int fd, const iovec *iov, int iovCnt)
+{
+    static auto realReadv = realFunc<ssize_t (*)(int, const iovec *, int)>("readv");
+    countSyscall();
+    return realReadv(fd, iov, iovCnt);
+}
+
+ssize_t writev(int fd, const iovec *iov, int iovCnt)
+{
+    static auto realWritev = realFunc<ssize_t (*)(int, const iovec *, int)>("writev");
+    countSyscall();
+    return realWritev(fd, iov, iovCnt);
+}
+
+int accept4(int fd, sockaddr *addr, socklen_t *addrLen, int flags)
+{
+    static auto realAccept4 = realFunc<int (*)(int, sockaddr *, socklen_t *, int)>("accept4");
+    countSyscall();
+    return realAccept4(fd, addr, addrLen, flags);
+}
+
+int epoll_wait(int epollFd, epoll_event *events, int maxEvents, int timeOutMs)
+{
+    static auto realEpollWait = realFunc<int (*)(int, epoll_event *, int, int)>("epoll_wait");
+    countSyscall();
+    return realEpollWait(epollFd, events, maxEvents, timeOutMs);
+}
+
+int epoll_ctl(int epollFd, int operation, int fd, epoll_event *event) noexcept
+{
+    static auto realEpollCtl = realFunc<int (*)(int, int, int, epoll_event *)>("epoll_ctl");
+    countSyscall();
+    return realEpollCtl(epollFd, operation, fd, event);
+}
+
+int timerfd_settime(int fd, int flags, const itimerspec *newValue, itimerspec *oldValue) noexcept
+{
+    static auto realTimerFdSetTime = realFunc<int (*)(int, int, const itimerspec *, itimerspec *)>("timerfd_settime");
+    countSyscall();
+    return realTimerFdSetTime(fd, flags, newValue, oldValue);
+}
+
+// io_uring_enter() is called by syscall().
+long syscall(long number, ...) noexcept
+{
+    static auto realSyscall = realFunc<long (*)(long, ...)>("syscall");
+    long args[6];
+    va_list vaList;
+    va_start(vaList, number);
+    for (auto &arg : args) {
+        arg = va_arg(vaList, long);
+    }
+    va_end(vaList);
+    countSyscall();
+    return realSyscall(number, args[0], args[1], args[2], args[3], args[4], args[5]);
+}
+}
+
+int connectTo(uint16_t port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < 100; ++i) {
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+            return fd;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ::close(fd);
+    return -1;
+}
+
+bool readFully(int fd, char *buf, size_t len)
+{
+    while (len > 0) {
+        auto n = ::recv(fd, buf, len, 0);
+        if (n <= 0) {
+            return false;
+        }
+        buf += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool benchPingPong(PollerType pollerType, uint16_t port)
+{
+    std::atomic<int> connected = 0;
+    EventLoopThread loopThread("EchoLoop", pollerType);
+    EventLoop *loop = loopThread.start();
+    std::unique_ptr<TcpServer> server;
+    loop->schedule([&]() {
+            server = std::make_unique<TcpServer>(loop, SockAddrInet(port), "EchoServer");
+            server->setConnectionCallback([&connected](const TcpConnectionPtr &conn) {
+                if (conn->connected()) {
+                    connected.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+            server->setMessageCallback([](const TcpConnectionPtr &conn, TimeStamp) {
+                conn->send(conn->recvBuffer()->readAll());
+            });
+            server->start();
+        })
+        .wait();
+
+    std::vector<int> fds;
+    for (int i = 0; i < CONNECTIONS; ++i) {
+        int fd = connectTo(port);
+        if (fd < 0) {
+            ::printf("connect to port %u failed.\n", port);
+            return false;
+        }
+        fds.push_back(fd);
+    }
+    while (connected.load(std::memory_order_relaxed) < CONNECTIONS) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // the connections are set up, count the syscalls of serving the requests only.
+    g_syscalls = 0;
+    loop->schedule([]() { t_counting = true; }).wait();
+
+    bool ok = true;
+    std::string message(MESSAGE_SIZE, 'p');
+    std::vector<char> buf(MESSAGE_SIZE);
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS && ok; ++round) {
+        for (int fd : fds) {
+            ok = ::send(fd, message.data(), message.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(message.size()) && ok;
+        }
+        for (int fd : fds) {
+            ok = readFully(fd, buf.data(), buf.size()) && ok;
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    loop->schedule([]() { t_counting = false; }).wait();
+    uint64_t syscalls = g_syscalls.load();
+    for (int fd : fds) {
+        ::close(fd);
+    }
+    loop->schedule([&server]() { server.reset(); }).wait();
+
+    constexpr double REQUESTS = static_cast<double>(CONNECTIONS) * ROUNDS;
+    ::printf(
+        "PingPong(%-8s, completion io: %-3s): %9.0f requests/s, %9" PRIu64 " syscalls, %6.3f syscalls/request\n",
+        pollerType == PollerType::IO_URING ? "io_uring" : "epoll",
+        loop->supportsCompletionIo() ? "yes" : "no",
+        REQUESTS / elapsed,
+        syscalls,
+        static_cast<double>(syscalls) / REQUESTS);
+    return ok;
+}
+
+int main()
+{
+    bool ok = true;
+    uint16_t port = PORT_BASE;
+    for (auto pollerType : {PollerType::EPOLL, PollerType::IO_URING}) {
+        ok = benchPingPong(pollerType, port++) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "base/EventLoopThread.h"
+#include "TcpServer.h"
+
+using namespace wind;
+using namespace wind::base;
+using namespace wind::conn;
+
+// Echo a bulk stream through TcpServer with level triggered and edge triggered connections
+// (optionally keeping EPOLLOUT registered), and count how many message callbacks (read wakeups) the server needed.
+constexpr size_t TOTAL_BYTES = 256 * 1024 * 1024;
+constexpr size_t CHUNK_SIZE = 64 * 1024;
+// the client stops writing when this many bytes are not echoed back yet, to keep the server's buffers bounded.
+constexpr size_t MAX_IN_FLIGHT_BYTES = 4 * 1024 * 1024;
+constexpr uint16_t PORT_BASE = 45900;
+
+int connectTo(uint16_t port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < 100; ++i) {
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+            return fd;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ::close(fd);
+    return -1;
+}
+
+enum class TriggerMode {
+    LEVEL,
+    EDGE,
+    EDGE_KEEP_WRITE,
+};
+
+const char *triggerModeName(TriggerMode mode)
+{
+    switch (mode) {
+        case TriggerMode::LEVEL:
+            return "level triggered";
+        case TriggerMode::EDGE:
+            return "edge triggered";
+        case TriggerMode::EDGE_KEEP_WRITE:
+            return "edge triggered, keep EPOLLOUT";
+        default:
+            return "unknown";
+    }
+}
+
+bool benchEcho(TriggerMode mode, PollerType pollerType, uint16_t port)
+{
+    std::atomic<uint64_t> messageCallbacks = 0;
+    EventLoopThread loopThread("EchoLoop", pollerType);
+    EventLoop *loop = loopThread.start();
+    std::unique_ptr<TcpServer> server;
+    loop->schedule([&]() {
+            server = std::make_unique<TcpServer>(loop, SockAddrInet(port), "EchoServer");
+            server->setEdgeTriggered(
+                mode != TriggerMode::LEVEL,
+                DEFAULT_EDGE_TRIGGERED_BUDGET,
+                mode == TriggerMode::EDGE_KEEP_WRITE);
+            server->setMessageCallback([&messageCallbacks](const TcpConnectionPtr &conn, TimeStamp) {
+                messageCallbacks.fetch_add(1, std::memory_order_relaxed);
+                conn->send(conn->recvBuffer()->readAll());
+            });
+            server->start();
+        })
+        .wait();
+
+    int fd = connectTo(port);
+    if (fd < 0) {
+        ::printf("connect to port %u failed.\n", port);
+        return false;
+    }
+
+    std::atomic<size_t> received = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread writer([fd, &received]() {
+        std::string chunk(CHUNK_SIZE, 'w');
+        size_t sent = 0;
+        while (sent < TOTAL_BYTES) {
+            if (sent - received.load(std::memory_order_relaxed) > MAX_IN_FLIGHT_BYTES) {
+                std::this_thread::yield();
+                continue;
+            }
+            auto n = ::write(fd, chunk.data(), std::min(CHUNK_SIZE, TOTAL_BYTES - sent));
+            if (n <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+    });
+
+    std::vector<char> buf(CHUNK_SIZE);
+    while (received.load(std::memory_order_relaxed) < TOTAL_BYTES) {
+        auto n = ::read(fd, buf.data(), buf.size());
+        if (n <= 0) {
+            break;
+        }
+        received.fetch_add(static_cast<size_t>(n), std::memory_order_relaxed);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    writer.join();
+    ::close(fd);
+
+    loop->schedule([&server]() { server.reset(); }).wait();
+    ::printf(
+        "Echo(%-8s, %-29s): %7.1f MB/s, %8" PRIu64 " message callbacks, %6.1f KB/callback\n",
+        pollerType == PollerType::IO_URING ? "io_uring" : "epoll",
+        triggerModeName(mode),
+        static_cast<double>(received.load()) / elapsed / (1024 * 1024),
+        messageCallbacks.load(),
+        static_cast<double>(received.load()) / 1024 / static_cast<double>(std::max<uint64_t>(messageCallbacks.load(), 1)));
+    return received.load() == TOTAL_BYTES;
+}
+
+int main()
+{
+    bool ok = true;
+    uint16_t port = PORT_BASE;
+    for (auto pollerType : {PollerType::EPOLL, PollerType::IO_URING}) {
+        for (auto mode : {TriggerMode::LEVEL, TriggerMode::EDGE, TriggerMode::EDGE_KEEP_WRITE}) {
+            ok = benchEcho(mode, pollerType, port++) && ok;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,215 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#define LOG_TAG "CompletionIoTest"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <future>
+#include <thread>
+
+#include "base/EventLoopThread.h"
+#include "TcpServer.h"
+
+using namespace wind;
+using namespace wind::base;
+using namespace wind::conn;
+
+// Run TcpServer on io_uring doing completion based io: echo a bulk stream which takes many partial writes,
+// close or reset the peer, and destroy the server and its loop while a write request is still in flight.
+constexpr size_t ECHO_SIZE = 4 * 1024 * 1024;
+constexpr size_t PENDING_SEND_SIZE = 8 * 1024 * 1024;
+constexpr auto CLOSE_TIMEOUT = std::chrono::seconds(3);
+constexpr uint16_t PORT_BASE = 45850;
+
+enum class IoCase {
+    BULK_ECHO,
+    PEER_CLOSED,
+    PEER_RESET_SENDING,
+    SERVER_DESTROYED_SENDING,
+};
+
+const char *ioCaseName(IoCase ioCase)
+{
+    switch (ioCase) {
+        case IoCase::BULK_ECHO:
+            return "bulk echo";
+        case IoCase::PEER_CLOSED:
+            return "peer closed";
+        case IoCase::PEER_RESET_SENDING:
+            return "peer reset while sending";
+        case IoCase::SERVER_DESTROYED_SENDING:
+            return "server destroyed while sending";
+        default:
+            return "unknown";
+    }
+}
+
+int connectTo(uint16_t port)
+{
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < 100; ++i) {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+            return fd;
+        }
+        ::close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return -1;
+}
+
+// close with a zero linger timeout, which sends RST instead of FIN.
+void resetSocket(int fd)
+{
+    linger lingerOpt{};
+    lingerOpt.l_onoff = 1;
+    lingerOpt.l_linger = 0;
+    (void)::setsockopt(fd, SOL_SOCKET, SO_LINGER, &lingerOpt, sizeof(lingerOpt));
+    ::close(fd);
+}
+
+bool echoBulk(int fd)
+{
+    std::string data(ECHO_SIZE, '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>('a' + i % 26);
+    }
+
+    std::thread writer([fd, &data]() {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            auto n = ::write(fd, data.data() + sent, data.size() - sent);
+            if (n <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+    });
+
+    std::string received;
+    std::vector<char> buf(64 * 1024);
+    while (received.size() < data.size()) {
+        auto n = ::read(fd, buf.data(), buf.size());
+        if (n <= 0) {
+            break;
+        }
+        received.append(buf.data(), static_cast<size_t>(n));
+    }
+    writer.join();
+    return received == data;
+}
+
+bool testIo(IoCase ioCase, uint16_t port)
+{
+    std::promise<void> serverReady; // the server has queued the data to send.
+    std::promise<void> serverClosed;
+    EventLoopThread loopThread("CompletionLoop", PollerType::IO_URING);
+    EventLoop *loop = loopThread.start();
+    if (!loop->supportsCompletionIo()) {
+        ::printf("%s: skipped, completion based io is not supported.\n", ioCaseName(ioCase));
+        return true;
+    }
+
+    std::unique_ptr<TcpServer> server;
+    loop->schedule([&]() {
+            server = std::make_unique<TcpServer>(loop, SockAddrInet(port), "CompletionServer");
+            server->setConnectionCallback([&, ioCase](const TcpConnectionPtr &conn) {
+                if (!conn->connected()) {
+                    serverClosed.set_value();
+                } else if (ioCase == IoCase::PEER_RESET_SENDING || ioCase == IoCase::SERVER_DESTROYED_SENDING) {
+                    // the peer never reads, so the write request stays in flight.
+                    conn->send(std::string(PENDING_SEND_SIZE, 's'));
+                    serverReady.set_value();
+                }
+            });
+            server->setMessageCallback([](const TcpConnectionPtr &conn, TimeStamp) {
+                conn->send(conn->recvBuffer()->readAll());
+            });
+            server->start();
+        })
+        .wait();
+
+    int fd = connectTo(port);
+    if (fd < 0) {
+        ::printf("connect to port %u failed.\n", port);
+        loop->schedule([&server]() { server.reset(); }).wait();
+        return false;
+    }
+
+    bool ok = true;
+    switch (ioCase) {
+        case IoCase::BULK_ECHO:
+            ok = echoBulk(fd);
+            ::close(fd);
+            ok = serverClosed.get_future().wait_for(CLOSE_TIMEOUT) == std::future_status::ready && ok;
+            break;
+        case IoCase::PEER_CLOSED:
+            ::close(fd);
+            ok = serverClosed.get_future().wait_for(CLOSE_TIMEOUT) == std::future_status::ready;
+            break;
+        case IoCase::PEER_RESET_SENDING:
+            serverReady.get_future().wait();
+            resetSocket(fd);
+            ok = serverClosed.get_future().wait_for(CLOSE_TIMEOUT) == std::future_status::ready;
+            break;
+        case IoCase::SERVER_DESTROYED_SENDING: {
+            serverReady.get_future().wait();
+            // the write request in flight keeps the connection alive, until it is cancelled.
+            loop->schedule([&server]() { server.reset(); }).wait();
+            ok = serverClosed.get_future().wait_for(CLOSE_TIMEOUT) == std::future_status::ready;
+            // the peer sees the end after the data sent.
+            std::vector<char> buf(64 * 1024);
+            while (ok && ::read(fd, buf.data(), buf.size()) > 0) {}
+            ::close(fd);
+            break;
+        }
+        default:
+            break;
+    }
+
+    loop->schedule([&server]() { server.reset(); }).wait();
+    ::printf("%s: %s\n", ioCaseName(ioCase), ok ? "passed" : "FAILED");
+    return ok;
+}
+
+int main()
+{
+    // a write to a reset connection raises SIGPIPE.
+    (void)::signal(SIGPIPE, SIG_IGN);
+
+    bool ok = true;
+    uint16_t port = PORT_BASE;
+    for (auto ioCase :
+         {IoCase::BULK_ECHO, IoCase::PEER_CLOSED, IoCase::PEER_RESET_SENDING, IoCase::SERVER_DESTROYED_SENDING}) {
+        ok = testIo(ioCase, port++) && ok;
+    }
+    return ok ? 0 : 1;
+}
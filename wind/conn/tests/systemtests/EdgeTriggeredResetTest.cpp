@@ -0,0 +1,155 @@
+// MIT License
+
+// Copyright (c) 2020 Tracy
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#define LOG_TAG "EdgeTriggeredResetTest"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <future>
+#include <thread>
+
+#include "base/EventLoopThread.h"
+#include "TcpServer.h"
+
+using namespace wind;
+using namespace wind::base;
+using namespace wind::conn;
+
+// Reset the peer of an edge triggered connection while the server is reading from it or sending to it,
+// the server should see ECONNRESET (or EPIPE) and close the connection instead of keeping it forever.
+constexpr size_t BUDGET = 4 * 1024;
+constexpr size_t DATA_SIZE = 64 * 1024;
+constexpr auto CLOSE_TIMEOUT = std::chrono::seconds(3);
+constexpr uint16_t PORT_BASE = 45800;
+
+enum class ResetCase {
+    READING,
+    SENDING,
+};
+
+int connectTo(uint16_t port)
+{
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < 100; ++i) {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+            return fd;
+        }
+        ::close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return -1;
+}
+
+// close with a zero linger timeout, which sends RST instead of FIN.
+void resetSocket(int fd)
+{
+    linger lingerOpt{};
+    lingerOpt.l_onoff = 1;
+    lingerOpt.l_linger = 0;
+    (void)::setsockopt(fd, SOL_SOCKET, SO_LINGER, &lingerOpt, sizeof(lingerOpt));
+    ::close(fd);
+}
+
+bool testReset(ResetCase resetCase, uint16_t port)
+{
+    const char *caseName = resetCase == ResetCase::READING ? "reading" : "sending";
+    std::promise<void> serverReady; // the server has read a budget of data or queued the data to send.
+    std::promise<void> peerReset;
+    std::promise<void> serverClosed;
+    std::shared_future<void> peerResetFuture = peerReset.get_future().share();
+
+    EventLoopThread loopThread("ResetLoop");
+    EventLoop *loop = loopThread.start();
+    std::unique_ptr<TcpServer> server;
+    loop->schedule([&]() {
+            server = std::make_unique<TcpServer>(loop, SockAddrInet(port), "ResetServer");
+            server->setEdgeTriggered(true, BUDGET);
+            server->setConnectionCallback([&, resetCase](const TcpConnectionPtr &conn) {
+                if (!conn->connected()) {
+                    serverClosed.set_value();
+                } else if (resetCase == ResetCase::SENDING) {
+                    // the peer never reads, so most of the data is left in the send buffer.
+                    conn->send(std::string(DATA_SIZE, 's'));
+                    serverReady.set_value();
+                }
+            });
+            server->setMessageCallback([&, resetCase](const TcpConnectionPtr &conn, TimeStamp) {
+                conn->recvBuffer()->resumeAll();
+                if (resetCase == ResetCase::READING && peerResetFuture.wait_for(std::chrono::seconds(0)) !=
+                        std::future_status::ready) {
+                    // hold the loop until the peer is reset, the data left beyond the budget is read after it.
+                    serverReady.set_value();
+                    peerResetFuture.wait();
+                }
+            });
+            server->start();
+        })
+        .wait();
+
+    // the connection is accepted after all the data arrived, so the first read stops at the budget.
+    std::promise<void> dataSent;
+    if (resetCase == ResetCase::READING) {
+        loop->queueToLoop([dataSentFuture(dataSent.get_future())]() { dataSentFuture.wait(); });
+    }
+    int fd = connectTo(port);
+    if (resetCase == ResetCase::READING) {
+        if (fd >= 0) {
+            std::string data(DATA_SIZE, 'r');
+            (void)::write(fd, data.data(), data.size());
+        }
+        dataSent.set_value();
+    }
+    if (fd < 0) {
+        ::printf("connect to port %u failed.\n", port);
+        loop->schedule([&server]() { server.reset(); }).wait();
+        return false;
+    }
+    serverReady.get_future().wait();
+    resetSocket(fd);
+    peerReset.set_value();
+
+    bool closed = serverClosed.get_future().wait_for(CLOSE_TIMEOUT) == std::future_status::ready;
+    loop->schedule([&server]() { server.reset(); }).wait();
+    ::printf("Reset while %s: %s\n", caseName, closed ? "closed" : "NOT closed");
+    return closed;
+}
+
+int main()
+{
+    // a write to a reset connection raises SIGPIPE.
+    (void)::signal(SIGPIPE, SIG_IGN);
+
+    bool ok = true;
+    uint16_t port = PORT_BASE;
+    for (auto resetCase : {ResetCase::READING, ResetCase::SENDING}) {
+        ok = testReset(resetCase, port++) && ok;
+    }
+    return ok ? 0 : 1;
+}